@@ -0,0 +1,161 @@
+//	Copyright (c) 2011-2022 by Artem A. Gevorkyan (gevorkyan.org)
+//
+//	Permission is hereby granted, free of charge, to any person obtaining a copy
+//	of this software and associated documentation files (the "Software"), to deal
+//	in the Software without restriction, including without limitation the rights
+//	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//	copies of the Software, and to permit persons to whom the Software is
+//	furnished to do so, subject to the following conditions:
+//
+//	The above copyright notice and this permission notice shall be included in
+//	all copies or substantial portions of the Software.
+//
+//	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+//	THE SOFTWARE.
+
+
+#include "benchmark.h"
+
+#include <agge.text/text_engine.h>
+#include <memory>
+#include <string>
+#include <vector>
+#include <wpl/controls/header_basic.h>
+#include <wpl/controls/listview_basic.h>
+#include <wpl/freetype2/font_loader.h>
+#include <wpl/offscreen/view_host.h>
+#include <wpl/stylesheet_db.h>
+
+using namespace agge;
+using namespace std;
+
+namespace wpl
+{
+	namespace benchmarks
+	{
+		namespace
+		{
+			void append(richtext_t &text, const string &value)
+			{	text.append(value.begin(), value.end());	}
+
+			class columns : public headers_model
+			{
+			public:
+				columns(index_type count)
+					: _widths(count, 120)
+				{	}
+
+			private:
+				virtual index_type get_count() const throw() override
+				{	return static_cast<index_type>(_widths.size());	}
+
+				virtual void get_value(index_type index, short int &width) const override
+				{	width = _widths[index];	}
+
+				virtual void set_width(index_type index, short int width) override
+				{	_widths[index] = width;	}
+
+				virtual void get_caption(index_type index, richtext_t &caption) const override
+				{
+					caption.clear();
+					append(caption, "Column #" + to_string(static_cast<long long>(index)) + "\n(inclusive)");
+				}
+
+			private:
+				vector<short> _widths;
+			};
+
+			class table : public richtext_table_model
+			{
+			public:
+				table(index_type count)
+					: _count(count)
+				{	}
+
+			private:
+				virtual index_type get_count() const throw() override
+				{	return _count;	}
+
+				virtual void get_text(index_type row, index_type column, richtext_t &text) const override
+				{	append(text, to_string(static_cast<long long>(row * 17 + column)) + " ms");	}
+
+			private:
+				index_type _count;
+			};
+
+			shared_ptr<stylesheet> create_stylesheet(gcontext::text_engine_type &text_engine)
+			{
+				const auto ss = make_shared<stylesheet_db>();
+
+				ss->set_font("text", text_engine.create_font(font_descriptor::create("Arial", 14, regular, false,
+					hint_vertical)));
+				ss->set_font("text.header", text_engine.create_font(font_descriptor::create("Arial", 15, semi_bold, false,
+					hint_vertical)));
+				ss->set_color("background", color::make(16, 16, 16));
+				ss->set_color("background.listview.odd", color::make(48, 48, 48));
+				ss->set_color("text", color::make(192, 192, 192));
+				ss->set_color("separator", color::make(42, 43, 44));
+				ss->set_value("padding", 3);
+				ss->set_value("separator", 1);
+				return ss;
+			}
+
+			void listview_drawing(const form_context &context, const stylesheet &ss)
+			{
+				const auto rows = 1000000u;
+				const auto lv = make_shared<controls::listview_basic>();
+				offscreen::view_host host(context, 800, 600);
+				const auto vmodel = lv->get_vscroll_model();
+				auto first = 0.0;
+
+				lv->apply_styles(ss);
+				lv->set_columns_model(make_shared<columns>(6));
+				lv->set_model(make_shared<table>(rows));
+				host.set_root(lv);
+				host.render();
+
+				const auto page = vmodel->get_window().second;
+
+				report("controls", "listview_basic render, 1M rows, jump", measure([&] {
+					first = first + 9973 > rows - page ? 0 : first + 9973;
+					vmodel->set_window(first, page);
+					host.render();
+				}, 100));
+				report("controls", "listview_basic render, 1M rows, scroll by row", measure([&] {
+					first = first + 1 > rows - page ? 0 : first + 1;
+					vmodel->set_window(first, page);
+					host.render();
+				}, 100));
+			}
+
+			void header_measurement(const shared_ptr<gcontext::text_engine_type> &text_engine, const stylesheet &ss)
+			{
+				const auto header = make_shared<controls::header_basic>(text_engine, nullptr);
+
+				header->apply_styles(ss);
+				header->set_model(make_shared<columns>(20));
+				report("controls", "header_basic min_height, 20 columns", measure([&] {
+					header->min_height(1000);
+				}, 1000));
+			}
+		}
+
+		void controls_benchmarks()
+		{
+			form_context context;
+
+			context.renderer = make_shared<gcontext::renderer_type>(1);
+			context.text_engine = create_text_engine();
+
+			const auto ss = create_stylesheet(*context.text_engine);
+
+			listview_drawing(context, *ss);
+			header_measurement(context.text_engine, *ss);
+		}
+	}
+}
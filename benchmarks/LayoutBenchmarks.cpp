@@ -0,0 +1,124 @@
+//	Copyright (c) 2011-2022 by Artem A. Gevorkyan (gevorkyan.org)
+//
+//	Permission is hereby granted, free of charge, to any person obtaining a copy
+//	of this software and associated documentation files (the "Software"), to deal
+//	in the Software without restriction, including without limitation the rights
+//	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//	copies of the Software, and to permit persons to whom the Software is
+//	furnished to do so, subject to the following conditions:
+//
+//	The above copyright notice and this permission notice shall be included in
+//	all copies or substantial portions of the Software.
+//
+//	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+//	THE SOFTWARE.
+
+
+#include "benchmark.h"
+
+#include <memory>
+#include <vector>
+#include <wpl/layout.h>
+#include <wpl/view.h>
+
+using namespace agge;
+using namespace std;
+
+namespace wpl
+{
+	namespace benchmarks
+	{
+		namespace
+		{
+			class leaf : public control
+			{
+			public:
+				leaf(shared_ptr<view> view_, int height)
+					: _view(view_), _height(height)
+				{	}
+
+				virtual void layout(const placed_view_appender &append_view, const box<int> &box_) override
+				{
+					const placed_view pv = {	_view, nullptr, {	0, 0, box_.w, box_.h	}, 0, false	};
+
+					append_view(pv);
+				}
+
+				virtual int min_height(int /*for_width*/) const override
+				{	return _height;	}
+
+				virtual int min_width(int /*for_height*/) const override
+				{	return 10;	}
+
+			private:
+				shared_ptr<view> _view;
+				int _height;
+			};
+
+			shared_ptr<control> create_deep_stack(const shared_ptr<view> &view_, unsigned depth)
+			{
+				shared_ptr<control> inner = make_shared<leaf>(view_, 10);
+
+				for (auto i = 0u; i != depth; ++i)
+				{
+					const auto s = make_shared<stack>(!!(i & 1), nullptr);
+
+					s->add(make_shared<leaf>(view_, 10), pixels(10));
+					s->add(inner, percents(100));
+					inner = s;
+				}
+				return inner;
+			}
+
+			shared_ptr<control> create_wide_stack(const shared_ptr<view> &view_, unsigned width)
+			{
+				const auto s = make_shared<stack>(false, nullptr);
+
+				for (auto i = 0u; i != width; ++i)
+					s->add(make_shared<leaf>(view_, 10), i & 1 ? pixels(10) : percents(1));
+				return s;
+			}
+
+			shared_ptr<control> create_wide_staggered(const shared_ptr<view> &view_, unsigned width)
+			{
+				const auto s = make_shared<staggered>();
+
+				s->set_base_width(pixels(120));
+				for (auto i = 0u; i != width; ++i)
+					s->add(make_shared<leaf>(view_, 20 + 10 * (i % 7)));
+				return s;
+			}
+
+			void layout(const char *name, control &root, unsigned iterations)
+			{
+				vector<placed_view> views;
+				const auto box_ = create_box(1920, 1080);
+				const placed_view_appender append = [&views] (const placed_view &pv) {	views.push_back(pv);	};
+
+				report("layout", name, measure([&] {
+					views.clear();
+					root.layout(append, box_);
+				}, iterations));
+			}
+		}
+
+		void layout_benchmarks()
+		{
+			const auto v = make_shared<view>();
+			const auto deep = create_deep_stack(v, 20);
+			const auto wide = create_wide_stack(v, 1000);
+			const auto wide_staggered = create_wide_staggered(v, 1000);
+
+			layout("stack, 20 levels deep", *deep, 100);
+			layout("stack, 1000 children", *wide, 1000);
+			layout("staggered, 1000 children", *wide_staggered, 1000);
+			report("layout", "min_height, stack 20 levels deep", measure([&] {	deep->min_height(1920);	}, 100));
+			report("layout", "min_width, stack 1000 children", measure([&] {	wide->min_width(1080);	}, 1000));
+		}
+	}
+}
@@ -0,0 +1,88 @@
+//	Copyright (c) 2011-2022 by Artem A. Gevorkyan (gevorkyan.org)
+//
+//	Permission is hereby granted, free of charge, to any person obtaining a copy
+//	of this software and associated documentation files (the "Software"), to deal
+//	in the Software without restriction, including without limitation the rights
+//	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//	copies of the Software, and to permit persons to whom the Software is
+//	furnished to do so, subject to the following conditions:
+//
+//	The above copyright notice and this permission notice shall be included in
+//	all copies or substantial portions of the Software.
+//
+//	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+//	THE SOFTWARE.
+
+
+#include "benchmark.h"
+
+#include <memory>
+#include <vector>
+#include <wpl/mouse_router.h>
+#include <wpl/view.h>
+
+using namespace agge;
+using namespace std;
+
+namespace wpl
+{
+	namespace benchmarks
+	{
+		namespace
+		{
+			struct router_host : mouse_router_host
+			{
+				virtual void request_focus(shared_ptr<keyboard_input> /*input*/) override
+				{	}
+
+				virtual shared_ptr<void> capture_mouse() override
+				{	return make_shared<bool>();	}
+			};
+
+			vector<placed_view> create_grid(int columns, int rows, int cell)
+			{
+				vector<placed_view> views;
+
+				for (auto y = 0; y != rows; ++y)
+				{
+					for (auto x = 0; x != columns; ++x)
+					{
+						const placed_view pv = {
+							make_shared<view>(), nullptr, {	x * cell, y * cell, (x + 1) * cell, (y + 1) * cell	}, 0, false
+						};
+
+						views.push_back(pv);
+					}
+				}
+				return views;
+			}
+
+			void hit_testing(const char *name, int columns, int rows)
+			{
+				const auto cell = 10;
+				router_host host;
+				const auto views = create_grid(columns, rows, cell);
+				mouse_router router(views, host);
+				auto x = 0, y = 0;
+
+				router.reload_views();
+				report("mouse_router", name, measure([&] {
+					x = (x + 7) % (columns * cell), y = (y + 3) % (rows * cell);
+					router.mouse_move(0, create_point(x, y));
+				}, 100000));
+			}
+		}
+
+		void mouse_router_benchmarks()
+		{
+			hit_testing("mouse_move, 10x10 views", 10, 10);
+			hit_testing("mouse_move, 100x100 views", 100, 100);
+			hit_testing("mouse_move, 300x300 views", 300, 300);
+		}
+	}
+}
@@ -0,0 +1,167 @@
+//	Copyright (c) 2011-2022 by Artem A. Gevorkyan (gevorkyan.org)
+//
+//	Permission is hereby granted, free of charge, to any person obtaining a copy
+//	of this software and associated documentation files (the "Software"), to deal
+//	in the Software without restriction, including without limitation the rights
+//	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//	copies of the Software, and to permit persons to whom the Software is
+//	furnished to do so, subject to the following conditions:
+//
+//	The above copyright notice and this permission notice shall be included in
+//	all copies or substantial portions of the Software.
+//
+//	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+//	THE SOFTWARE.
+
+#include "benchmark.h"
+
+#include <functional>
+#include <list>
+#include <memory>
+#include <vector>
+#include <wpl/signal.h>
+
+using namespace std;
+
+namespace wpl
+{
+	namespace benchmarks
+	{
+		namespace
+		{
+			// The former list-based signal implementation, kept as a reference point.
+			namespace legacy
+			{
+				template <typename T1>
+				class signal
+				{
+				public:
+					signal()
+						: _function_list(make_shared<function_list>())
+					{	}
+
+					slot_connection operator +=(const function<void (T1)> &slot)
+					{
+						const auto l = _function_list;
+						const auto i = l->functions.insert(l->functions.end(), slot);
+
+						return slot_connection(&*i, [l, i] (void *) {
+							if (l->traversing)
+								*i = function<void (T1)>(), l->require_cleanup = true;
+							else
+								l->functions.erase(i);
+						});
+					}
+
+					void operator ()(T1 arg1) const
+					{
+						const auto l = _function_list;
+
+						l->traversing++;
+						for (auto i = l->functions.begin(); i != l->functions.end(); ++i)
+						{
+							if (*i)
+								(*i)(arg1);
+						}
+						if (!--l->traversing && l->require_cleanup)
+						{
+							l->functions.remove_if([] (const function<void (T1)> &f) {	return !f;	});
+							l->require_cleanup = false;
+						}
+					}
+
+				private:
+					struct function_list
+					{
+						function_list()
+							: traversing(0), require_cleanup(false)
+						{	}
+
+						list< function<void (T1)> > functions;
+						unsigned traversing;
+						bool require_cleanup;
+					};
+
+				private:
+					shared_ptr<function_list> _function_list;
+				};
+			}
+
+			struct receiver
+			{
+				void on_invalidate(size_t row)
+				{	total += row;	}
+
+				size_t total;
+			};
+
+			template <typename SignalT>
+			void emission(const char *name, unsigned slots)
+			{
+				SignalT s;
+				vector<receiver> receivers(slots);
+				vector<slot_connection> connections;
+				size_t row = 0;
+
+				for (auto i = receivers.begin(); i != receivers.end(); ++i)
+				{
+					auto r = &*i;
+
+					r->total = 0;
+					connections.push_back(s += [r] (size_t row_) {	r->on_invalidate(row_);	});
+				}
+				report("signal", name, measure([&] {	s(row++);	}, 1000000u / slots));
+			}
+
+			template <typename SignalT>
+			void connect_disconnect(const char *name, unsigned resident_slots)
+			{
+				SignalT s;
+				receiver r = {	0	};
+				vector<slot_connection> connections;
+
+				for (auto i = 0u; i != resident_slots; ++i)
+					connections.push_back(s += [&r] (size_t row) {	r.on_invalidate(row);	});
+				report("signal", name, measure([&] {
+					slot_connection c = s += [&r] (size_t row) {	r.on_invalidate(row);	};
+				}, 1000000u));
+			}
+
+			template <typename SignalT>
+			void bulk_disconnect(const char *name, unsigned slots)
+			{
+				SignalT s;
+				receiver r = {	0	};
+				vector<slot_connection> connections;
+
+				report("signal", name, measure([&] {
+					for (auto i = 0u; i != slots; ++i)
+						connections.push_back(s += [&r] (size_t row) {	r.on_invalidate(row);	});
+					connections.clear();
+				}, 1000000u / slots) / slots);
+			}
+		}
+
+		void signal_benchmarks()
+		{
+			typedef wpl::signal<void (size_t)> contiguous_signal;
+			typedef legacy::signal<size_t> list_signal;
+
+			emission<list_signal>("emit, 1 slot (list)", 1);
+			emission<contiguous_signal>("emit, 1 slot (contiguous)", 1);
+			emission<list_signal>("emit, 8 slots (list)", 8);
+			emission<contiguous_signal>("emit, 8 slots (contiguous)", 8);
+			emission<list_signal>("emit, 64 slots (list)", 64);
+			emission<contiguous_signal>("emit, 64 slots (contiguous)", 64);
+			connect_disconnect<list_signal>("connect/disconnect (list)", 8);
+			connect_disconnect<contiguous_signal>("connect/disconnect (contiguous)", 8);
+			bulk_disconnect<list_signal>("connect 64, disconnect all (list)", 64);
+			bulk_disconnect<contiguous_signal>("connect 64, disconnect all (contiguous)", 64);
+		}
+	}
+}
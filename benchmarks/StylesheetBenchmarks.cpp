@@ -18,69 +18,47 @@
 //	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
 //	THE SOFTWARE.
 
-#include <wpl/freetype2/font_loader.h>
 
-#include <dirent.h>
-#include <stdio.h>
-#include <regex>
+#include "benchmark.h"
 
+#include <string>
+#include <wpl/stylesheet_db.h>
+
+using namespace agge;
 using namespace std;
 
 namespace wpl
 {
-	namespace
-	{
-		const auto c_default_font_directory = "/System/Library/Fonts";
-		const regex c_font_match(".+\\.(ttf|otf|ttc)", regex::icase);
-
-		string append_path(string lhs, const string &rhs)
-		{
-			if (!lhs.empty() && lhs.back() != '/')
-				lhs += '/';
-			lhs += rhs;
-			return lhs;
-		}
-	}
-
-	class directory_enumerator : noncopyable
+	namespace benchmarks
 	{
-	public:
-		directory_enumerator(const string &directory)
-			: _directory(directory)
-		{
-			const auto dir = ::opendir(directory.c_str());
-			
-			if (!dir)
-				throw runtime_error("Cannot open system fonts directory!");
-			_handle.reset(dir, &::closedir);
-		}
-
-		bool operator ()(string &path)
+		namespace
 		{
-			if (const auto entry = readdir(_handle.get()))
+			void lookup(const char *name, const stylesheet &ss, const char *id)
 			{
-				path = append_path(_directory, entry->d_name);
-				return true;
+				auto total = 0u;
+
+				report("stylesheet", name, measure([&] {	total += ss.get_color(id).r;	}, 1000000));
 			}
-			return false;
 		}
 
-	private:
-		const string _directory;
-		shared_ptr<DIR> _handle;
-	};
+		void stylesheet_benchmarks()
+		{
+			stylesheet_db ss;
+			const stylesheet &base = ss;
 
-	font_loader::enum_font_files_cb font_loader::create_fonts_enumerator()
-	{
-		auto e = make_shared<directory_enumerator>(c_default_font_directory);
+			ss.set_color("background", color::make(16, 16, 16));
+			ss.set_color("background.listview.odd", color::make(48, 48, 48));
+			ss.set_color("text", color::make(192, 192, 192));
+			ss.set_value("padding", 3);
+			for (auto i = 0; i != 200; ++i)
+				ss.set_color(("filler." + to_string(static_cast<long long>(i))).c_str(), color::make(0, 0, 0));
 
-		return [e] (string &path) -> bool {
-			while ((*e)(path))
-			{
-				if (regex_match(path, c_font_match))
-					return true;
-			}
-			return false;
-		};
+			lookup("get_color, exact", base, "background.listview.odd");
+			lookup("get_color, one level fallback", base, "background.listview");
+			lookup("get_color, two levels fallback", base, "background.listview.even");
+			report("stylesheet", "get_value, two levels fallback", measure([&] {
+				base.get_value("padding.header.sorted");
+			}, 1000000));
+		}
 	}
 }
@@ -0,0 +1,72 @@
+//	Copyright (c) 2011-2022 by Artem A. Gevorkyan (gevorkyan.org)
+//
+//	Permission is hereby granted, free of charge, to any person obtaining a copy
+//	of this software and associated documentation files (the "Software"), to deal
+//	in the Software without restriction, including without limitation the rights
+//	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//	copies of the Software, and to permit persons to whom the Software is
+//	furnished to do so, subject to the following conditions:
+//
+//	The above copyright notice and this permission notice shall be included in
+//	all copies or substantial portions of the Software.
+//
+//	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+//	THE SOFTWARE.
+
+
+#include "benchmark.h"
+
+#include <wpl/freetype2/font_loader.h>
+
+using namespace agge;
+using namespace std;
+
+namespace wpl
+{
+	namespace benchmarks
+	{
+		namespace
+		{
+			const auto c_index_cache_path = "wpl.benchmarks.font-index";
+		}
+
+		void text_benchmarks()
+		{
+			// A face absent from any system forces load() to wait for the complete index before falling back.
+			const auto missing = font_descriptor::create("wpl.benchmarks.missing", 14, regular, false, hint_vertical);
+
+			report("text", "font_loader load, complete index, cold", measure([&] {
+				remove(c_index_cache_path);
+				font_loader(c_index_cache_path).load(missing);
+			}, 1, 3));
+			report("text", "font_loader load, complete index, warm", measure([&] {
+				font_loader(c_index_cache_path).load(missing);
+			}, 1, 3));
+
+			font_loader loader(c_index_cache_path);
+			const auto accessor = loader.load(font_descriptor::create("Arial", 14, regular, false, hint_vertical));
+
+			remove(c_index_cache_path);
+			if (!accessor)
+			{
+				fprintf(stderr, "text: no fonts found, glyph loading is not measured\n");
+				return;
+			}
+
+			codepoint_t c = 0;
+			glyph::glyph_metrics m;
+
+			report("text", "get_glyph_index", measure([&] {
+				accessor->get_glyph_index(L'!' + c++ % 94);
+			}, 100000));
+			report("text", "load_glyph, ASCII", measure([&] {
+				accessor->load_glyph(accessor->get_glyph_index(L'!' + c++ % 94), m);
+			}, 10000));
+		}
+	}
+}
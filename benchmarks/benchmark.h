@@ -0,0 +1,116 @@
+//	Copyright (c) 2011-2022 by Artem A. Gevorkyan (gevorkyan.org)
+//
+//	Permission is hereby granted, free of charge, to any person obtaining a copy
+//	of this software and associated documentation files (the "Software"), to deal
+//	in the Software without restriction, including without limitation the rights
+//	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//	copies of the Software, and to permit persons to whom the Software is
+//	furnished to do so, subject to the following conditions:
+//
+//	The above copyright notice and this permission notice shall be included in
+//	all copies or substantial portions of the Software.
+//
+//	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+//	THE SOFTWARE.
+
+#pragma once
+
+#include <chrono>
+#include <stdio.h>
+#include <string>
+#include <vector>
+
+namespace wpl
+{
+	namespace benchmarks
+	{
+		class stopwatch
+		{
+		public:
+			stopwatch();
+
+			double operator ()(); // Returns seconds elapsed since the previous call or construction.
+
+		private:
+			typedef std::chrono::high_resolution_clock clock_type;
+
+		private:
+			clock_type::time_point _previous;
+		};
+
+
+		// Runs 'operation' 'iterations' times per sample and returns the best average duration (in nanoseconds)
+		// among the samples taken.
+		template <typename OperationT>
+		double measure(OperationT operation, unsigned iterations, unsigned samples = 5);
+
+		struct result
+		{
+			std::string suite, name;
+			double ns_per_operation;
+		};
+
+		std::vector<result> &get_results();
+		void report(const char *suite, const char *name, double ns_per_operation);
+
+		void controls_benchmarks();
+		void layout_benchmarks();
+		void mouse_router_benchmarks();
+		void signal_benchmarks();
+		void stylesheet_benchmarks();
+		void text_benchmarks();
+
+
+
+		inline stopwatch::stopwatch()
+			: _previous(clock_type::now())
+		{	}
+
+		inline double stopwatch::operator ()()
+		{
+			const auto previous = _previous;
+
+			_previous = clock_type::now();
+			return std::chrono::duration<double>(_previous - previous).count();
+		}
+
+
+		template <typename OperationT>
+		inline double measure(OperationT operation, unsigned iterations, unsigned samples)
+		{
+			auto best = 0.0;
+
+			for (auto s = 0u; s != samples; ++s)
+			{
+				stopwatch sw;
+
+				for (auto i = 0u; i != iterations; ++i)
+					operation();
+
+				const auto elapsed = sw() * 1e9 / iterations;
+
+				best = s && best < elapsed ? best : elapsed;
+			}
+			return best;
+		}
+
+		inline std::vector<result> &get_results()
+		{
+			static std::vector<result> results;
+			return results;
+		}
+
+		inline void report(const char *suite, const char *name, double ns_per_operation)
+		{
+			const result r = {	suite, name, ns_per_operation	};
+
+			get_results().push_back(r);
+			fprintf(stderr, "%-20s %-48s %12.2f ns\n", suite, name, ns_per_operation);
+		}
+	}
+}
@@ -0,0 +1,92 @@
+//	Copyright (c) 2011-2022 by Artem A. Gevorkyan (gevorkyan.org)
+//
+//	Permission is hereby granted, free of charge, to any person obtaining a copy
+//	of this software and associated documentation files (the "Software"), to deal
+//	in the Software without restriction, including without limitation the rights
+//	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//	copies of the Software, and to permit persons to whom the Software is
+//	furnished to do so, subject to the following conditions:
+//
+//	The above copyright notice and this permission notice shall be included in
+//	all copies or substantial portions of the Software.
+//
+//	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+//	THE SOFTWARE.
+
+#include "benchmark.h"
+
+#include <string.h>
+
+namespace
+{
+	typedef void (*suite_fn)();
+
+	const struct
+	{
+		const char *name;
+		suite_fn run;
+	} c_suites[] = {
+		{	"controls", &wpl::benchmarks::controls_benchmarks	},
+		{	"layout", &wpl::benchmarks::layout_benchmarks	},
+		{	"mouse_router", &wpl::benchmarks::mouse_router_benchmarks	},
+		{	"signal", &wpl::benchmarks::signal_benchmarks	},
+		{	"stylesheet", &wpl::benchmarks::stylesheet_benchmarks	},
+		{	"text", &wpl::benchmarks::text_benchmarks	},
+	};
+
+	bool selected(const char *suite, int argc, char *argv[])
+	{
+		if (argc < 2)
+			return true;
+		for (auto i = 1; i < argc; ++i)
+		{
+			if (!strcmp(suite, argv[i]))
+				return true;
+		}
+		return false;
+	}
+
+	void print_json_string(const std::string &value)
+	{
+		putchar('"');
+		for (auto i = value.begin(); i != value.end(); ++i)
+		{
+			if ('"' == *i || '\\' == *i)
+				putchar('\\');
+			putchar(*i);
+		}
+		putchar('"');
+	}
+}
+
+// Runs the suites named in the command line (all, if none is named). Progress is printed to stderr, while stdout
+// receives the results as a JSON array, for comparison between builds.
+int main(int argc, char *argv[])
+{
+	using namespace wpl::benchmarks;
+
+	for (auto i = 0u; i != sizeof(c_suites) / sizeof(c_suites[0]); ++i)
+	{
+		if (selected(c_suites[i].name, argc, argv))
+			c_suites[i].run();
+	}
+
+	const auto &results = get_results();
+
+	printf("[\n");
+	for (auto i = results.begin(); i != results.end(); ++i)
+	{
+		printf("\t{\"suite\": ");
+		print_json_string(i->suite);
+		printf(", \"name\": ");
+		print_json_string(i->name);
+		printf(", \"ns_per_operation\": %.2f}%s\n", i->ns_per_operation, i + 1 != results.end() ? "," : "");
+	}
+	printf("]\n");
+	return 0;
+}
@@ -22,9 +22,7 @@
 
 #include <agge/blenders.h>
 #include <agge/blenders_simd.h>
-#include <agge/figures.h>
-#include <agge/filling_rules.h>
-#include <agge/path.h>
+#include <wpl/helpers.h>
 #include <wpl/stylesheet.h>
 
 using namespace agge;
@@ -38,9 +36,13 @@ namespace wpl
 			typedef blender_solid_color<simd::blender_solid_color, platform_pixel_order> blender;
 		}
 
+		solid_background::solid_background()
+		{	concurrent_draw = true;	}
+
 		void solid_background::apply_styles(const stylesheet &stylesheet_)
 		{
 			_color = stylesheet_.get_color("background");
+			cached = _color.a == 0xFF; // Layers are copied, so only an opaque background can be retained.
 			invalidate(nullptr);
 		}
 
@@ -48,9 +50,8 @@ namespace wpl
 		{
 			const auto r = context.update_area();
 
-			add_path(*rasterizer_, rectangle(static_cast<real_t>(r.x1), static_cast<real_t>(r.y1),
-				static_cast<real_t>(r.x2), static_cast<real_t>(r.y2)));
-			context(rasterizer_, blender(_color), winding<>());
+			context.fill(rasterizer_, create_rect(static_cast<real_t>(r.x1), static_cast<real_t>(r.y1),
+				static_cast<real_t>(r.x2), static_cast<real_t>(r.y2)), blender(_color));
 		}
 	}
 }
@@ -0,0 +1,143 @@
+//	Copyright (c) 2011-2022 by Artem A. Gevorkyan (gevorkyan.org)
+//
+//	Permission is hereby granted, free of charge, to any person obtaining a copy
+//	of this software and associated documentation files (the "Software"), to deal
+//	in the Software without restriction, including without limitation the rights
+//	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//	copies of the Software, and to permit persons to whom the Software is
+//	furnished to do so, subject to the following conditions:
+//
+//	The above copyright notice and this permission notice shall be included in
+//	all copies or substantial portions of the Software.
+//
+//	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+//	THE SOFTWARE.
+
+
+#include <wpl/controls/cell_text_cache.h>
+
+#include <cmath>
+#include <functional>
+#include <wpl/helpers.h>
+
+using namespace agge;
+using namespace std;
+
+namespace wpl
+{
+	namespace controls
+	{
+		namespace
+		{
+			rect_r localize(const rect_r &box)
+			{
+				const auto o = cell_text_cache::origin(box);
+
+				return create_rect(box.x1 - o.dx, box.y1 - o.dy, box.x2 - o.dx, box.y2 - o.dy);
+			}
+		}
+
+		cell_text_cache::cell_text_cache(size_t capacity)
+			: _capacity(capacity)
+		{	}
+
+		const cell_text_cache::run *cell_text_cache::find(row_index_type row, column_index_type column,
+			const rect_r &box)
+		{
+			const auto i = _index.find(make_pair(row, column));
+
+			if (i == _index.end())
+				return nullptr;
+
+			const auto l = localize(box);
+			const auto &b = i->second->value.box;
+
+			if (b.x1 != l.x1 || b.y1 != l.y1 || b.x2 != l.x2 || b.y2 != l.y2)
+				return nullptr;
+			_entries.splice(_entries.begin(), _entries, i->second);
+			return &i->second->value;
+		}
+
+		cell_text_cache::run &cell_text_cache::acquire(row_index_type row, column_index_type column,
+			const rect_r &box)
+		{
+			const auto k = make_pair(row, column);
+			auto i = _index.find(k);
+
+			if (i != _index.end())
+			{
+				_entries.splice(_entries.begin(), _entries, i->second);
+			}
+			else
+			{
+				if (_entries.size() >= _capacity && !_entries.empty())
+				{
+					// The evicted run is reused - that spares the rasterizer reallocation.
+					_index.erase(_entries.back().key);
+					_entries.splice(_entries.begin(), _entries, --_entries.end());
+				}
+				else
+				{
+					entry e = {	k, {	gcontext::rasterizer_ptr(new gcontext::rasterizer_type), color(), rect_r()	}	};
+
+					_entries.push_front(move(e));
+				}
+				_entries.front().key = k;
+				i = _index.insert(make_pair(k, _entries.begin())).first;
+			}
+
+			auto &r = i->second->value;
+
+			r.raster->reset();
+			r.box = localize(box);
+			return r;
+		}
+
+		void cell_text_cache::invalidate(row_index_type first, row_index_type count) throw()
+		{
+			for (auto i = _entries.begin(); i != _entries.end(); )
+			{
+				if (i->key.first - first < count)
+				{
+					_index.erase(i->key);
+					i = _entries.erase(i);
+				}
+				else
+				{
+					++i;
+				}
+			}
+		}
+
+		void cell_text_cache::clear() throw()
+		{
+			_index.clear();
+			_entries.clear();
+		}
+
+		void cell_text_cache::set_capacity(size_t capacity) throw()
+		{
+			for (_capacity = capacity; _entries.size() > _capacity; _entries.pop_back())
+				_index.erase(_entries.back().key);
+		}
+
+		vector_i cell_text_cache::origin(const rect_r &box) throw()
+		{
+			const vector_i o = {	static_cast<int>(floor(box.x1)), static_cast<int>(floor(box.y1))	};
+
+			return o;
+		}
+
+		size_t cell_text_cache::key_hash::operator ()(const key_type &key) const throw()
+		{
+			const auto column = static_cast<unsigned short>(key.second);
+
+			return hash<row_index_type>()(key.first) * 31u + column;
+		}
+	}
+}
@@ -57,6 +57,7 @@ namespace wpl
 			const font_style_annotation base_style = {	ss.get_font("text.header")->get_key(),	};
 
 			_bg = ss.get_color("background.header");
+			cached = _bg.a == 0xFF; // Layers are copied, so only an opaque header can be retained.
 			_bg_sorted = ss.get_color("background.header.sorted");
 			_fg_normal = ss.get_color("text.header");
 			_fg_sorted = ss.get_color("text.header.sorted");
@@ -85,16 +86,14 @@ namespace wpl
 			if (_bg.a)
 			{
 				const auto ua = ctx.update_area();
-				add_path(*ras, rectangle(static_cast<real_t>(ua.x1), static_cast<real_t>(ua.y1),
-					static_cast<real_t>(ua.x2), static_cast<real_t>(ua.y2)));
-				ctx(ras, blender(_bg), winding<>());
+				ctx.fill(ras, create_rect(static_cast<real_t>(ua.x1), static_cast<real_t>(ua.y1),
+					static_cast<real_t>(ua.x2), static_cast<real_t>(ua.y2)), blender(_bg));
 			}
 
 			header_core::draw(ctx, ras);
 			const auto &size = get_last_size();
 
-			add_path(*ras, rectangle(0.0f, size.h - _separator_width, size.w, size.h));
-			ctx(ras, blender(_fg_separator), winding<>());
+			ctx.fill(ras, create_rect(0.0f, size.h - _separator_width, size.w, size.h), blender(_fg_separator));
 		}
 
 		box<int> header_basic::measure_item(const headers_model &model, index_type item) const
@@ -120,10 +119,7 @@ namespace wpl
 			auto box = b;
 
 			if ((state & sorted) && _bg_sorted.a)
-			{
-				add_path(*ras, rectangle(b.x1, b.y1, b.x2, b.y2));
-				ctx(ras, blender(_bg_sorted), winding<>());
-			}
+				ctx.fill(ras, b, blender(_bg_sorted));
 
 			box.x2 -= _separator_width;
 			box.y2 -= _separator_width;
@@ -148,8 +144,7 @@ namespace wpl
 			ctx(ras, blender(state & sorted ? _fg_sorted : _fg_normal), winding<>());
 
 			// 3. Draw right separator.
-			add_path(*ras, rectangle(b.x2 - _separator_width, box.y1, b.x2, box.y2));
-			ctx(ras, blender(_fg_separator), winding<>());
+			ctx.fill(ras, create_rect(b.x2 - _separator_width, box.y1, b.x2, box.y2), blender(_fg_separator));
 		}
 	}
 }
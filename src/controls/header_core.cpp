@@ -32,8 +32,12 @@ namespace wpl
 	namespace controls
 	{
 		header_core::header_core(shared_ptr<cursor_manager> cursor_manager_)
-			: _cursor_manager(cursor_manager_), _offset(0.0f), _ignore_invalidations(false)
-		{	}
+			: _cursor_manager(cursor_manager_), _offset(0.0f), _min_height(-1), _ignore_invalidations(false)
+		{
+			_layout_invalidation = layout_changed += [this] (bool /*hierarchy_changed*/) {
+				_min_height = -1;
+			};
+		}
 
 		header_core::~header_core()
 		{	}
@@ -61,11 +65,9 @@ namespace wpl
 
 		int header_core::min_height(int /*for_width*/) const
 		{
-			int h = 0;
-
-			for (index_type i = 0, n = _model ? _model->get_count() : 0; i != n; ++i)
-				h = (max)(h, measure_item(*_model, i).h);
-			return h;
+			if (_min_height < 0)
+				_min_height = measure_min_height();
+			return _min_height;
 		}
 
 		void header_core::set_model(shared_ptr<headers_model> model)
@@ -75,6 +77,7 @@ namespace wpl
 				_model_invalidation = model->invalidate += [this] (index_type /*column*/) {
 					if (!_ignore_invalidations)	// Untestable - the guard is for iteration rather than recursion.
 						adjust_column_widths();
+					check_min_height();
 					invalidate(nullptr);
 				};
 				_model_sorting_change = model->sort_order_changed += [this] (index_type column, bool ascending) {
@@ -91,6 +94,7 @@ namespace wpl
 			_resize.cancel();
 			_model = model;
 			adjust_column_widths();
+			check_min_height();
 			invalidate(nullptr);
 		}
 
@@ -173,5 +177,21 @@ namespace wpl
 			}
 			return make_pair(index_type(), none_handle);
 		}
+
+		int header_core::measure_min_height() const
+		{
+			int h = 0;
+
+			for (index_type i = 0, n = _model ? _model->get_count() : 0; i != n; ++i)
+				h = (max)(h, measure_item(*_model, i).h);
+			return h;
+		}
+
+		void header_core::check_min_height()
+		{
+			// Only a measured height may be relied upon by someone - otherwise it will be measured anew when needed.
+			if (_min_height >= 0 && _min_height != measure_min_height())
+				layout_changed(false);
+		}
 	}
 }
@@ -42,7 +42,7 @@ namespace wpl
 	{
 		label::label(shared_ptr<gcontext::text_engine_type> text_services)
 			: _text_services(text_services), _text_buffer(c_base_annotation), _text(style_modifier::empty),
-				_halign(align_near), _valign(align_center)
+				_halign(align_near), _valign(align_center), _min_sizes(layout_changed)
 		{	}
 
 		void label::apply_styles(const stylesheet &stylesheet_)
@@ -57,12 +57,19 @@ namespace wpl
 
 		int label::min_height(int for_width) const
 		{
-			return static_cast<int>(_text_services->measure(_text_buffer, limit::wrap(static_cast<real_t>(for_width))).h
-				+ 1.0f);
+			return _min_sizes.height(for_width, [this, for_width] {
+				return static_cast<int>(_text_services->measure(_text_buffer,
+					limit::wrap(static_cast<real_t>(for_width))).h + 1.0f);
+			});
 		}
 
 		int label::min_width(int /*for_width*/) const
-		{	return static_cast<int>(_text_services->measure(_text_buffer, limit::none()).w + 1.0);	}
+		{
+			// The width does not depend on the height, so it is measured once for any constraint.
+			return _min_sizes.width(maximum_size, [this] {
+				return static_cast<int>(_text_services->measure(_text_buffer, limit::none()).w + 1.0);
+			});
+		}
 
 		void label::set_text(const richtext_modifier_t &text)
 		{
@@ -40,10 +40,12 @@ namespace wpl
 		namespace
 		{
 			typedef blender_solid_color<simd::blender_solid_color, platform_pixel_order> blender;
+
+			const size_t c_text_cache_slack = 2; // Screens of cells kept, so that scrolling back does not lay them out.
 		}
 
 		listview_basic::listview_basic()
-			: _text_buffer(agge::font_style_annotation())
+			: _text_buffer(agge::font_style_annotation()), _text_cache(0)
 		{	}
 
 		void listview_basic::apply_styles(const stylesheet &ss)
@@ -52,6 +54,7 @@ namespace wpl
 			font_style_annotation a = {	font_->get_key(), ss.get_color("text.listview"),	};
 
 			_text_buffer.set_base_annotation(a);
+			_text_cache.clear();
 
 			_bg = ss.get_color("background.listview");
 			_bg_even = ss.get_color("background.listview.even");
@@ -78,24 +81,41 @@ namespace wpl
 		void listview_basic::set_columns_model(shared_ptr<columns_model> model)
 		{
 			_columns_model = model;
+			_columns_invalidation = model ? model->invalidate += [this] (columns_model::index_type /*column*/) {
+				_text_cache.clear();
+			} : nullptr;
+			_text_cache.clear();
 			listview_core::set_columns_model(model);
 		}
 
 		void listview_basic::set_model(shared_ptr<richtext_table_model> model)
 		{
 			_model = model;
+			_text_invalidation = model ? model->invalidate += [this] (index_type row) {
+				if (npos() == row)
+					_text_cache.clear();
+				else
+					_text_cache.invalidate(row, 1);
+			} : nullptr;
+			_text_range_invalidation = model ? model->invalidate_range += [this] (index_type first, index_type count) {
+				_text_cache.invalidate(first, count);
+			} : nullptr;
+			_text_cache.clear();
 			listview_core::set_model(model);
 		}
 
 		void listview_basic::draw(gcontext &ctx, gcontext::rasterizer_ptr &ras) const
 		{
+			const auto rows = _item_height > 0.0f ? static_cast<size_t>(get_last_size().h / _item_height) + 2 : 0u;
+			const auto columns = _columns_model ? static_cast<size_t>(_columns_model->get_count()) : 0u;
+
+			_text_cache.set_capacity(c_text_cache_slack * rows * columns);
 			if (_bg.a)
 			{
 				const auto ua = ctx.update_area();
 
-				add_path(*ras, rectangle(static_cast<real_t>(ua.x1), static_cast<real_t>(ua.y1),
-					static_cast<real_t>(ua.x2), static_cast<real_t>(ua.y2)));
-				ctx(ras, blender(_bg), winding<>());
+				ctx.fill(ras, create_rect(static_cast<real_t>(ua.x1), static_cast<real_t>(ua.y1),
+					static_cast<real_t>(ua.x2), static_cast<real_t>(ua.y2)), blender(_bg));
 			}
 			listview_core::draw(ctx, ras);
 		}
@@ -111,10 +131,7 @@ namespace wpl
 				const auto bg = state & selected ? _bg_selected : (row & 1) ? _bg_odd : _bg_even;
 
 				if (bg.a)
-				{
-					add_path(*ras, rectangle(b_.x1, b_.y1, b_.x2, b_.y2));
-					ctx(ras, blender(bg), winding<>());
-				}
+					ctx.fill(ras, b_, blender(bg));
 			}
 			else if (1u == layer && (state & focused))
 			{
@@ -134,15 +151,28 @@ namespace wpl
 				rect_r b(b_);
 
 				inflate(b, -_padding, -_padding);
-				_text_buffer.clear();
-				_model->get_text(row, column, _text_buffer);
 
+				auto run = _text_cache.find(row, column, b);
+
+				if (!run)
+				{
+					auto &r = _text_cache.acquire(row, column, b);
+					auto a = _columns_model->get_alignment(column);
+
+					_text_buffer.clear();
+					_model->get_text(row, column, _text_buffer);
+					r.foreground = _text_buffer.current_annotation().foreground;
+					ctx.text_engine.render(*r.raster, _text_buffer, a.halign, a.valign, r.box,
+						agge::limit::ellipsis(width(b)));
+					run = &r;
+				}
+
+				const auto o = cell_text_cache::origin(b);
 				auto c = (state & focused) && (state & selected) ? _fg_focus_selected :
 					(state & focused) ? _fg_focus :
-					(state & selected) ? _fg_selected : _text_buffer.current_annotation().foreground;
-				auto a = _columns_model->get_alignment(column);
+					(state & selected) ? _fg_selected : run->foreground;
 
-				ctx.text_engine.render(*ras, _text_buffer, a.halign, a.valign, b, agge::limit::ellipsis(width(b)));
+				ras->append(*run->raster, o.dx, o.dy);
 				ras->sort(true);
 				ctx(ras, blender(c), winding<>());
 			}
@@ -23,6 +23,7 @@
 #include <agge/math.h>
 #include <algorithm>
 #include <cmath>
+#include <cstdlib>
 #include <numeric>
 #include <wpl/helpers.h>
 
@@ -53,8 +54,11 @@ namespace wpl
 			{
 				if (!owner)
 					return;
+
+				const auto previous_offset = owner->_offset;
+
 				set_window(window_min);
-				owner->invalidate_();
+				owner->scroll_(previous_offset);
 				invalidate(false);
 			}
 
@@ -131,6 +135,7 @@ namespace wpl
 				_state_vscrolling(false)
 		{
 			tab_stop = true;
+			invalidate.profile("listview_core.invalidate");
 			_offset.dx = 0, _offset.dy = 0;
 			_vsmodel->owner = this;
 			_hsmodel->owner = this;
@@ -343,16 +348,33 @@ namespace wpl
 				layout_changed(false);
 				precache_model();
 			};
-			const auto on_invalidate = [this, update_item_count] (index_type /*row*/) {
+			const auto on_invalidate = [this, update_item_count] (index_type row) {
+				const auto item_count = _item_count;
+
 				update_item_count();
 				if (_state_keep_focus_visible)
 					make_visible(get_focused());
-				invalidate_();
+				if (item_count != _item_count)
+					invalidate_();
+				else
+					invalidate_rows_(row, 1);
+			};
+			const auto on_invalidate_range = [this, update_item_count] (index_type first, index_type count) {
+				const auto item_count = _item_count;
+
+				update_item_count();
+				if (_state_keep_focus_visible)
+					make_visible(get_focused());
+				if (item_count != _item_count)
+					invalidate_();
+				else
+					invalidate_rows_(first, count);
 			};
 
 			if (model == _model)
 				return;
 			_model_invalidation = model ? model->invalidate += on_invalidate : nullptr;
+			_model_range_invalidation = model ? model->invalidate_range += on_invalidate_range : nullptr;
 			_model = model;
 			_focused = nullptr;
 			_precached_range = make_pair(npos(), 0);
@@ -374,6 +396,50 @@ namespace wpl
 		void listview_core::invalidate_()
 		{	visual::invalidate(nullptr);	}
 
+		void listview_core::invalidate_rows_(index_type first, index_type count)
+		{
+			if (npos() == first)
+				return invalidate_();
+
+			const auto visible_range = get_visible_range();
+			const auto from = (max)(first, visible_range.first);
+			const auto to = (min)(first + (min)(count, _item_count - (min)(first, _item_count)),
+				visible_range.first + visible_range.second);
+
+			if (from >= to)
+				return;
+
+			const auto item_height = get_minimal_item_height();
+			const auto &size = get_last_size();
+			const auto area = create_rect<int>(0,
+				(max)(static_cast<int>(floor(item_height * (from - _offset.dy))), 0),
+				static_cast<int>(ceil(size.w)),
+				(min)(static_cast<int>(ceil(item_height * (to - _offset.dy))), static_cast<int>(ceil(size.h))));
+
+			if (area.y1 < area.y2)
+				visual::invalidate(&area);
+		}
+
+		void listview_core::scroll_(const agge::agge_vector<double> &previous_offset)
+		{
+			const auto &size = get_last_size();
+			const auto dx = previous_offset.dx - _offset.dx;
+			const auto dy = (previous_offset.dy - _offset.dy) * get_minimal_item_height();
+			const auto idx = static_cast<int>(floor(dx + 0.5));
+			const auto idy = static_cast<int>(floor(dy + 0.5));
+
+			// Only whole-pixel shifts keep the rendering intact, large ones leave nothing to reuse.
+			if ((fabs(dx - idx) > c_tolerance) | (fabs(dy - idy) > c_tolerance) | (!idx & !idy)
+				| (abs(idx) >= size.w) | (abs(idy) >= size.h))
+			{
+				invalidate_();
+			}
+			else
+			{
+				visual::scroll(idx, idy);
+			}
+		}
+
 		void listview_core::selection_clear()
 		{
 			if (_selection)
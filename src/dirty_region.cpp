@@ -0,0 +1,93 @@
+//	Copyright (c) 2011-2022 by Artem A. Gevorkyan (gevorkyan.org)
+//
+//	Permission is hereby granted, free of charge, to any person obtaining a copy
+//	of this software and associated documentation files (the "Software"), to deal
+//	in the Software without restriction, including without limitation the rights
+//	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//	copies of the Software, and to permit persons to whom the Software is
+//	furnished to do so, subject to the following conditions:
+//
+//	The above copyright notice and this permission notice shall be included in
+//	all copies or substantial portions of the Software.
+//
+//	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+//	THE SOFTWARE.
+
+#include <wpl/dirty_region.h>
+
+#include <wpl/helpers.h>
+
+using namespace std;
+
+namespace wpl
+{
+	namespace
+	{
+		long long area_of(const rect_i &rect_)
+		{	return static_cast<long long>(width(rect_)) * height(rect_);	}
+
+		long long union_waste(const rect_i &lhs, const rect_i &rhs)
+		{
+			auto u = lhs;
+
+			unite(u, rhs);
+			return area_of(u) - area_of(lhs) - area_of(rhs);
+		}
+	}
+
+	dirty_region::dirty_region(size_t max_rectangles)
+		: _max_rectangles(max_rectangles ? max_rectangles : 1)
+	{	_rectangles.reserve(_max_rectangles + 1);	}
+
+	void dirty_region::add(rect_i area)
+	{
+		if (is_empty(area))
+			return;
+
+		for (auto i = _rectangles.begin(); i != _rectangles.end(); )
+		{
+			if (are_intersecting(*i, area) || union_waste(*i, area) <= 0)
+			{
+				unite(area, *i);
+				_rectangles.erase(i);
+				i = _rectangles.begin(); // The united rectangle may now overlap the ones already checked.
+			}
+			else
+			{
+				++i;
+			}
+		}
+		_rectangles.push_back(area);
+		if (_rectangles.size() > _max_rectangles)
+			merge_cheapest();
+	}
+
+	void dirty_region::merge_cheapest()
+	{
+		auto best = make_pair(_rectangles.begin(), _rectangles.begin() + 1);
+		auto best_waste = union_waste(*best.first, *best.second);
+
+		for (auto i = _rectangles.begin(); i != _rectangles.end(); ++i)
+		{
+			for (auto j = i + 1; j != _rectangles.end(); ++j)
+			{
+				const auto waste = union_waste(*i, *j);
+
+				if (waste < best_waste)
+					best = make_pair(i, j), best_waste = waste;
+			}
+		}
+
+		auto merged = *best.first;
+
+		unite(merged, *best.second);
+		_rectangles.erase(best.second);
+		_rectangles.erase(best.first);
+		add(merged);
+	}
+}
@@ -0,0 +1,106 @@
+//	Copyright (c) 2011-2022 by Artem A. Gevorkyan (gevorkyan.org)
+//
+//	Permission is hereby granted, free of charge, to any person obtaining a copy
+//	of this software and associated documentation files (the "Software"), to deal
+//	in the Software without restriction, including without limitation the rights
+//	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//	copies of the Software, and to permit persons to whom the Software is
+//	furnished to do so, subject to the following conditions:
+//
+//	The above copyright notice and this permission notice shall be included in
+//	all copies or substantial portions of the Software.
+//
+//	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+//	THE SOFTWARE.
+
+#include <wpl/draw_pool.h>
+
+using namespace std;
+
+namespace wpl
+{
+	draw_pool::draw_pool(unsigned concurrency)
+		: _job(nullptr), _next(0), _count(0), _pending(0), _stop(false)
+	{
+		for (unsigned i = 1; i < concurrency; ++i)
+			_threads.push_back(thread([this] {	worker();	}));
+	}
+
+	draw_pool::~draw_pool()
+	{
+		{
+			lock_guard<mutex> l(_mtx);
+
+			_stop = true;
+		}
+		_ready.notify_all();
+		for (auto i = _threads.begin(); i != _threads.end(); ++i)
+			i->join();
+	}
+
+	void draw_pool::run(unsigned count, const job_type &job)
+	{
+		unique_lock<mutex> l(_mtx);
+
+		_job = &job;
+		_next = 0;
+		_count = _pending = count;
+		_exception = nullptr;
+		_ready.notify_all();
+		while (take(l))
+		{	}
+		_done.wait(l, [this] {	return !_pending;	});
+		_job = nullptr;
+		_count = 0;
+
+		const auto e = _exception;
+
+		_exception = nullptr;
+		if (e)
+			rethrow_exception(e);
+	}
+
+	void draw_pool::worker()
+	{
+		unique_lock<mutex> l(_mtx);
+
+		for (;;)
+		{
+			_ready.wait(l, [this] {	return _stop || _next < _count;	});
+			if (_stop)
+				return;
+			take(l);
+		}
+	}
+
+	bool draw_pool::take(unique_lock<mutex> &lock)
+	{
+		if (_next >= _count)
+			return false;
+
+		const auto index = _next++;
+		const auto &job = *_job;
+
+		lock.unlock();
+		try
+		{
+			job(index);
+		}
+		catch (...)
+		{
+			lock.lock();
+			if (!_exception)
+				_exception = current_exception();
+			lock.unlock();
+		}
+		lock.lock();
+		if (!--_pending)
+			_done.notify_all();
+		return true;
+	}
+}
@@ -32,6 +32,7 @@ namespace wpl
 			context.cursor_manager_,
 			context.clock_,
 			context.queue_,
+			context.frame_scheduler_,
 		};
 
 		if (i != _control_constructors.end())
@@ -0,0 +1,139 @@
+//	Copyright (c) 2011-2022 by Artem A. Gevorkyan (gevorkyan.org)
+//
+//	Permission is hereby granted, free of charge, to any person obtaining a copy
+//	of this software and associated documentation files (the "Software"), to deal
+//	in the Software without restriction, including without limitation the rights
+//	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//	copies of the Software, and to permit persons to whom the Software is
+//	furnished to do so, subject to the following conditions:
+//
+//	The above copyright notice and this permission notice shall be included in
+//	all copies or substantial portions of the Software.
+//
+//	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+//	THE SOFTWARE.
+
+
+#include <wpl/frame_profiler.h>
+
+#include <algorithm>
+#include <cmath>
+#include <unordered_map>
+
+using namespace std;
+
+namespace wpl
+{
+	namespace
+	{
+		void reset(frame_record &record)
+		{
+			record.draw_time = record.layout_time = 0.0;
+			record.invalidations = record.render_calls = 0;
+			record.rasterized_area = 0;
+			record.views.clear();
+		}
+
+		bool by_draw_time(const view_timing &lhs, const view_timing &rhs)
+		{	return lhs.draw_time > rhs.draw_time;	}
+	}
+
+	frame_profiler::frame_profiler(size_t history)
+		: _history_size((max)(history, static_cast<size_t>(1)))
+	{
+		reset(_current);
+		reset(_last);
+		_counters.calls = 0;
+		_counters.area = 0;
+	}
+
+	void frame_profiler::begin_frame()
+	{
+		_counters.calls = 0;
+		_counters.area = 0;
+		_current.views.clear();
+		_frame_start = clock_type::now();
+	}
+
+	void frame_profiler::view_drawn(size_t index, double draw_time)
+	{
+		lock_guard<mutex> l(_mtx);
+		const view_timing t = {	index, draw_time	};
+
+		_current.views.push_back(t);
+	}
+
+	void frame_profiler::end_frame()
+	{
+		_current.draw_time = chrono::duration<double>(clock_type::now() - _frame_start).count();
+		_current.render_calls = _counters.calls;
+		_current.rasterized_area = _counters.area;
+		if (_history.size() == _history_size)
+			_history.pop_front();
+		_history.push_back(_current);
+		_last = _current;
+		reset(_current);
+		frame_completed(_last);
+	}
+
+	void frame_profiler::layout_done(double layout_time)
+	{	_current.layout_time += layout_time;	}
+
+	double frame_profiler::percentile(double p) const
+	{
+		vector<double> times;
+
+		if (_history.empty())
+			return 0.0;
+		for (auto i = _history.begin(); i != _history.end(); ++i)
+			times.push_back(i->draw_time);
+
+		const auto n = static_cast<size_t>(ceil((min)((max)(p, 0.0), 1.0) * times.size()));
+		const auto nth = times.begin() + (n ? n - 1 : 0);
+
+		nth_element(times.begin(), nth, times.end());
+		return *nth;
+	}
+
+	vector<unsigned> frame_profiler::histogram(double bucket_width, size_t buckets) const
+	{
+		vector<unsigned> result(buckets);
+
+		if (!buckets || bucket_width <= 0.0)
+			return result;
+		for (auto i = _history.begin(); i != _history.end(); ++i)
+			result[(min)(static_cast<size_t>(i->draw_time / bucket_width), buckets - 1)]++;
+		return result;
+	}
+
+	vector<view_timing> frame_profiler::slowest_views(size_t count) const
+	{
+		unordered_map<size_t, double> worst_times;
+		vector<view_timing> worst;
+
+		for (auto i = _history.begin(); i != _history.end(); ++i)
+		{
+			for (auto j = i->views.begin(); j != i->views.end(); ++j)
+			{
+				auto &worst_time = worst_times.insert(make_pair(j->index, j->draw_time)).first->second;
+
+				worst_time = (max)(worst_time, j->draw_time);
+			}
+		}
+		for (auto i = worst_times.begin(); i != worst_times.end(); ++i)
+		{
+			const view_timing t = {	i->first, i->second	};
+
+			worst.push_back(t);
+		}
+		count = (min)(count, worst.size());
+		partial_sort(worst.begin(), worst.begin() + count, worst.end(), &by_draw_time);
+		worst.resize(count);
+		return worst;
+	}
+}
@@ -0,0 +1,139 @@
+//	Copyright (c) 2011-2022 by Artem A. Gevorkyan (gevorkyan.org)
+//
+//	Permission is hereby granted, free of charge, to any person obtaining a copy
+//	of this software and associated documentation files (the "Software"), to deal
+//	in the Software without restriction, including without limitation the rights
+//	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//	copies of the Software, and to permit persons to whom the Software is
+//	furnished to do so, subject to the following conditions:
+//
+//	The above copyright notice and this permission notice shall be included in
+//	all copies or substantial portions of the Software.
+//
+//	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+//	THE SOFTWARE.
+
+
+#include <wpl/frame_scheduler.h>
+
+#include <algorithm>
+#include <vector>
+
+using namespace std;
+
+namespace wpl
+{
+	frame_scheduler::frame_scheduler(const clock &clock_, const queue &queue_, unsigned rate)
+		: _clock(clock_), _queue(queue_), _alive(make_shared<bool>(true)), _next_frame(0), _tick_at(0),
+			_generation(0), _frame_requested(false), _tick_pending(false)
+	{
+		set_rate(rate);
+		reset_statistics();
+	}
+
+	frame_scheduler::~frame_scheduler()
+	{	*_alive = false;	}
+
+	void frame_scheduler::set_rate(unsigned rate)
+	{	_interval = (max)(1000 / static_cast<timespan>((max)(rate, 1u)), static_cast<timespan>(1));	}
+
+	void frame_scheduler::request_frame()
+	{
+		_frame_requested = true;
+		schedule();
+	}
+
+	void frame_scheduler::defer(const queue_task &task, timespan defer_by)
+	{
+		_deferred.insert(make_pair(_clock() + defer_by, task));
+		schedule();
+	}
+
+	void frame_scheduler::idle(const queue_task &task)
+	{
+		_idle.push_back(task);
+		schedule();
+	}
+
+	queue frame_scheduler::get_queue()
+	{
+		const auto alive = _alive;
+
+		return [this, alive] (const queue_task &task, timespan defer_by) -> bool {
+			if (!*alive)
+				return false;
+			defer(task, defer_by);
+			return true;
+		};
+	}
+
+	void frame_scheduler::reset_statistics() throw()
+	{
+		_statistics.frames = 0;
+		_statistics.dropped_frames = 0;
+		_statistics.longest_frame = 0;
+	}
+
+	void frame_scheduler::schedule()
+	{
+		const auto now = _clock();
+		auto at = (max)(_next_frame, now);
+
+		if (!_frame_requested && _idle.empty())
+		{
+			if (_deferred.empty())
+				return;
+			at = (max)(at, _deferred.begin()->first);
+		}
+		if (_tick_pending && _tick_at <= at)
+			return;
+
+		const auto alive = _alive;
+		const auto generation = ++_generation;
+
+		_tick_pending = true;
+		_tick_at = at;
+		_queue([this, alive, generation] {
+			if (*alive && generation == _generation)
+				tick();
+		}, at - now);
+	}
+
+	void frame_scheduler::tick()
+	{
+		const auto now = _clock();
+		const auto planned = _tick_at, end_ = now + _interval;
+		vector<queue_task> due;
+
+		// Requests made while ticking are deferred to the end of the tick.
+		_tick_at = now;
+		_next_frame = end_;
+		for (auto i = _deferred.begin(); i != _deferred.end() && i->first <= now; i = _deferred.erase(i))
+			due.push_back(i->second);
+		for (auto i = due.begin(); i != due.end(); ++i)
+			(*i)();
+		if (_frame_requested)
+		{
+			_frame_requested = false;
+			if (now > planned)
+				_statistics.dropped_frames += static_cast<unsigned>((now - planned) / _interval);
+			frame();
+			_statistics.frames++;
+			_statistics.longest_frame = (max)(_statistics.longest_frame, _clock() - now);
+		}
+		while (!_idle.empty() && _clock() < end_)
+		{
+			const auto task = _idle.front();
+
+			_idle.pop_front();
+			task();
+		}
+		_tick_pending = false;
+		schedule();
+	}
+}
@@ -22,9 +22,17 @@
 
 #include <agge/curves.h>
 #include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
 #include <freetype2/ft2build.h>
 #include FT_FREETYPE_H
+#include FT_SIZES_H
 #include <stdexcept>
+#include <sys/stat.h>
+#include <unordered_map>
+#include <unordered_set>
+#include <wpl/draw_pool.h>
 
 using namespace agge;
 using namespace std;
@@ -36,6 +44,22 @@ namespace wpl
 		const int c_overscale = 50;
 		const int c_26x6_1 = 64;
 		const real_t c_26x6_unit = 1.0f / static_cast<real_t>(c_26x6_1);
+		const real_t c_flattening_tolerance = 0.1f; // Outlines are in pixels, so the tolerance is too.
+		const int c_max_curve_segments = 64;
+
+
+		const char c_index_cache_signature[] = "wpl.font-index.2";
+		const size_t c_max_index_string = 65536;
+
+		// Faces found in a font file and the file's stamp they were found for.
+		struct font_file
+		{
+			string path;
+			unsigned long long size, mtime;
+			vector< pair<font_descriptor, unsigned /*face index*/> > faces;
+		};
+
+		typedef unordered_map<string, font_file> font_files_t;
 
 
 		struct text_engine_composite
@@ -74,14 +98,28 @@ namespace wpl
 		void line_to(glyph::outline_storage &outline, real_t x, real_t y)
 		{	outline.push_back(path_point(path_command_line_to, x, y));	}
 
-		void curve3(glyph::outline_storage &outline, real_t x2, real_t y2, real_t x3, real_t y3, real_t d = 0.03f)
+		// Wang's formula: segments needed for the flattened curve to stay within the tolerance of the original one.
+		// The factor is n(n - 1) / 8 for a curve of degree n, dd is the largest second difference of its points.
+		int segments_count(real_t dd, real_t factor)
+		{
+			const auto n = static_cast<int>(ceil(sqrt(dd * factor / c_flattening_tolerance)));
+
+			return n < 1 ? 1 : n > c_max_curve_segments ? c_max_curve_segments : n;
+		}
+
+		real_t distance(real_t dx, real_t dy)
+		{	return sqrt(dx * dx + dy * dy);	}
+
+		void curve3(glyph::outline_storage &outline, real_t x2, real_t y2, real_t x3, real_t y3)
 		{
 			const real_t x1 = (outline.end() - 1)->x, y1 = (outline.end() - 1)->y;
-			
-			for (real_t t = d; t < 1.0f; t += d)
+			const auto n = segments_count(distance(x1 - 2.0f * x2 + x3, y1 - 2.0f * y2 + y3), 0.25f);
+			const real_t d = 1.0f / static_cast<real_t>(n);
+
+			for (int i = 1; i < n; ++i)
 			{
-				real_t t_ = 1.0f - t;
-				
+				const real_t t = d * static_cast<real_t>(i), t_ = 1.0f - t;
+
 				outline.push_back(path_point(path_command_line_to,
 					t_ * t_ * x1 + 2.0f * t_ * t * x2 + t * t * x3,
 					t_ * t_ * y1 + 2.0f * t_ * t * y2 + t * t * y3));
@@ -89,18 +127,22 @@ namespace wpl
 			outline.push_back(path_point(path_command_line_to, x3, y3));
 		}
 
-		void curve4(glyph::outline_storage &outline, real_t x2, real_t y2, real_t x3, real_t y3, real_t x4, real_t y4, real_t d = 0.03f)
+		void curve4(glyph::outline_storage &outline, real_t x2, real_t y2, real_t x3, real_t y3, real_t x4, real_t y4)
 		{
 			const real_t x1 = (outline.end() - 1)->x, y1 = (outline.end() - 1)->y;
-			
-			for (real_t t = d; t < 1.0f; t += d)
+			const auto dd = (max)(distance(x1 - 2.0f * x2 + x3, y1 - 2.0f * y2 + y3),
+				distance(x2 - 2.0f * x3 + x4, y2 - 2.0f * y3 + y4));
+			const auto n = segments_count(dd, 0.75f);
+			const real_t d = 1.0f / static_cast<real_t>(n);
+
+			for (int i = 1; i < n; ++i)
 			{
 				real_t x, y;
 
-				cbezier::calculate(&x, &y, x1, y1, x2, y2, x3, y3, x4, y4, t);
+				cbezier::calculate(&x, &y, x1, y1, x2, y2, x3, y3, x4, y4, d * static_cast<real_t>(i));
 				outline.push_back(path_point(path_command_line_to, x, y));
 			}
-			outline.push_back(path_point(path_command_line_to, x3, y3));
+			outline.push_back(path_point(path_command_line_to, x4, y4));
 		}
 
 		void close_polygon(glyph::outline_storage &outline)
@@ -117,6 +159,29 @@ namespace wpl
 			});
 		}
 
+		// FreeType objects are not thread-safe: a face (with its sizes and glyph slot) is only used under its lock.
+		// Faces share a fixed set of locks.
+		mutex &face_lock(const FT_FaceRec_ *face)
+		{
+			static mutex locks[16];
+
+			return locks[(reinterpret_cast<size_t>(face) / sizeof(void *)) % (sizeof(locks) / sizeof(locks[0]))];
+		}
+
+		shared_ptr<FT_SizeRec_> create_size(FT_Face face)
+		{
+			lock_guard<mutex> l(face_lock(face));
+			FT_Size size;
+
+			if (FT_Error error = FT_New_Size(face, &size))
+				throw runtime_error("Cannot create font size!");
+			return shared_ptr<FT_SizeRec_>(size, [] (FT_Size p) {
+				lock_guard<mutex> l(face_lock(p->face));
+
+				FT_Done_Size(p);
+			});
+		}
+
 		shared_ptr<FT_FaceRec_> open_face(FT_Library freetype, const string &path, unsigned index)
 		{
 			FT_Face face;
@@ -128,6 +193,116 @@ namespace wpl
 			});
 		}
 
+		bool get_stamp(const string &path, font_file &file)
+		{
+			struct stat info;
+
+			if (::stat(path.c_str(), &info))
+				return false;
+			file.size = static_cast<unsigned long long>(info.st_size);
+			file.mtime = static_cast<unsigned long long>(info.st_mtime);
+			return true;
+		}
+
+		void write_string(ostream &stream, const string &value)
+		{	stream << value.size() << ':' << value;	}
+
+		bool read_string(istream &stream, string &value)
+		{
+			size_t length = 0;
+			char separator = 0;
+
+			if (!(stream >> length) || !stream.get(separator) || ':' != separator || length > c_max_index_string)
+				return false;
+			value.resize(length);
+			return !length || stream.read(&value[0], static_cast<streamsize>(length));
+		}
+
+		// The cache is a text file: a signature followed by the number of records, each record is a file line (path,
+		// size, mtime and the number of faces) followed by a line per face (family, weight, italic and face index).
+		// Strings are length-prefixed, so they may contain any characters. The cache is only taken if read completely.
+		void read_index_cache(font_files_t &files, const string &path)
+		{
+			ifstream stream(path.c_str(), ios_base::binary);
+			string signature;
+			size_t count = 0;
+			font_files_t read;
+
+			if (!(stream >> signature >> count) || signature != c_index_cache_signature)
+				return;
+			for (; count; --count)
+			{
+				font_file file;
+				size_t faces = 0;
+
+				if (!read_string(stream, file.path) || !(stream >> file.size >> file.mtime >> faces))
+					return;
+				for (; faces; --faces)
+				{
+					pair<font_descriptor, unsigned> face;
+					int weight = 0, italic = 0;
+
+					if (!read_string(stream, face.first.family) || !(stream >> weight >> italic >> face.second))
+						return;
+					face.first.weight = static_cast<font_weight>(weight);
+					face.first.italic = !!italic;
+					file.faces.push_back(face);
+				}
+				read[file.path] = move(file);
+			}
+			files.swap(read);
+		}
+
+		void write_index_cache(const string &path, const vector<font_file> &files)
+		{
+			// Written aside and renamed over, so that an interrupted write never leaves a partial cache behind.
+			const auto temporary = path + ".tmp";
+			ofstream stream(temporary.c_str(), ios_base::out | ios_base::trunc | ios_base::binary);
+
+			stream << c_index_cache_signature << ' ' << files.size() << '\n';
+			for (auto i = files.begin(); i != files.end(); ++i)
+			{
+				const auto &file = *i;
+
+				write_string(stream, file.path);
+				stream << ' ' << file.size << ' ' << file.mtime << ' ' << file.faces.size() << '\n';
+				for (auto j = file.faces.begin(); j != file.faces.end(); ++j)
+				{
+					write_string(stream, j->first.family);
+					stream << ' ' << static_cast<int>(j->first.weight) << ' ' << (j->first.italic ? 1 : 0) << ' '
+						<< j->second << '\n';
+				}
+			}
+			stream.close();
+			if (!stream || (::rename(temporary.c_str(), path.c_str())
+				&& (::remove(path.c_str()), ::rename(temporary.c_str(), path.c_str())))) // Renaming over fails on Windows.
+			{
+				::remove(temporary.c_str());
+			}
+		}
+
+		font_weight find_weight(string &styles);
+
+		void read_faces(FT_Library freetype, font_file &file)
+		{
+			string styles;
+			auto index = 0;
+			auto faces = 0;
+
+			do
+			{
+				const auto face = open_face(freetype, file.path, index);
+				font_descriptor key = {};
+
+				faces = face->num_faces;
+				key.family = face->family_name;
+				key.weight = (styles = face->style_name, find_weight(styles));
+				key.italic = !!(FT_STYLE_FLAG_ITALIC & face->style_flags);
+				if (string::npos == styles.find("NARROW"))
+					file.faces.push_back(make_pair(key, index));
+			} while (++index < faces);
+		}
+
 		font_weight find_weight(string &styles)
 		{
 			for_each(styles.begin(), styles.end(), [] (char &c) {	c = static_cast<char>(toupper(c));	});
@@ -157,12 +332,19 @@ namespace wpl
 	}
 
 
-	font_accessor::font_accessor(FT_Library freetype_, const string &path, unsigned index, int height,
-			font_hinting hinting)
-		: _face(open_face(freetype_, path, index)),
+	font_accessor::font_accessor(shared_ptr<FT_FaceRec> face_, int height, font_hinting hinting)
+		: _face(face_), _size(create_size(face_.get())),
 			_overscale(hint_vertical == hinting ? 1.0f / static_cast<real_t>(c_overscale) : 1.0f), _height(height),
 			_hinting(hinting)
-	{	FT_Set_Pixel_Sizes(_face.get(), static_cast<int>(height / _overscale), height);	}
+	{
+		unique_lock<mutex> l;
+		const auto f = face(l);
+
+		FT_Set_Pixel_Sizes(f, static_cast<int>(height / _overscale), height);
+		_metrics.ascent = -scale_y(f->size->metrics.ascender);
+		_metrics.descent = scale_y(f->size->metrics.descender);
+		_metrics.leading = 0.0f;
+	}
 
 	font_descriptor font_accessor::get_descriptor() const
 	{
@@ -172,29 +354,28 @@ namespace wpl
 	}
 
 	font_metrics font_accessor::get_metrics() const
+	{	return _metrics;	}
+
+	agge::glyph_index_t font_accessor::get_glyph_index(codepoint_t character) const
 	{
-		font_metrics m = {
-			-scale_y(_face->size->metrics.ascender),
-			scale_y(_face->size->metrics.descender),
-			0.0f,
-		};
+		unique_lock<mutex> l;
 
-		return m;
+		return get_page(l, character).indices[character % c_page_size];
 	}
 
-	agge::glyph_index_t font_accessor::get_glyph_index(codepoint_t character) const
-	{	return static_cast<agge::uint16_t>(FT_Get_Char_Index(_face.get(), character));	}
-
 	glyph::outline_ptr font_accessor::load_glyph(agge::glyph_index_t index, glyph::glyph_metrics &m) const
 	{
 		glyph::outline_ptr path(new glyph::outline_storage);
+		unique_lock<mutex> l;
+		const auto face_ = face(l); // The glyph slot is shared by all the sizes, so it's read under the lock too.
 
-		if (FT_Error error = FT_Load_Glyph(_face.get(), index, _hinting ? FT_LOAD_DEFAULT : FT_LOAD_NO_HINTING))
+		if (FT_Error error = FT_Load_Glyph(face_, index, load_flags()))
 			return path;
-		m.advance_x = scale_x(_face->glyph->advance.x);
-		m.advance_y = scale_y(_face->glyph->advance.y);
 
-		FT_Outline outline = _face->glyph->outline;
+		m.advance_x = scale_x(face_->glyph->advance.x);
+		m.advance_y = scale_y(face_->glyph->advance.y);
+
+		FT_Outline outline = face_->glyph->outline;
 		FT_Vector v_last;
 		FT_Vector v_control;
 		FT_Vector v_start;
@@ -351,15 +532,61 @@ Do_Conic:
 	real_t font_accessor::scale_y(int value)
 	{	return static_cast<real_t>(-value) * c_26x6_unit;	}
 
+	int font_accessor::load_flags() const
+	{	return _hinting ? FT_LOAD_DEFAULT : FT_LOAD_NO_HINTING;	}
+
+	const font_accessor::page &font_accessor::get_page(unique_lock<mutex> &l, codepoint_t character) const
+	{
+		const auto face_ = face(l);
+		auto &p = _pages[character / c_page_size];
+
+		if (!p)
+		{
+			unique_ptr<page> filled(new page);
+
+			for (codepoint_t i = 0, c = character - character % c_page_size; i != c_page_size; ++i, ++c)
+				filled->indices[i] = static_cast<agge::uint16_t>(FT_Get_Char_Index(face_, c));
+			p = move(filled);
+		}
+		return *p;
+	}
+
+	FT_Face font_accessor::face(unique_lock<mutex> &l) const
+	{
+		l = unique_lock<mutex>(face_lock(_face.get()));
+		if (_face->size != _size.get())
+			FT_Activate_Size(_size.get());
+		return _face.get();
+	}
+
 
 	font_loader::font_loader()
-		: _freetype(create_freetype())
-	{	build_index();	}
+		: _freetype(create_freetype()), _freetype_lock(make_shared<mutex>()), _indexed(false), _cancel(false)
+	{	start_indexing(get_index_cache_path(), create_fonts_enumerator(default_font_directories()));	}
+
+	font_loader::font_loader(const string &index_cache_path, const vector<string> &font_directories)
+		: _freetype(create_freetype()), _freetype_lock(make_shared<mutex>()), _indexed(false), _cancel(false)
+	{	start_indexing(index_cache_path, create_fonts_enumerator(font_directories));	}
+
+	font_loader::font_loader(const string &index_cache_path, const enum_font_files_cb &enumerate_font_files)
+		: _freetype(create_freetype()), _freetype_lock(make_shared<mutex>()), _indexed(false), _cancel(false)
+	{	start_indexing(index_cache_path, enumerate_font_files);	}
+
+	font_loader::~font_loader()
+	{
+		_cancel = true;
+		_indexer.join();
+	}
 
 	font::accessor_ptr font_loader::load(const agge::font_descriptor &descriptor)
 	{
-		auto m = _mapping.lower_bound(descriptor);
+		unique_lock<mutex> l(_mtx);
+		auto m = _mapping.end();
 
+		// Blocks only until the face requested is indexed. The nearest match is only looked for in a complete index.
+		_index_updated.wait(l, [&] {	return (m = _mapping.find(descriptor)) != _mapping.end() || _indexed;	});
+		if (m == _mapping.end())
+			m = _mapping.lower_bound(descriptor);
 		if (m != _mapping.end())
 		{
 			if (m != _mapping.begin() && (m->first.family.size() != descriptor.family.size()
@@ -367,34 +594,148 @@ Do_Conic:
 			{
 				--m;
 			}
-			return make_shared<wpl::font_accessor>(_freetype.get(), m->second.first.c_str(), m->second.second,
-				descriptor.height, descriptor.hinting);
+
+			const auto id = m->second;
+
+			l.unlock();
+			return make_shared<wpl::font_accessor>(get_face(id), descriptor.height, descriptor.hinting);
 		}
 		return nullptr;
 	}
 
-	void font_loader::build_index()
+	shared_ptr<FT_FaceRec> font_loader::get_face(const face_id_t &id)
 	{
-		string family, path, styles;
-		font_descriptor key = {};
+		// Faces are created and destroyed under the library's lock, as both modify the library.
+		const auto freetype_lock = _freetype_lock;
+		lock_guard<mutex> l(*freetype_lock);
+
+		for (auto i = _faces.begin(); i != _faces.end(); ) // Forget the faces no accessor uses anymore.
+			i = i->second.expired() ? _faces.erase(i) : next(i);
+
+		auto &entry = _faces[id];
+
+		if (auto face = entry.lock())
+			return face;
+
+		size_t size = 0;
+		const auto data = map_file(id.first, size);
+		const auto freetype = _freetype;
+		FT_Face face;
 
-		for (const auto e = create_fonts_enumerator(); e(path); )
+		if (FT_Error error = FT_New_Memory_Face(freetype.get(), static_cast<const FT_Byte *>(data.get()),
+			static_cast<FT_Long>(size), id.second, &face))
 		{
-			auto index = 0;
-			auto faces = 0;
+			throw runtime_error("Cannot load font-face '" + id.first +"'!");
+		}
 
-			do
+		// The face is parsed in place: the mapping (and the library) must outlive it.
+		shared_ptr<FT_FaceRec> shared_face(face, [freetype, freetype_lock, data] (FT_Face p) {
+			lock_guard<mutex> l(*freetype_lock);
+
+			FT_Done_Face(p);
+		});
+
+		entry = shared_face;
+		return shared_face;
+	}
+
+	void font_loader::start_indexing(const string &index_cache_path, const enum_font_files_cb &enumerate_font_files)
+	{
+		_indexer = thread([this, index_cache_path, enumerate_font_files] {
+			try
 			{
-				const auto face = open_face(_freetype.get(), path, index);
+				build_index(index_cache_path, enumerate_font_files);
+			}
+			catch (...)
+			{
+			}
 
-				faces = face->num_faces;
-				key.family = face->family_name;
-				key.weight = (styles = face->style_name, find_weight(styles));
-				key.italic = !!(FT_STYLE_FLAG_ITALIC & face->style_flags);
-				if (string::npos == styles.find("NARROW"))
-					_mapping[key] = make_pair(path, index);
-			} while (++index < faces);
+			lock_guard<mutex> l(_mtx);
+
+			_indexed = true;
+			_index_updated.notify_all();
+		});
+	}
+
+	void font_loader::build_index(const string &index_cache_path, const enum_font_files_cb &enumerate_font_files)
+	{
+		font_files_t cached;
+		vector<font_file> files;
+		vector<size_t> pending;
+		unordered_set<string> known;
+		string path;
+
+		if (!index_cache_path.empty())
+			read_index_cache(cached, index_cache_path);
+		while (!_cancel && enumerate_font_files(path))
+		{
+			font_file file;
+
+			if (!known.insert(path).second || !get_stamp(path, file))
+				continue;
+			file.path = path;
+
+			const auto c = cached.find(path);
+
+			if (c != cached.end() && c->second.size == file.size && c->second.mtime == file.mtime)
+			{
+				file.faces = move(c->second.faces);
+				add_faces(file.path, file.faces);
+			}
+			else
+			{
+				pending.push_back(files.size());
+			}
+			files.push_back(move(file));
 		}
+
+		if (!pending.empty())
+		{
+			draw_pool pool((max)(1u, thread::hardware_concurrency()));
+			atomic<size_t> next(0);
+
+			pool.run(pool.concurrency(), [&] (unsigned /*index*/) {
+				const auto freetype = create_freetype(); // Libraries are not to be shared between threads.
+
+				for (size_t i; !_cancel && (i = next++) < pending.size(); )
+				{
+					auto &file = files[pending[i]];
+
+					try
+					{
+						read_faces(freetype.get(), file);
+					}
+					catch (const exception &)
+					{
+						file.faces.clear(); // A broken font file is not to hide the rest.
+					}
+					add_faces(file.path, file.faces);
+				}
+			});
+		}
+		if (_cancel)
+			return;
+
+		// The faces are re-added in the enumeration order, so that later files take over equal keys regardless of
+		// the order they were read in.
+		lock_guard<mutex> l(_mtx);
+
+		for (auto i = files.begin(); i != files.end(); ++i)
+		{
+			for (auto j = i->faces.begin(); j != i->faces.end(); ++j)
+				_mapping[j->first] = make_pair(i->path, j->second);
+		}
+		if (!index_cache_path.empty() && (!pending.empty() || cached.size() != files.size()))
+			write_index_cache(index_cache_path, files);
+	}
+
+	void font_loader::add_faces(const string &path, const vector< pair<font_descriptor, unsigned> > &faces)
+	{
+		lock_guard<mutex> l(_mtx);
+
+		for (auto i = faces.begin(); i != faces.end(); ++i)
+			_mapping[i->first] = make_pair(path, i->second);
+		_index_updated.notify_all();
 	}
 
 
@@ -0,0 +1,127 @@
+//	Copyright (c) 2011-2022 by Artem A. Gevorkyan (gevorkyan.org)
+//
+//	Permission is hereby granted, free of charge, to any person obtaining a copy
+//	of this software and associated documentation files (the "Software"), to deal
+//	in the Software without restriction, including without limitation the rights
+//	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//	copies of the Software, and to permit persons to whom the Software is
+//	furnished to do so, subject to the following conditions:
+//
+//	The above copyright notice and this permission notice shall be included in
+//	all copies or substantial portions of the Software.
+//
+//	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+//	THE SOFTWARE.
+
+#include <wpl/layer_cache.h>
+
+#include <cstring>
+
+using namespace agge;
+using namespace std;
+
+namespace wpl
+{
+	namespace
+	{
+		size_t size_of(count_t width, count_t height)
+		{	return static_cast<size_t>(width) * height * sizeof(gcontext::pixel_type);	}
+
+		size_t size_of(const gcontext::surface_type &surface)
+		{	return size_of(surface.width(), surface.height());	}
+
+		void clear_surface(gcontext::surface_type &surface)
+		{
+			for (count_t y = 0; y < surface.height(); ++y)
+				memset(surface.row_ptr(y), 0, surface.width() * sizeof(gcontext::pixel_type));
+		}
+	}
+
+	layer_cache::layer_cache(size_t budget)
+		: _budget(budget), _size(0)
+	{	}
+
+	const gcontext::surface_type *layer_cache::find(const void *key, count_t width, count_t height)
+	{
+		const auto i = find_layer(key);
+
+		if (i == _layers.end() || !i->valid || i->surface->width() != width || i->surface->height() != height)
+			return nullptr;
+		_layers.splice(_layers.begin(), _layers, i);
+		return i->surface.get();
+	}
+
+	gcontext::surface_type *layer_cache::acquire(const void *key, count_t width, count_t height)
+	{
+		auto i = find_layer(key);
+		const auto required = size_of(width, height);
+
+		if (i != _layers.end())
+		{
+			_size -= size_of(*i->surface);
+			if (required > _budget)
+			{
+				_layers.erase(i);
+				return nullptr;
+			}
+			_layers.splice(_layers.begin(), _layers, i);
+			i->surface->resize(width, height);
+		}
+		else if (required > _budget)
+		{
+			return nullptr;
+		}
+		else
+		{
+			layer l = {	key, unique_ptr<gcontext::surface_type>(new gcontext::surface_type(width, height, 0)), false	};
+
+			_layers.push_front(move(l));
+			i = _layers.begin();
+		}
+		_size += required;
+		evict(i);
+		i->valid = true;
+		clear_surface(*i->surface);
+		return i->surface.get();
+	}
+
+	void layer_cache::invalidate(const void *key) throw()
+	{
+		const auto i = find_layer(key);
+
+		if (i != _layers.end())
+			i->valid = false;
+	}
+
+	void layer_cache::clear() throw()
+	{
+		_layers.clear();
+		_size = 0;
+	}
+
+	layer_cache::layers_t::iterator layer_cache::find_layer(const void *key) throw()
+	{
+		for (auto i = _layers.begin(); i != _layers.end(); ++i)
+		{
+			if (i->key == key)
+				return i;
+		}
+		return _layers.end();
+	}
+
+	void layer_cache::evict(layers_t::const_iterator keep) throw()
+	{
+		for (auto i = _layers.end(); _size > _budget && i != _layers.begin(); )
+		{
+			if (--i == keep)
+				continue;
+			_size -= size_of(*i->surface);
+			i = _layers.erase(i);
+		}
+	}
+}
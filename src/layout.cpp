@@ -23,12 +23,32 @@
 #include "helpers.h"
 
 #include <algorithm>
+#include <atomic>
+#include <climits>
 #include <wpl/helpers.h>
 
 using namespace std;
 
 namespace wpl
 {
+	namespace
+	{
+		// Distinct from any tab order override, so that the probe tells whether there was one.
+		const int c_probe_tab_order = INT_MIN;
+
+		// Versions are unique among all containers, so that a container created at the address of a destroyed one
+		// never matches the placement the latter has left in a layout_cache.
+		atomic<unsigned> next_container_version(0);
+	}
+
+	container::container()
+		: _version(next_container_version++)
+	{
+		_invalidate_connection = layout_changed += [this] (bool /*hierarchy_changed*/) {
+			_version = next_container_version++;
+		};
+	}
+
 	void container::remove(const control &child)
 	{
 		const auto i = find_if(_connections.begin(), _connections.end(),
@@ -48,6 +68,110 @@ namespace wpl
 		layout_changed(true);
 	}
 
+	void container::layout(const placed_view_appender &append_view, const agge::box<int> &box)
+	{
+		if (layout_cache::_active)
+			layout_cache::_active->place(*this, append_view, box);
+		else
+			layout_children(append_view, box);
+	}
+
+
+	thread_local layout_cache *layout_cache::_active = nullptr;
+
+	layout_cache::layout_cache()
+		: _probe(nullptr)
+	{	}
+
+	void layout_cache::layout(control &root, const agge::box<int> &box)
+	{
+		const auto previous_active = _active;
+
+		_previous_views.swap(_views);
+		_previous_placements.swap(_placements);
+		_views.clear();
+		_placements.clear();
+		_previous_index.clear();
+		for (auto i = _previous_placements.begin(); i != _previous_placements.end(); ++i)
+			_previous_index.insert(make_pair(i->owner, static_cast<size_t>(i - _previous_placements.begin())));
+		_active = this;
+		try
+		{
+			root.layout([this] (const placed_view &pv) {	append(pv);	}, box);
+		}
+		catch (...)
+		{
+			_active = previous_active;
+			throw;
+		}
+		_active = previous_active;
+		_previous_views.clear();
+	}
+
+	void layout_cache::place(container &container_, const placed_view_appender &append_view, const agge::box<int> &box)
+	{
+		// The probe comes back with the transform applied by the containers above.
+		placed_view probe = {	nullptr, nullptr, create_rect(0, 0, 0, 0), c_probe_tab_order	};
+		placement p = {	&container_, container_._version, box, 0, 0, 0, _views.size(), 0, 0	};
+
+		_probe = &probe;
+		append_view(probe);
+		_probe = nullptr;
+		p.dx = probe.location.x1, p.dy = probe.location.y1;
+		p.tab_override = probe.tab_order;
+		if (splice(p))
+			return;
+
+		const auto index = _placements.size();
+
+		_placements.push_back(p);
+		container_.layout_children(append_view, box);
+		_placements[index].end = _views.size();
+		_placements[index].descendants = _placements.size() - index - 1;
+	}
+
+	bool layout_cache::splice(const placement &placement_)
+	{
+		const auto i = _previous_index.find(placement_.owner);
+
+		if (_previous_index.end() == i)
+			return false;
+
+		const auto &previous = _previous_placements[i->second];
+
+		if (previous.version != placement_.version || previous.box.w != placement_.box.w
+			|| previous.box.h != placement_.box.h || previous.tab_override != placement_.tab_override)
+		{
+			return false;
+		}
+
+		const auto dx = placement_.dx - previous.dx, dy = placement_.dy - previous.dy;
+		const auto begin = _views.size();
+
+		for (auto j = i->second; j <= i->second + previous.descendants; ++j)
+		{
+			auto p = _previous_placements[j];
+
+			p.begin = p.begin - previous.begin + begin, p.end = p.end - previous.begin + begin;
+			p.dx += dx, p.dy += dy;
+			_placements.push_back(p);
+		}
+		for (auto j = _previous_views.begin() + previous.begin; j != _previous_views.begin() + previous.end; ++j)
+		{
+			wpl::offset(j->location, dx, dy);
+			_views.push_back(move(*j));
+		}
+		return true;
+	}
+
+	void layout_cache::append(const placed_view &pv)
+	{
+		if (_probe)
+			*_probe = pv, _probe = nullptr;
+		else
+			_views.push_back(pv);
+	}
+
 
 	padding::padding(shared_ptr<control> inner, int px, int py)
 		: _inner(inner), _px(px), _py(py)
@@ -73,13 +197,17 @@ namespace wpl
 
 
 
+	overlay::overlay()
+		: _min_sizes(layout_changed)
+	{	}
+
 	void overlay::add(shared_ptr<control> child)
 	{
 		_children.push_back(child);
 		container::add(*child);
 	}
 
-	void overlay::layout(const placed_view_appender &append_view, const agge::box<int> &box)
+	void overlay::layout_children(const placed_view_appender &append_view, const agge::box<int> &box)
 	{
 		for_each(_children.begin(), _children.end(), [&append_view, &box] (const shared_ptr<control> &ctl) {
 			ctl->layout(append_view, box);
@@ -88,20 +216,24 @@ namespace wpl
 
 	int overlay::min_height(int for_width) const
 	{
-		auto v = 0;
+		return _min_sizes.height(for_width, [this, for_width] {
+			auto v = 0;
 
-		for (auto i = _children.begin(); i != _children.end(); ++i)
-			v = (max)(v, (*i)->min_height(for_width));
-		return v;
+			for (auto i = _children.begin(); i != _children.end(); ++i)
+				v = (max)(v, (*i)->min_height(for_width));
+			return v;
+		});
 	}
 
 	int overlay::min_width(int for_height) const
 	{
-		auto v = 0;
+		return _min_sizes.width(for_height, [this, for_height] {
+			auto v = 0;
 
-		for (auto i = _children.begin(); i != _children.end(); ++i)
-			v = (max)(v, (*i)->min_width(for_height));
-		return v;
+			for (auto i = _children.begin(); i != _children.end(); ++i)
+				v = (max)(v, (*i)->min_width(for_height));
+			return v;
+		});
 	}
 
 
@@ -132,7 +132,7 @@ namespace wpl
 
 
 	stack::stack(bool horizontal, shared_ptr<cursor_manager> cursor_manager_)
-		: _cursor_manager(cursor_manager_), _spacing(0), _horizontal(horizontal)
+		: _cursor_manager(cursor_manager_), _min_sizes(layout_changed), _spacing(0), _horizontal(horizontal)
 	{	}
 
 	void stack::set_spacing(int spacing)
@@ -151,7 +151,7 @@ namespace wpl
 		container::add(*child);
 	}
 
-	void stack::layout(const placed_view_appender &append_view, const agge::box<int> &box)
+	void stack::layout_children(const placed_view_appender &append_view, const agge::box<int> &box)
 	{
 		auto location = box.w - box.w;	// '0' in coordinates type
 		const auto shared_size = (_horizontal ? box.w : box.h) - (static_cast<int>(_children.size()) - 1) * _spacing;
@@ -181,10 +181,18 @@ namespace wpl
 	}
 
 	int stack::min_height(int for_width) const
-	{	return _horizontal ? min_common(for_width) : min_shared(for_width);	}
+	{
+		return _min_sizes.height(for_width, [this, for_width] {
+			return _horizontal ? min_common(for_width) : min_shared(for_width);
+		});
+	}
 
 	int stack::min_width(int for_height) const
-	{	return _horizontal ? min_shared(for_height) : min_common(for_height);	}
+	{
+		return _min_sizes.width(for_height, [this, for_height] {
+			return _horizontal ? min_shared(for_height) : min_common(for_height);
+		});
+	}
 
 	agge::box<int> stack::create_box(int item_size, const agge::box<int> &self) const
 	{	return _horizontal ? agge::create_box(item_size, self.h) : agge::create_box(self.w, item_size);	}
@@ -73,7 +73,7 @@ namespace wpl
 		layout_changed(false);
 	}
 
-	void staggered::layout(const placed_view_appender &append_view, const box<int> &box_)
+	void staggered::layout_children(const placed_view_appender &append_view, const box<int> &box_)
 	{
 		const auto cw = _base_width.apply(calculate_width(box_.w));
 		auto x = 0;
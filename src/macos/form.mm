@@ -22,11 +22,28 @@
 
 #include <Cocoa/Cocoa.h>
 #include <wpl/helpers.h>
+#include <wpl/layout.h>
 
 using namespace agge;
 using namespace std;
 using namespace wpl;
 
+namespace
+{
+	// The view is not flipped: its origin is in the bottom-left corner.
+	NSRect to_native(const rect_i &area, CGFloat view_height)
+	{	return NSMakeRect(area.x1, view_height - area.y2, wpl::width(area), wpl::height(area));	}
+
+	rect_i from_native(const NSRect &area, CGFloat view_height)
+	{
+		return create_rect<int>(
+			static_cast<int>(floor(area.origin.x)),
+			static_cast<int>(floor(view_height - area.origin.y - area.size.height)),
+			static_cast<int>(ceil(area.origin.x + area.size.width)),
+			static_cast<int>(ceil(view_height - area.origin.y)));
+	}
+}
+
 @interface window_macos : NSWindow
 	{
 		@public wpl::signal<void ()> close_;
@@ -39,6 +56,7 @@ using namespace wpl;
 	{
 		wpl::form_context _context;
 		shared_ptr<wpl::control> _root;
+		wpl::layout_cache _layout;
 		vector<wpl::placed_view> _views;
 		wpl::gcontext::rasterizer_ptr _rasterizer;
 		wpl::slot_connection _layout_changed_connection;
@@ -74,14 +92,11 @@ namespace wpl
 		shared_ptr<void> routers_host::capture_mouse()
 		{	return nullptr;	}
 	
-		void routers_host::invalidate(const agge::rect_i &/*area_*/)
-		{
-//			CGRect area = {
-//				{	static_cast<double>(area_.x1), static_cast<double>(area_.y1)	},
-//				{	static_cast<double>(wpl::width(area_)), static_cast<double>(wpl::height(area_))	},
-//			};
-			[_native_view  setNeedsDisplay:YES];
-		}
+		void routers_host::invalidate(const agge::rect_i &area)
+		{	[_native_view setNeedsDisplayInRect:to_native(area, [_native_view bounds].size.height)];	}
+
+		bool routers_host::scroll(const agge::rect_i &/*area*/, int /*dx*/, int /*dy*/)
+		{	return false;	}
 	
 	
 		form::form(const wpl::form_context &context)
@@ -160,6 +175,8 @@ namespace wpl
 	{
 		_context = context;
 		_context.backbuffer->resize(800, 700);
+		_visual_router->set_draw_pool(context.draw_pool_);
+		_visual_router->set_profiler(context.frame_profiler_);
 	}
 
 	- (void) setRoot:(shared_ptr<wpl::control>)root
@@ -186,10 +203,18 @@ namespace wpl
 	-(void) layout_views:(NSSize)size_
 	{
 		const agge::box<int> size = { static_cast<int>(size_.width), static_cast<int>(size_.height) };
+		const frame_profiler::stopwatch sw;
 		
 		_views.clear();
 		if (_root)
-			_root->layout([self] (const placed_view &pv) {	_views.emplace_back(pv);	}, size);
+		{
+			_layout.layout(*_root, size);
+			_views.assign(_layout.get_views().begin(), _layout.get_views().end());
+		}
+		_visual_router->reindex_views();
+		_mouse_router->reindex_views();
+		if (_context.frame_profiler_)
+			_context.frame_profiler_->layout_done(sw());
 		_context.backbuffer->resize(size.w, size.h);
 	}
 
@@ -221,7 +246,16 @@ namespace wpl
 		const vector_i offset = {};
 		gcontext ctx(*_context.backbuffer, *_context.renderer, *_context.text_engine, offset);
 		const auto context = [[NSGraphicsContext currentContext] CGContext];
-		
+		const auto height = [self frame].size.height;
+		const NSRect *rects = nullptr;
+		NSInteger count = 0;
+
+		// The system may extend the areas requested with the exposed ones: each of them is handed to the router.
+		[self getRectsBeingDrawn:&rects count:&count];
+		for (NSInteger i = 0; i != count; ++i)
+			_visual_router->invalidate(from_native(rects[i], height));
+		if (!count)
+			_visual_router->invalidate(from_native(dirtyRect, height));
 		_visual_router->draw(ctx, _rasterizer);
 		_context.backbuffer->blit(context, 0, 0, _context.backbuffer->width(), _context.backbuffer->height());
 	}
@@ -23,7 +23,6 @@
 #include <agge/blenders.h>
 #include <agge/blenders_simd.h>
 #include <agge/color.h>
-#include <agge/figures.h>
 #include <agge/filling_rules.h>
 #include <agge.text/limit.h>
 #include <agge.text/text_engine.h>
@@ -90,8 +89,7 @@ namespace wpl
 				auto r = create_rect(static_cast<real_t>(_last_invalid.x1), static_cast<real_t>(_last_invalid.y1),
 					static_cast<real_t>(_last_invalid.x2), static_cast<real_t>(_last_invalid.y2));
 
-				add_path(*rasterizer_, rectangle(r.x1, r.y1, r.x2, r.y2));
-				context(rasterizer_, blender(color::make(64, 64, 64, 192)), winding<>());
+				context.fill(rasterizer_, r, blender(color::make(64, 64, 64, 192)));
 				inflate(r, -5.0f, -5.0f);
 				context.text_engine.render(*rasterizer_, _text, align_near, align_near, r, limit::none());
 				context(rasterizer_, blender(color::make(255, 255, 255)), winding<>());
@@ -52,6 +52,7 @@ namespace wpl
 	{
 		size_t index = 0;
 
+		reindex_views();
 		_connections.clear();
 		for (auto i = _views.begin(); i != _views.end(); ++i, ++index)
 		{
@@ -82,9 +83,12 @@ namespace wpl
 		}
 	}
 
+	void mouse_router::reindex_views()
+	{	_index.rebuild(_views);	}
+
 	mouse_router::view_and_target mouse_router::from(agge::point<int> &point) const
 	{
-		const auto match = find(_views, point);
+		const auto match = _index.is_current(_views) ? _index.hit_test(_views, point) : find(_views, point);
 		view_and_target result = {	match ? match->regular : nullptr, nullptr	};
 		const rect_i *reference = nullptr;
 
@@ -0,0 +1,228 @@
+//	Copyright (c) 2011-2022 by Artem A. Gevorkyan (gevorkyan.org)
+//
+//	Permission is hereby granted, free of charge, to any person obtaining a copy
+//	of this software and associated documentation files (the "Software"), to deal
+//	in the Software without restriction, including without limitation the rights
+//	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//	copies of the Software, and to permit persons to whom the Software is
+//	furnished to do so, subject to the following conditions:
+//
+//	The above copyright notice and this permission notice shall be included in
+//	all copies or substantial portions of the Software.
+//
+//	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+//	THE SOFTWARE.
+
+#include <wpl/offscreen/view_host.h>
+
+#include <cstring>
+#include <wpl/frame_scheduler.h>
+#include <wpl/helpers.h>
+#include <wpl/view.h>
+
+using namespace agge;
+using namespace std;
+
+namespace wpl
+{
+	namespace offscreen
+	{
+		namespace
+		{
+			struct empty_root : control
+			{
+				virtual void layout(const placed_view_appender &/*append_view*/, const box<int> &/*box*/) override
+				{	}
+			};
+
+			void add(rect_i &invalid, const rect_i &area)
+			{
+				if (is_empty(invalid))
+					invalid = area;
+				else if (!is_empty(area))
+					unite(invalid, area);
+			}
+		}
+
+		view_host::view_host(const form_context &context_, int width, int height)
+			: context(context_), _surface(width, height, 0), _rasterizer(new gcontext::rasterizer_type),
+				_root(make_shared<empty_root>()), _visual_router(_views, *this),
+				_visual_router_overlay(_overlay_views, *this), _mouse_router(_views, *this),
+				_keyboard_router(_views, *this), _invalid(create_rect(0, 0, width, height)), _focused(false)
+		{
+			_visual_router.set_draw_pool(context.draw_pool_);
+			_visual_router_overlay.set_draw_pool(context.draw_pool_);
+			_visual_router.set_profiler(context.frame_profiler_);
+			if (context.frame_scheduler_)
+				_frame_connection = context.frame_scheduler_->frame += [this] {	render();	};
+		}
+
+		view_host::~view_host()
+		{	}
+
+		void view_host::set_root(shared_ptr<control> root)
+		{
+			const auto layout = [this] (bool hierarchy_changed) {
+				layout_views();
+				if (hierarchy_changed)
+				{
+					_visual_router.reload_views();
+					_visual_router_overlay.reload_views();
+					_mouse_router.reload_views();
+					_keyboard_router.reload_views();
+				}
+			};
+
+			_root = root ? root : make_shared<empty_root>();
+			layout(true);
+			_layout_changed_connection = _root->layout_changed += layout;
+		}
+
+		void view_host::resize(int width, int height)
+		{
+			_surface.resize(width, height);
+			layout_views();
+		}
+
+		bool view_host::render()
+		{
+			auto area = _invalid;
+
+			intersect(area, create_rect<int>(0, 0, _surface.width(), _surface.height()));
+			_invalid = create_rect(0, 0, 0, 0);
+			if (is_empty(area))
+				return false;
+
+			gcontext ctx(_surface, *context.renderer, *context.text_engine, zero(), area);
+
+			// Overlay views are to be redrawn wherever the underlying views are.
+			_visual_router_overlay.invalidate(area);
+			_rasterizer->reset();
+			_visual_router.draw(ctx, _rasterizer);
+			_visual_router_overlay.draw(ctx, _rasterizer);
+			return true;
+		}
+
+		void view_host::mouse_move(int depressed, int x, int y)
+		{	_mouse_router.mouse_move(depressed, create_point(x, y));	}
+
+		void view_host::mouse_down(mouse_input::mouse_buttons button_, int depressed, int x, int y)
+		{	_mouse_router.mouse_click(&mouse_input::mouse_down, button_, depressed, create_point(x, y));	}
+
+		void view_host::mouse_up(mouse_input::mouse_buttons button_, int depressed, int x, int y)
+		{	_mouse_router.mouse_click(&mouse_input::mouse_up, button_, depressed, create_point(x, y));	}
+
+		void view_host::mouse_double_click(mouse_input::mouse_buttons button_, int depressed, int x, int y)
+		{	_mouse_router.mouse_click(&mouse_input::mouse_double_click, button_, depressed, create_point(x, y));	}
+
+		void view_host::mouse_scroll(int depressed, int x, int y, int delta_x, int delta_y)
+		{	_mouse_router.mouse_scroll(depressed, create_point(x, y), delta_x, delta_y);	}
+
+		void view_host::mouse_leave()
+		{	_mouse_router.mouse_leave();	}
+
+		void view_host::key_down(unsigned code, int modifiers)
+		{	_keyboard_router.key_down(code, modifiers);	}
+
+		void view_host::character(wchar_t symbol, unsigned repeats, int modifiers)
+		{	_keyboard_router.character(symbol, repeats, modifiers);	}
+
+		void view_host::key_up(unsigned code, int modifiers)
+		{	_keyboard_router.key_up(code, modifiers);	}
+
+		void view_host::got_focus()
+		{
+			_focused = true;
+			_keyboard_router.got_focus();
+		}
+
+		void view_host::lost_focus()
+		{
+			_focused = false;
+			_keyboard_router.lost_focus();
+		}
+
+		void view_host::request_focus(shared_ptr<keyboard_input> input)
+		{	_keyboard_router.set_focus(input.get());	}
+
+		shared_ptr<void> view_host::capture_mouse()
+		{	return make_shared<bool>(true);	}
+
+		void view_host::set_focus()
+		{
+			if (!_focused)
+				got_focus();
+		}
+
+		void view_host::set_focus(native_view &/*nview*/)
+		{	}
+
+		void view_host::invalidate(const rect_i &area)
+		{
+			add(_invalid, area);
+			if (context.frame_scheduler_)
+				context.frame_scheduler_->request_frame();
+		}
+
+		bool view_host::scroll(const rect_i &area, int dx, int dy)
+		{
+			for (auto i = _overlay_views.begin(); i != _overlay_views.end(); ++i)
+			{
+				if (are_intersecting(i->location, area))
+					return false;
+			}
+
+			auto source = area;
+
+			intersect(source, create_rect<int>(0, 0, _surface.width(), _surface.height()));
+
+			auto destination = source;
+
+			offset(destination, dx, dy);
+			intersect(destination, source);
+			if (is_empty(destination))
+				return true;
+
+			const auto count = static_cast<size_t>(wpl::width(destination)) * sizeof(gcontext::pixel_type);
+			const auto move_row = [&] (int y) {
+				memmove(_surface.row_ptr(y) + destination.x1, _surface.row_ptr(y - dy) + destination.x1 - dx, count);
+			};
+
+			if (dy > 0)
+			{
+				for (auto y = destination.y2; y-- > destination.y1; )
+					move_row(y);
+			}
+			else
+			{
+				for (auto y = destination.y1; y < destination.y2; ++y)
+					move_row(y);
+			}
+			return true;
+		}
+
+		void view_host::layout_views()
+		{
+			const frame_profiler::stopwatch sw;
+			const auto all = create_rect<int>(0, 0, _surface.width(), _surface.height());
+
+			_views.clear();
+			_overlay_views.clear();
+			_layout.layout(*_root, create_box<int>(_surface.width(), _surface.height()));
+			for (auto i = _layout.get_views().begin(); i != _layout.get_views().end(); ++i)
+				(i->overlay ? _overlay_views : _views).emplace_back(*i);
+			_visual_router.reindex_views();
+			_visual_router_overlay.reindex_views();
+			_mouse_router.reindex_views();
+			if (context.frame_profiler_)
+				context.frame_profiler_->layout_done(sw());
+			_visual_router.invalidate(all);
+			invalidate(all);
+		}
+	}
+}
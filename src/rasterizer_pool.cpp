@@ -0,0 +1,103 @@
+//	Copyright (c) 2011-2022 by Artem A. Gevorkyan (gevorkyan.org)
+//
+//	Permission is hereby granted, free of charge, to any person obtaining a copy
+//	of this software and associated documentation files (the "Software"), to deal
+//	in the Software without restriction, including without limitation the rights
+//	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//	copies of the Software, and to permit persons to whom the Software is
+//	furnished to do so, subject to the following conditions:
+//
+//	The above copyright notice and this permission notice shall be included in
+//	all copies or substantial portions of the Software.
+//
+//	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+//	THE SOFTWARE.
+
+
+#include <wpl/rasterizer_pool.h>
+
+#include <algorithm>
+
+using namespace std;
+
+namespace wpl
+{
+	rasterizer_pool::rasterizer_pool(unsigned long long large_area, size_t max_idle)
+		: _large_area(large_area), _max_idle(max_idle), _large_rendered(false)
+	{	}
+
+	gcontext::rasterizer_ptr rasterizer_pool::acquire()
+	{
+		lock_guard<mutex> l(_mtx);
+
+		if (_idle.empty())
+			return gcontext::rasterizer_ptr(new gcontext::rasterizer_type);
+
+		// Small ones are preferred, large ones are awaiting trim().
+		auto i = find_if(_idle.begin(), _idle.end(), [] (const entry &e) {	return !e.large;	});
+
+		if (i == _idle.end())
+			i = _idle.begin();
+
+		auto r = move(i->rasterizer);
+
+		_idle.erase(i);
+		return r;
+	}
+
+	void rasterizer_pool::release(gcontext::rasterizer_ptr &rasterizer)
+	{
+		if (!rasterizer)
+			return;
+
+		const auto area = static_cast<unsigned long long>(rasterizer->width()) * rasterizer->height();
+		entry e = {	move(rasterizer), area > _large_area	};
+
+		e.rasterizer->reset();
+
+		lock_guard<mutex> l(_mtx);
+
+		_idle.push_back(move(e));
+	}
+
+	void rasterizer_pool::rendered(unsigned long long area) throw()
+	{
+		if (area > _large_area)
+			_large_rendered = true;
+	}
+
+	void rasterizer_pool::trim()
+	{	trim_idle();	}
+
+	void rasterizer_pool::trim(gcontext::rasterizer_ptr &in_use)
+	{
+		if (trim_idle() && in_use)
+			in_use.reset(new gcontext::rasterizer_type);
+	}
+
+	bool rasterizer_pool::trim_idle()
+	{
+		lock_guard<mutex> l(_mtx);
+		const auto large_rendered = _large_rendered.exchange(false);
+
+		// Rendering resets the rasterizer, so there's no telling which of the idle ones held the large path.
+		if (large_rendered)
+			_idle.clear();
+		_idle.erase(remove_if(_idle.begin(), _idle.end(), [] (const entry &e) {	return e.large;	}), _idle.end());
+		if (_idle.size() > _max_idle)
+			_idle.resize(_max_idle);
+		return large_rendered;
+	}
+
+	size_t rasterizer_pool::idle() const
+	{
+		lock_guard<mutex> l(_mtx);
+
+		return _idle.size();
+	}
+}
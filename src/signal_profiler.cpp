@@ -0,0 +1,136 @@
+//	Copyright (c) 2011-2022 by Artem A. Gevorkyan (gevorkyan.org)
+//
+//	Permission is hereby granted, free of charge, to any person obtaining a copy
+//	of this software and associated documentation files (the "Software"), to deal
+//	in the Software without restriction, including without limitation the rights
+//	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//	copies of the Software, and to permit persons to whom the Software is
+//	furnished to do so, subject to the following conditions:
+//
+//	The above copyright notice and this permission notice shall be included in
+//	all copies or substantial portions of the Software.
+//
+//	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+//	THE SOFTWARE.
+
+#include <wpl/signal_profiler.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <map>
+#include <mutex>
+
+using namespace std;
+
+namespace wpl
+{
+	namespace
+	{
+		typedef chrono::steady_clock clock_type;
+
+		struct registry
+		{
+			mutex mtx;
+			map< string, shared_ptr<signal_statistics> > entries;
+		};
+
+		registry &get_registry()
+		{
+			static registry r;
+			return r;
+		}
+
+		long long now()
+		{	return chrono::duration_cast<chrono::nanoseconds>(clock_type::now().time_since_epoch()).count();	}
+
+		bool by_total_time(const signal_statistics &lhs, const signal_statistics &rhs)
+		{	return lhs.total_time > rhs.total_time || (lhs.total_time == rhs.total_time && lhs.name < rhs.name);	}
+	}
+
+	signal_emission_scope::signal_emission_scope(signal_statistics *statistics, bool reentrant)
+		: _statistics(statistics), _start(statistics ? now() : 0)
+	{
+		if (!_statistics)
+			return;
+		_statistics->emissions++;
+		if (reentrant)
+			_statistics->reentrant_emissions++;
+	}
+
+	signal_emission_scope::~signal_emission_scope()
+	{
+		if (!_statistics)
+			return;
+
+		const auto elapsed = 1e-9 * static_cast<double>(now() - _start);
+
+		_statistics->total_time += elapsed;
+		_statistics->max_time = (max)(_statistics->max_time, elapsed);
+	}
+
+
+	shared_ptr<signal_statistics> register_signal_statistics(const char *name)
+	{
+		auto &r = get_registry();
+		lock_guard<mutex> l(r.mtx);
+		auto &entry = r.entries[name];
+
+		if (!entry)
+		{
+			const signal_statistics s = {	name, 0, 0, 0, 0.0, 0.0	};
+
+			entry = make_shared<signal_statistics>(s);
+		}
+		return entry;
+	}
+
+	vector<signal_statistics> query_signal_statistics()
+	{
+		auto &r = get_registry();
+		lock_guard<mutex> l(r.mtx);
+		vector<signal_statistics> result;
+
+		for (auto i = r.entries.begin(); i != r.entries.end(); ++i)
+			result.push_back(*i->second);
+		sort(result.begin(), result.end(), &by_total_time);
+		return result;
+	}
+
+	string dump_signal_statistics()
+	{
+		const auto statistics = query_signal_statistics();
+		char buffer[200];
+		string result;
+
+		snprintf(buffer, sizeof(buffer), "%-40s %12s %12s %12s %12s %12s\n", "signal", "emissions", "reentrant",
+			"slot calls", "total, ms", "max, ms");
+		result += buffer;
+		for (auto i = statistics.begin(); i != statistics.end(); ++i)
+		{
+			snprintf(buffer, sizeof(buffer), "%-40s %12llu %12llu %12llu %12.3f %12.3f\n", i->name.c_str(),
+				i->emissions, i->reentrant_emissions, i->slot_calls, 1e3 * i->total_time, 1e3 * i->max_time);
+			result += buffer;
+		}
+		return result;
+	}
+
+	void reset_signal_statistics()
+	{
+		auto &r = get_registry();
+		lock_guard<mutex> l(r.mtx);
+
+		for (auto i = r.entries.begin(); i != r.entries.end(); ++i)
+		{
+			auto &s = *i->second;
+
+			s.emissions = s.reentrant_emissions = s.slot_calls = 0;
+			s.total_time = s.max_time = 0.0;
+		}
+	}
+}
@@ -0,0 +1,202 @@
+//	Copyright (c) 2011-2022 by Artem A. Gevorkyan (gevorkyan.org)
+//
+//	Permission is hereby granted, free of charge, to any person obtaining a copy
+//	of this software and associated documentation files (the "Software"), to deal
+//	in the Software without restriction, including without limitation the rights
+//	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//	copies of the Software, and to permit persons to whom the Software is
+//	furnished to do so, subject to the following conditions:
+//
+//	The above copyright notice and this permission notice shall be included in
+//	all copies or substantial portions of the Software.
+//
+//	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+//	THE SOFTWARE.
+
+#include <wpl/freetype2/font_loader.h>
+
+#include <dirent.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <algorithm>
+#include <regex>
+#include <set>
+#include <stdexcept>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+using namespace std;
+
+namespace wpl
+{
+	namespace
+	{
+		const auto c_index_cache_name = "wpl.font-index";
+#if defined(__APPLE__)
+		const auto c_user_cache_directory = "Library/Caches";
+#else
+		const auto c_user_cache_directory = ".cache";
+#endif
+		const regex c_font_extension("\\.(ttf|otf|ttc)$", regex::icase);
+
+		string append_path(string lhs, const string &rhs)
+		{
+			if (!lhs.empty() && lhs.back() != '/')
+				lhs += '/';
+			lhs += rhs;
+			return lhs;
+		}
+
+		string get_env(const char *name, const string &default_value)
+		{
+			const auto value = ::getenv(name);
+
+			return value && *value ? value : default_value;
+		}
+	}
+
+	// Walks the directory trees depth-first. Missing or unreadable directories are skipped, directories reachable
+	// via several links (or link cycles) are visited once.
+	class directory_enumerator : noncopyable
+	{
+	public:
+		directory_enumerator(const vector<string> &roots)
+			: _pending(roots.rbegin(), roots.rend())
+		{	}
+
+		bool operator ()(string &path)
+		{
+			for (;;)
+			{
+				while (!_handle)
+				{
+					if (_pending.empty())
+						return false;
+					open(_pending.back());
+					_pending.pop_back();
+				}
+
+				if (const auto entry = ::readdir(_handle.get()))
+				{
+					struct stat info;
+
+					if (!strcmp(entry->d_name, ".") || !strcmp(entry->d_name, ".."))
+						continue;
+					path = append_path(_directory, entry->d_name);
+					if (::stat(path.c_str(), &info))
+						continue;
+					if (S_ISDIR(info.st_mode))
+						_pending.push_back(path);
+					else if (S_ISREG(info.st_mode))
+						return true;
+				}
+				else
+				{
+					_handle.reset();
+				}
+			}
+		}
+
+	private:
+		void open(const string &directory)
+		{
+			struct stat info;
+
+			if (::stat(directory.c_str(), &info) || !S_ISDIR(info.st_mode)
+				|| !_visited.insert(make_pair(info.st_dev, info.st_ino)).second)
+			{
+				return;
+			}
+			if (const auto dir = ::opendir(directory.c_str()))
+				_handle.reset(dir, &::closedir), _directory = directory;
+		}
+
+	private:
+		vector<string> _pending;
+		set< pair<dev_t, ino_t> > _visited;
+		string _directory;
+		shared_ptr<DIR> _handle;
+	};
+
+	vector<string> font_loader::default_font_directories()
+	{
+		const string home = get_env("HOME", string());
+		vector<string> directories;
+
+#if defined(__APPLE__)
+		directories.push_back("/System/Library/Fonts");
+		directories.push_back("/Library/Fonts");
+		if (!home.empty())
+			directories.push_back(append_path(home, "Library/Fonts"));
+#else
+		const auto data_dirs = get_env("XDG_DATA_DIRS", "/usr/local/share:/usr/share");
+
+		if (!home.empty())
+		{
+			directories.push_back(append_path(get_env("XDG_DATA_HOME", append_path(home, ".local/share")), "fonts"));
+			directories.push_back(append_path(home, ".fonts"));
+		}
+		for (size_t i = 0, j; i <= data_dirs.size(); i = j + 1)
+		{
+			j = min(data_dirs.find(':', i), data_dirs.size());
+			if (j != i)
+				directories.push_back(append_path(data_dirs.substr(i, j - i), "fonts"));
+		}
+		reverse(directories.begin(), directories.end()); // XDG lists the preferred ones first.
+#endif
+		return directories;
+	}
+
+	font_loader::enum_font_files_cb font_loader::create_fonts_enumerator(const vector<string> &font_directories)
+	{
+		auto e = make_shared<directory_enumerator>(font_directories);
+
+		return [e] (string &path) -> bool {
+			while ((*e)(path))
+			{
+				if (regex_search(path, c_font_extension))
+					return true;
+			}
+			return false;
+		};
+	}
+
+	string font_loader::get_index_cache_path()
+	{
+		if (const auto cache = ::getenv("XDG_CACHE_HOME"))
+			return append_path(cache, c_index_cache_name);
+		if (const auto home = ::getenv("HOME"))
+			return append_path(append_path(home, c_user_cache_directory), c_index_cache_name);
+		return string();
+	}
+
+	shared_ptr<const void> font_loader::map_file(const string &path, size_t &size)
+	{
+		const auto fd = ::open(path.c_str(), O_RDONLY);
+		struct stat info;
+
+		if (fd < 0)
+			throw runtime_error("Cannot open font file '" + path + "'!");
+
+		const auto data = ::fstat(fd, &info) ? MAP_FAILED
+			: ::mmap(nullptr, static_cast<size_t>(info.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+
+		::close(fd);
+		if (MAP_FAILED == data)
+			throw runtime_error("Cannot map font file '" + path + "'!");
+
+		const auto mapped_size = size = static_cast<size_t>(info.st_size);
+
+		return shared_ptr<const void>(data, [mapped_size] (const void *p) {
+			::munmap(const_cast<void *>(p), mapped_size);
+		});
+	}
+}
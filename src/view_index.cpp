@@ -0,0 +1,163 @@
+//	Copyright (c) 2011-2022 by Artem A. Gevorkyan (gevorkyan.org)
+//
+//	Permission is hereby granted, free of charge, to any person obtaining a copy
+//	of this software and associated documentation files (the "Software"), to deal
+//	in the Software without restriction, including without limitation the rights
+//	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//	copies of the Software, and to permit persons to whom the Software is
+//	furnished to do so, subject to the following conditions:
+//
+//	The above copyright notice and this permission notice shall be included in
+//	all copies or substantial portions of the Software.
+//
+//	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+//	THE SOFTWARE.
+
+#include <wpl/view_index.h>
+
+#include <wpl/helpers.h>
+
+using namespace std;
+
+namespace wpl
+{
+	namespace
+	{
+		const int c_cells_per_view = 4;
+
+		int div_up(long long value, int divisor)
+		{	return static_cast<int>((value + divisor - 1) / divisor);	}
+	}
+
+	view_index::view_index()
+		: _views_count(0), _cell_width(1), _cell_height(1), _columns(0), _rows(0)
+	{
+		_bounds.x1 = _bounds.y1 = _bounds.x2 = _bounds.y2 = 0;
+	}
+
+	void view_index::rebuild(const vector<placed_view> &views)
+	{
+		long long total_width = 0, total_height = 0;
+		int n = 0;
+
+		_views_count = views.size();
+		_cell_starts.clear();
+		_items.clear();
+		_columns = _rows = 0;
+		for (auto i = views.begin(); i != views.end(); ++i)
+		{
+			const auto &l = i->location;
+
+			if (is_empty(l))
+				continue;
+			if (n++)
+				unite(_bounds, l);
+			else
+				_bounds = l;
+			total_width += width(l), total_height += height(l);
+		}
+		if (!n)
+			return;
+
+		// Cells are sized after an average view and coarsened until their number is proportional to the views count.
+		_cell_width = static_cast<int>((max)(total_width / n, 1LL));
+		_cell_height = static_cast<int>((max)(total_height / n, 1LL));
+		for (;;)
+		{
+			_columns = div_up(width(_bounds), _cell_width);
+			_rows = div_up(height(_bounds), _cell_height);
+			if (static_cast<long long>(_columns) * _rows <= static_cast<long long>(c_cells_per_view) * n + 16)
+				break;
+			_cell_width *= 2, _cell_height *= 2;
+		}
+
+		const auto cells = static_cast<size_t>(_columns) * _rows;
+		rect_i range;
+
+		_cell_starts.assign(cells + 1, 0u);
+		for (auto i = views.begin(); i != views.end(); ++i)
+		{
+			if (!get_cell_range(range, i->location))
+				continue;
+			for (auto y = range.y1; y != range.y2; ++y)
+			{
+				for (auto x = range.x1; x != range.x2; ++x)
+					_cell_starts[y * _columns + x + 1]++;
+			}
+		}
+		for (size_t c = 0; c != cells; ++c)
+			_cell_starts[c + 1] += _cell_starts[c];
+		_items.resize(_cell_starts[cells]);
+
+		vector<unsigned> fill(_cell_starts.begin(), _cell_starts.end() - 1);
+
+		for (auto i = views.begin(); i != views.end(); ++i)
+		{
+			if (!get_cell_range(range, i->location))
+				continue;
+			for (auto y = range.y1; y != range.y2; ++y)
+			{
+				for (auto x = range.x1; x != range.x2; ++x)
+					_items[fill[y * _columns + x]++] = static_cast<unsigned>(i - views.begin());
+			}
+		}
+	}
+
+	bool view_index::is_current(const vector<placed_view> &views) const throw()
+	{	return !_cell_starts.empty() && views.size() == _views_count;	}
+
+	const placed_view *view_index::hit_test(const vector<placed_view> &views, agge::point<int> point) const
+	{
+		if (!_columns || point.x < _bounds.x1 || point.y < _bounds.y1 || point.x >= _bounds.x2 || point.y >= _bounds.y2)
+			return nullptr;
+
+		const auto cell = (point.y - _bounds.y1) / _cell_height * _columns + (point.x - _bounds.x1) / _cell_width;
+
+		for (auto i = _cell_starts[cell + 1]; i != _cell_starts[cell]; )
+		{
+			const auto &pv = views[_items[--i]];
+			const auto &w = pv.location;
+
+			if (w.x1 <= point.x && point.x < w.x2 && w.y1 <= point.y && point.y < w.y2)
+				return &pv;
+		}
+		return nullptr;
+	}
+
+	void view_index::query(vector<size_t> &positions, const rect_i &area) const
+	{
+		rect_i range;
+
+		if (!get_cell_range(range, area))
+			return;
+		for (auto y = range.y1; y != range.y2; ++y)
+		{
+			for (auto x = range.x1; x != range.x2; ++x)
+			{
+				const auto cell = y * _columns + x;
+
+				positions.insert(positions.end(), _items.begin() + _cell_starts[cell],
+					_items.begin() + _cell_starts[cell + 1]);
+			}
+		}
+	}
+
+	bool view_index::get_cell_range(rect_i &range, const rect_i &area) const
+	{
+		auto clipped = area;
+
+		intersect(clipped, _bounds);
+		if (!_columns || is_empty(clipped))
+			return false;
+		range.x1 = (clipped.x1 - _bounds.x1) / _cell_width;
+		range.y1 = (clipped.y1 - _bounds.y1) / _cell_height;
+		range.x2 = (clipped.x2 - 1 - _bounds.x1) / _cell_width + 1;
+		range.y2 = (clipped.y2 - 1 - _bounds.y1) / _cell_height + 1;
+		return true;
+	}
+}
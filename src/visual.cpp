@@ -1,5 +1,11 @@
 #include <wpl/visual.h>
 
+#include <wpl/rasterizer_pool.h>
+
+#include <agge/figures.h>
+#include <agge/path.h>
+#include <cmath>
+#include <cstring>
 #include <wpl/helpers.h>
 
 using namespace agge;
@@ -25,31 +31,158 @@ namespace wpl
 	gcontext::gcontext(surface_type &surface, renderer_type &renderer_, text_engine_type &text_engine_,
 			const vector_i &offset) throw()
 		: text_engine(text_engine_), _surface(surface), _renderer(renderer_), _offset(offset),
-			_window(create_rect<int>(0, 0, surface.width(), surface.height()) + offset)
+			_window(create_rect<int>(0, 0, surface.width(), surface.height()) + offset), _counters(nullptr),
+			_rasterizers(nullptr), _text_lock(nullptr)
 	{	}
 
 	gcontext::gcontext(surface_type &surface, renderer_type &renderer_, text_engine_type &text_engine_,
 			const vector_i &offset, const rect_i &window_) throw()
 		: text_engine(text_engine_), _surface(surface), _renderer(renderer_), _offset(offset),
-			_window(window_)
+			_window(window_), _counters(nullptr), _rasterizers(nullptr), _text_lock(nullptr)
 	{	}
 
 	gcontext gcontext::translate(int offset_x, int offset_y) const throw()
 	{
 		const vector_i offset = { offset_x, offset_y };
 
-		return gcontext(_surface, _renderer, text_engine, _offset - offset, _window - offset);
+		return derive(_surface, _renderer, _offset - offset, _window - offset);
 	}
 
 	gcontext gcontext::window(int x1, int y1, int x2, int y2) const throw()
-	{	return gcontext(_surface, _renderer, text_engine, _offset, create_rect(x1, y1, x2, y2));	}
+	{	return derive(_surface, _renderer, _offset, create_rect(x1, y1, x2, y2));	}
+
+	gcontext gcontext::offscreen(surface_type &surface) const throw()
+	{	return derive(surface, _renderer, zero(), create_rect<int>(0, 0, surface.width(), surface.height()));	}
+
+	gcontext gcontext::with_renderer(renderer_type &renderer_) const throw()
+	{	return derive(_surface, renderer_, _offset, _window);	}
+
+	gcontext gcontext::with_counters(render_counters *counters) const throw()
+	{
+		auto ctx = derive(_surface, _renderer, _offset, _window);
+
+		ctx._counters = counters;
+		return ctx;
+	}
+
+	gcontext gcontext::with_rasterizers(rasterizer_pool *rasterizers) const throw()
+	{
+		auto ctx = derive(_surface, _renderer, _offset, _window);
+
+		ctx._rasterizers = rasterizers;
+		return ctx;
+	}
+
+	gcontext gcontext::with_text_lock(mutex *lock) const throw()
+	{
+		auto ctx = derive(_surface, _renderer, _offset, _window);
+
+		ctx._text_lock = lock;
+		return ctx;
+	}
+
+	unique_lock<mutex> gcontext::lock_text_engine() const
+	{	return _text_lock ? unique_lock<mutex>(*_text_lock) : unique_lock<mutex>();	}
+
+	gcontext::rasterizer_ptr gcontext::acquire_rasterizer() const
+	{	return _rasterizers ? _rasterizers->acquire() : rasterizer_ptr(new rasterizer_type);	}
+
+	void gcontext::release_rasterizer(rasterizer_ptr &rasterizer) const
+	{
+		if (_rasterizers)
+			_rasterizers->release(rasterizer);
+		else
+			rasterizer.reset();
+	}
 
 	rect_i gcontext::update_area() const throw()
 	{	return _window;	}
 
+	gcontext gcontext::derive(surface_type &surface, renderer_type &renderer_, const vector_i &offset,
+		const rect_i &window_) const throw()
+	{
+		gcontext ctx(surface, renderer_, text_engine, offset, window_);
+
+		ctx._counters = _counters;
+		ctx._rasterizers = _rasterizers;
+		ctx._text_lock = _text_lock;
+		return ctx;
+	}
+
+	void gcontext::account(const rasterizer_type &rasterizer) const throw()
+	{
+		const auto area = static_cast<unsigned long long>(rasterizer.width()) * rasterizer.height();
+
+		if (_counters)
+		{
+			_counters->calls++;
+			_counters->area += area;
+		}
+		if (_rasterizers)
+			_rasterizers->rendered(area);
+	}
+
+	bool gcontext::split_fill(rasterizer_type &rasterizer, const rect_r &area, rect_i &interior) const
+	{
+		const auto x1 = static_cast<int>(ceil(area.x1)), y1 = static_cast<int>(ceil(area.y1));
+		const auto x2 = static_cast<int>(floor(area.x2)), y2 = static_cast<int>(floor(area.y2));
+		const auto rx1 = static_cast<real_t>(x1), ry1 = static_cast<real_t>(y1);
+		const auto rx2 = static_cast<real_t>(x2), ry2 = static_cast<real_t>(y2);
+		auto edges = false;
+
+		interior = create_rect(0, 0, 0, 0);
+		if (x1 >= x2 || y1 >= y2)
+		{
+			// Thinner than a pixel - nothing to blend directly.
+			add_path(rasterizer, rectangle(area.x1, area.y1, area.x2, area.y2));
+			return true;
+		}
+		if (area.y1 < ry1)
+			add_path(rasterizer, rectangle(area.x1, area.y1, area.x2, ry1)), edges = true;
+		if (ry2 < area.y2)
+			add_path(rasterizer, rectangle(area.x1, ry2, area.x2, area.y2)), edges = true;
+		if (area.x1 < rx1)
+			add_path(rasterizer, rectangle(area.x1, ry1, rx1, ry2)), edges = true;
+		if (rx2 < area.x2)
+			add_path(rasterizer, rectangle(rx2, ry1, area.x2, ry2)), edges = true;
+
+		auto clipped = create_rect(x1, y1, x2, y2);
+
+		intersect(clipped, _window);
+		intersect(clipped, create_rect<int>(0, 0, _surface.width(), _surface.height()) + _offset);
+		if (!is_empty(clipped))
+		{
+			interior = clipped - _offset;
+			if (_counters)
+			{
+				_counters->calls++;
+				_counters->area += static_cast<unsigned long long>(wpl::width(clipped)) * wpl::height(clipped);
+			}
+		}
+		return edges;
+	}
+
+	void gcontext::blit(const surface_type &source, int x, int y)
+	{
+		auto area = create_rect<int>(0, 0, _surface.width(), _surface.height()) + _offset;
+
+		intersect(area, _window);
+		intersect(area, create_rect<int>(x, y, x + source.width(), y + source.height()));
+		if (is_empty(area))
+			return;
+
+		const auto count = static_cast<size_t>(area.x2 - area.x1) * sizeof(pixel_type);
+
+		for (auto y_ = area.y1; y_ < area.y2; ++y_)
+		{
+			memcpy(_surface.row_ptr(y_ - _offset.dy) + (area.x1 - _offset.dx),
+				source.row_ptr(y_ - y) + (area.x1 - x), count);
+		}
+	}
+
 
 	visual::visual()
-		: transcending(false)
+		: transcending(false), cached(false), concurrent_draw(false)
 	{	}
 
 	void visual::draw(gcontext &/*ctx*/, gcontext::rasterizer_ptr &/*rasterizer*/) const
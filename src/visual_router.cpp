@@ -20,6 +20,8 @@
 
 #include <wpl/visual_router.h>
 
+#include <algorithm>
+#include <cstdlib>
 #include <wpl/helpers.h>
 #include <wpl/view.h>
 
@@ -27,15 +29,113 @@ using namespace std;
 
 namespace wpl
 {
+	namespace
+	{
+		const size_t c_max_dirty_rectangles = 8;
+		const size_t c_layer_cache_budget = 16 * 1024 * 1024;
+
+		const int c_min_band_height = 64;
+
+		class view_scope : noncopyable
+		{
+		public:
+			view_scope(frame_profiler *profiler, size_t index)
+				: _profiler(profiler), _index(index)
+			{	}
+
+			~view_scope()
+			{
+				if (_profiler)
+					_profiler->view_drawn(_index, _stopwatch());
+			}
+
+		private:
+			frame_profiler *_profiler;
+			size_t _index;
+			frame_profiler::stopwatch _stopwatch;
+		};
+
+		class time_scope : noncopyable
+		{
+		public:
+			time_scope(double *accumulator) // Nothing is accumulated for a null accumulator.
+				: _accumulator(accumulator)
+			{	}
+
+			~time_scope()
+			{
+				if (_accumulator)
+					*_accumulator += _stopwatch();
+			}
+
+		private:
+			double *_accumulator;
+			frame_profiler::stopwatch _stopwatch;
+		};
+
+		bool is_drawn(const placed_view &pv, const agge::rect_i &update_area)
+		{	return pv.regular && (pv.regular->transcending || are_intersecting(update_area, pv.location));	}
+
+		const gcontext::surface_type *get_layer(gcontext &ctx, gcontext::rasterizer_ptr &rasterizer,
+			const placed_view &pv, layer_cache &layers)
+		{
+			if (!pv.regular->cached || pv.regular->transcending)
+				return nullptr;
+
+			const auto w = static_cast<agge::count_t>(wpl::width(pv.location));
+			const auto h = static_cast<agge::count_t>(wpl::height(pv.location));
+			const gcontext::surface_type *layer = layers.find(pv.regular.get(), w, h);
+
+			if (!layer)
+			{
+				if (const auto surface = layers.acquire(pv.regular.get(), w, h))
+				{
+					auto layer_ctx = ctx.offscreen(*surface);
+
+					pv.regular->draw(layer_ctx, rasterizer);
+					layer = surface;
+				}
+			}
+			return layer;
+		}
+
+		void draw_view(gcontext &ctx, gcontext::rasterizer_ptr &rasterizer, const placed_view &pv,
+			const agge::rect_i &update_area, const gcontext::surface_type *layer)
+		{
+			auto child_ctx = ctx.translate(pv.location.x1, pv.location.y1);
+
+			if (pv.regular->transcending)
+			{
+				pv.regular->draw(child_ctx, rasterizer);
+			}
+			else if (are_intersecting(update_area, pv.location))
+			{
+				auto window = child_ctx.update_area();
+
+				intersect(window, create_rect(0, 0, wpl::width(pv.location), wpl::height(pv.location)));
+
+				auto child_ctx_windowed = child_ctx.window(window.x1, window.y1, window.x2, window.y2);
+
+				if (layer)
+					child_ctx_windowed.blit(*layer, 0, 0);
+				else
+					pv.regular->draw(child_ctx_windowed, rasterizer);
+			}
+		}
+	}
+
 	visual_router::visual_router(const vector<placed_view> &views, visual_router_host &host)
-		: _views(views), _host(host)
+		: _views(views), _host(host), _dirty(c_max_dirty_rectangles), _drawn(c_max_dirty_rectangles),
+			_layers(c_layer_cache_budget)
 	{	}
 
 	void visual_router::reload_views()
 	{
 		size_t index = 0;
 
+		reindex_views();
 		_connections.clear();
+		_layers.clear();
 		for (auto i = _views.begin(); i != _views.end(); ++i, ++index)
 		{
 			if (!i->regular)
@@ -46,42 +146,278 @@ namespace wpl
 
 				const auto &l = _views[index].location;
 
+				_layers.invalidate(_views[index].regular.get());
+				if (_profiler)
+					_profiler->invalidated();
 				if (area)
 				{
 					auto a = *area;
 
 					offset(a, l.x1, l.y1);
+					_dirty.add(a);
 					_host.invalidate(a);
 				}
 				else
 				{
+					_dirty.add(l);
 					_host.invalidate(l);
 				}
 			});
+			_connections.push_back(i->regular->scroll += [this, index] (int dx, int dy) {
+				if (index < _views.size())
+					scroll_view(index, dx, dy);
+			});
+		}
+	}
+
+	void visual_router::reindex_views()
+	{
+		_index.rebuild(_views);
+		_transcending.clear();
+		for (auto i = _views.begin(); i != _views.end(); ++i)
+		{
+			if (i->regular && i->regular->transcending)
+				_transcending.push_back(i - _views.begin());
+		}
+	}
+
+	void visual_router::invalidate(const agge::rect_i &area)
+	{	_dirty.add(area);	}
+
+	void visual_router::scroll_view(size_t index, int dx, int dy)
+	{
+		const auto &l = _views[index].location;
+
+		_layers.invalidate(_views[index].regular.get());
+		if (!can_scroll(index, dx, dy) || !_host.scroll(l, dx, dy))
+		{
+			_dirty.add(l);
+			_host.invalidate(l);
+			return;
+		}
+
+		const agge::rect_i exposed[] = {
+			dx > 0 ? create_rect(l.x1, l.y1, l.x1 + dx, l.y2) : create_rect(l.x2 + dx, l.y1, l.x2, l.y2),
+			dy > 0 ? create_rect(l.x1, l.y1, l.x2, l.y1 + dy) : create_rect(l.x1, l.y2 + dy, l.x2, l.y2),
+		};
+
+		for (auto i = begin(exposed); i != end(exposed); ++i)
+		{
+			if (is_empty(*i))
+				continue;
+			_dirty.add(*i);
+			_host.invalidate(*i);
 		}
 	}
 
-	void visual_router::draw(gcontext &ctx, gcontext::rasterizer_ptr &rasterizer) const
+	bool visual_router::can_scroll(size_t index, int dx, int dy) const
 	{
+		const auto &l = _views[index].location;
+
+		if ((!dx && !dy) || abs(dx) >= wpl::width(l) || abs(dy) >= wpl::height(l))
+			return false;
+
+		// Pending damage would move along with the pixels, while views on top must stay in place.
+		for (auto i = _dirty.begin(); i != _dirty.end(); ++i)
+		{
+			if (are_intersecting(*i, l))
+				return false;
+		}
+		for (auto i = _views.begin() + index + 1; i != _views.end(); ++i)
+		{
+			if (i->regular && (i->regular->transcending || are_intersecting(i->location, l)))
+				return false;
+		}
+		return true;
+	}
+
+	void visual_router::draw(gcontext &ctx, gcontext::rasterizer_ptr &rasterizer)
+	{
+		auto pooled_ctx = ctx.with_rasterizers(&_rasterizers);
+
+		if (_profiler)
+		{
+			auto profiled_ctx = pooled_ctx.with_counters(&_profiler->get_counters());
+
+			_profiler->begin_frame();
+			draw_dirty(profiled_ctx, rasterizer);
+			_profiler->end_frame();
+		}
+		else
+		{
+			draw_dirty(pooled_ctx, rasterizer);
+		}
+		_rasterizers.trim(rasterizer);
+	}
+
+	void visual_router::set_draw_pool(shared_ptr<draw_pool> pool)
+	{	_pool = pool;	}
+
+	void visual_router::set_profiler(shared_ptr<frame_profiler> profiler)
+	{	_profiler = profiler;	}
+
+	const rasterizer_pool &visual_router::get_rasterizers() const
+	{	return _rasterizers;	}
+
+	const layer_cache &visual_router::get_layers() const
+	{	return _layers;	}
+
+	void visual_router::draw_dirty(gcontext &ctx, gcontext::rasterizer_ptr &rasterizer)
+	{
+		if (_dirty.empty())
+			return draw_views(ctx, rasterizer);
+
 		const auto update_area = ctx.update_area();
 
-		for (auto i = _views.begin(); i != _views.end(); ++i)
+		_drawn.swap(_dirty);
+		for (auto i = _drawn.begin(); i != _drawn.end(); ++i)
 		{
-			if (!i->regular)
+			auto area = *i;
+
+			intersect(area, update_area);
+			if (is_empty(area))
 				continue;
 
-			auto child_ctx = ctx.translate(i->location.x1, i->location.y1);
+			auto region_ctx = ctx.window(area.x1, area.y1, area.x2, area.y2);
+
+			draw_views(region_ctx, rasterizer);
+		}
+		_drawn.clear();
+	}
+
+	void visual_router::draw_views(gcontext &ctx, gcontext::rasterizer_ptr &rasterizer)
+	{
+		const auto update_area = ctx.update_area();
+
+		_candidates.clear();
+		if (_index.is_current(_views))
+		{
+			_index.query(_candidates, update_area);
+			_candidates.insert(_candidates.end(), _transcending.begin(), _transcending.end());
+			sort(_candidates.begin(), _candidates.end());
+			_candidates.erase(unique(_candidates.begin(), _candidates.end()), _candidates.end());
+		}
+		else
+		{
+			for (size_t i = 0; i != _views.size(); ++i)
+				_candidates.push_back(i);
+		}
+
+		if (_pool && draw_tiled(ctx, rasterizer))
+			return;
+
+		for (auto i = _candidates.begin(); i != _candidates.end(); ++i)
+		{
+			const auto &pv = _views[*i];
+
+			if (is_drawn(pv, update_area))
+			{
+				view_scope scope(_profiler.get(), *i);
+
+				draw_view(ctx, rasterizer, pv, update_area, get_layer(ctx, rasterizer, pv, _layers));
+			}
+		}
+	}
+
+	bool visual_router::draw_tiled(gcontext &ctx, gcontext::rasterizer_ptr &rasterizer)
+	{
+		const auto update_area = ctx.update_area();
+		const auto h = wpl::height(update_area);
+
+		if (h < 2 * c_min_band_height || _pool->concurrency() < 2)
+			return false;
 
-			if (i->regular->transcending)
+		const auto bands = static_cast<int>((min)(_pool->concurrency(), static_cast<unsigned>(h / c_min_band_height)));
+		const auto draw_band = [this] (gcontext &band_ctx, gcontext::rasterizer_ptr &rasterizer_, band &b) {
+			for (auto i = _tiled.begin(); i != _tiled.end(); ++i)
 			{
-				i->regular->draw(child_ctx, rasterizer);
+				const auto &pv = _views[i->first];
+
+				if (is_drawn(pv, b.area))
+				{
+					time_scope scope(_profiler ? &b.draw_times[i - _tiled.begin()] : nullptr);
+
+					draw_view(band_ctx, rasterizer_, pv, b.area, i->second);
+				}
 			}
-			else if (are_intersecting(update_area, i->location))
+		};
+
+		_tiled.clear();
+		for (auto i = _candidates.begin(); i != _candidates.end(); ++i)
+		{
+			if (is_drawn(_views[*i], update_area))
+				_tiled.push_back(make_pair(*i, static_cast<const gcontext::surface_type *>(nullptr)));
+		}
+
+		while (_bands.size() < static_cast<size_t>(bands))
+		{
+			band b = {	gcontext::rasterizer_ptr(), unique_ptr<gcontext::renderer_type>(new gcontext::renderer_type(1))	};
+
+			_bands.push_back(move(b));
+		}
+		for (auto i = _bands.begin(); i != _bands.begin() + bands; ++i)
+		{
+			const auto index = static_cast<int>(i - _bands.begin());
+
+			i->area = update_area;
+			i->area.y1 = update_area.y1 + static_cast<int>(static_cast<long long>(h) * index / bands);
+			i->area.y2 = update_area.y1 + static_cast<int>(static_cast<long long>(h) * (index + 1) / bands);
+			i->concurrent = true;
+			for (auto j = _tiled.begin(); i->concurrent && j != _tiled.end(); ++j)
 			{
-				auto child_ctx_windowed = child_ctx.window(0, 0, wpl::width(i->location), wpl::height(i->location));
+				const auto &pv = _views[j->first];
 
-				i->regular->draw(child_ctx_windowed, rasterizer);
+				i->concurrent = pv.regular->concurrent_draw || !is_drawn(pv, i->area);
 			}
 		}
+
+		// Bands with any view unable to draw concurrently are drawn on this thread, after the concurrent ones.
+		const auto concurrent_bands = static_cast<unsigned>(stable_partition(_bands.begin(), _bands.begin() + bands,
+			[] (const band &b) {	return b.concurrent;	}) - _bands.begin());
+
+		if (concurrent_bands < 2)
+			return false;
+
+		// Views are timed over the layer update and all bands, and reported once, when the frame is drawn.
+		_tiled_times.assign(_profiler ? _tiled.size() : 0u, 0.0);
+		for (auto i = _bands.begin(); i != _bands.begin() + bands; ++i)
+			i->draw_times.assign(_tiled_times.size(), 0.0);
+
+		// Layers are brought up to date beforehand - the cache is not to be touched from the bands.
+		for (auto i = _tiled.begin(); i != _tiled.end(); ++i)
+		{
+			time_scope scope(_profiler ? &_tiled_times[i - _tiled.begin()] : nullptr);
+
+			i->second = get_layer(ctx, rasterizer, _views[i->first], _layers);
+		}
+
+		const auto shared_ctx = ctx.with_text_lock(&_text_lock); // The bands share the text engine.
+
+		for (auto i = _bands.begin(); i != _bands.begin() + concurrent_bands; ++i)
+			i->rasterizer = ctx.acquire_rasterizer();
+		_pool->run(concurrent_bands, [&] (unsigned index) {
+			auto &b = _bands[index];
+			auto band_ctx = shared_ctx.with_renderer(*b.renderer).window(b.area.x1, b.area.y1, b.area.x2, b.area.y2);
+
+			b.rasterizer->reset();
+			draw_band(band_ctx, b.rasterizer, b);
+		});
+		for (auto i = _bands.begin(); i != _bands.begin() + concurrent_bands; ++i)
+			ctx.release_rasterizer(i->rasterizer);
+		for (auto i = _bands.begin() + concurrent_bands; i != _bands.begin() + bands; ++i)
+		{
+			auto band_ctx = ctx.window(i->area.x1, i->area.y1, i->area.x2, i->area.y2);
+
+			draw_band(band_ctx, rasterizer, *i);
+		}
+		for (auto i = _tiled_times.begin(); i != _tiled_times.end(); ++i)
+		{
+			const auto index = static_cast<size_t>(i - _tiled_times.begin());
+
+			for (auto j = _bands.begin(); j != _bands.begin() + bands; ++j)
+				*i += j->draw_times[index];
+			_profiler->view_drawn(_tiled[index].first, *i);
+		}
+		return true;
 	}
 }
@@ -21,6 +21,7 @@
 #include <wpl/freetype2/font_loader.h>
 
 #include <regex>
+#include <stdexcept>
 #include <windows.h>
 #include <wpl/win32/utf8.h>
 
@@ -32,7 +33,7 @@ namespace wpl
 {
 	namespace
 	{
-		const auto c_default_font_directory = "C:\\Windows\\Fonts";
+		const auto c_index_cache_name = "wpl.font-index";
 		const regex c_font_match(".+\\.(ttf|otf|ttc)", regex::icase);
 
 		string append_path(string lhs, const string &rhs)
@@ -42,6 +43,15 @@ namespace wpl
 			lhs += rhs;
 			return lhs;
 		}
+
+		string get_env(const wchar_t *name)
+		{
+			win32::utf_converter converter;
+			wchar_t buffer[MAX_PATH];
+			const auto n = ::GetEnvironmentVariableW(name, buffer, MAX_PATH);
+
+			return n && n < MAX_PATH ? string(converter(buffer)) : string();
+		}
 	}
 
 	class directory_enumerator : noncopyable
@@ -84,17 +94,77 @@ namespace wpl
 		HANDLE _handle;
 	};
 
-	font_loader::enum_font_files_cb font_loader::create_fonts_enumerator()
+	vector<string> font_loader::default_font_directories()
 	{
-		auto e = make_shared<directory_enumerator>(c_default_font_directory);
+		const auto windows = get_env(L"WINDIR");
+		const auto local_app_data = get_env(L"LOCALAPPDATA");
+		vector<string> directories;
+
+		directories.push_back(append_path(windows.empty() ? "C:\\Windows" : windows, "Fonts"));
+		if (!local_app_data.empty())
+			directories.push_back(append_path(local_app_data, "Microsoft\\Windows\\Fonts")); // Per-user installs.
+		return directories;
+	}
+
+	font_loader::enum_font_files_cb font_loader::create_fonts_enumerator(const vector<string> &font_directories)
+	{
+		// Windows font directories are flat: they are enumerated one after another, non-recursively.
+		struct state
+		{
+			vector<string> directories;
+			size_t next;
+			unique_ptr<directory_enumerator> current;
+		};
+
+		auto st = make_shared<state>();
 
-		return [e] (string &path) -> bool {
-			while ((*e)(path))
+		st->directories = font_directories;
+		st->next = 0;
+		return [st] (string &path) -> bool {
+			for (;;)
 			{
-				if (regex_match(path, c_font_match))
-					return true;
+				while (st->current && (*st->current)(path))
+				{
+					if (regex_match(path, c_font_match))
+						return true;
+				}
+				if (st->next == st->directories.size())
+					return false;
+				st->current.reset(new directory_enumerator(st->directories[st->next++]));
 			}
-			return false;
 		};
 	}
+
+	string font_loader::get_index_cache_path()
+	{
+		const auto local_app_data = get_env(L"LOCALAPPDATA");
+
+		return local_app_data.empty() ? string() : append_path(local_app_data, c_index_cache_name);
+	}
+
+	shared_ptr<const void> font_loader::map_file(const string &path, size_t &size)
+	{
+		win32::utf_converter converter;
+		const auto file = ::CreateFileW(converter(path.c_str()), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING,
+			FILE_ATTRIBUTE_NORMAL, NULL);
+		LARGE_INTEGER file_size = {};
+
+		if (INVALID_HANDLE_VALUE == file)
+			throw runtime_error("Cannot open font file '" + path + "'!");
+
+		const auto mapping = ::GetFileSizeEx(file, &file_size)
+			? ::CreateFileMappingW(file, NULL, PAGE_READONLY, 0, 0, NULL) : NULL;
+		const auto data = mapping ? ::MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0) : NULL;
+
+		// The view keeps the mapping object alive.
+		if (mapping)
+			::CloseHandle(mapping);
+		::CloseHandle(file);
+		if (!data)
+			throw runtime_error("Cannot map font file '" + path + "'!");
+		size = static_cast<size_t>(file_size.QuadPart);
+		return shared_ptr<const void>(data, [] (const void *p) {
+			::UnmapViewOfFile(p);
+		});
+	}
 }
@@ -46,6 +46,9 @@ namespace wpl
 				virtual void layout(const placed_view_appender& /*append_view*/, const agge::box<int>& /*box*/) override
 				{	}
 			};
+
+			bool same_location(const rect_i &lhs, const rect_i &rhs)
+			{	return lhs.x1 == rhs.x1 && lhs.y1 == rhs.y1 && lhs.x2 == rhs.x2 && lhs.y2 == rhs.y2;	}
 		}
 
 		view_host::view_host(HWND hwnd, const form_context &context_, const window::user_handler_t &user_handler)
@@ -54,8 +57,8 @@ namespace wpl
 				_hoverlay(::CreateWindowEx(0, _T("static"), NULL, WS_POPUP, 0, 0, 1, 1, hwnd, NULL, NULL, NULL)),
 				_user_handler(user_handler),
 				_root(make_shared<empty_root>()),
-				_visual_router(hwnd, _views, context_),
-				_visual_router_overlay(_hoverlay, _overlay_views, context_),
+				_visual_router(hwnd, _views, context_, true),
+				_visual_router_overlay(_hoverlay, _overlay_views, context_, false),
 				_mouse_router(_views, *this, context_.cursor_manager_),
 				_keyboard_router(_views, *this),
 				_window(window::attach(hwnd, bind(&view_host::wndproc, this, _1, _2, _3, _4))),
@@ -164,19 +167,41 @@ namespace wpl
 
 		void view_host::layout_views(const box<int> &box_)
 		{
+			const frame_profiler::stopwatch sw;
+
+			_native_locations.clear();
+			for (auto i = _views.begin(); i != _views.end(); ++i)
+			{
+				if (i->native)
+					_native_locations.insert(make_pair(i->native.get(), i->location));
+			}
 			_views.clear();
 			_overlay_views.clear();
-			_root->layout([this] (const placed_view &pv) {
-				(pv.overlay ? _overlay_views : _views).emplace_back(pv);
-			}, box_);
-
-			helpers::defer_window_pos dwp(count_if(_views.begin(), _views.end(), [] (const placed_view &pv) {
-				return !!pv.native;
-			}));
+			_layout.layout(*_root, box_);
+			for (auto i = _layout.get_views().begin(); i != _layout.get_views().end(); ++i)
+				(i->overlay ? _overlay_views : _views).emplace_back(*i);
+			_visual_router.reindex_views();
+			_visual_router_overlay.reindex_views();
+			_mouse_router.reindex_views();
+			if (context.frame_profiler_)
+				context.frame_profiler_->layout_done(sw());
+
+			// Only the native windows that have actually moved (or are yet to be created here) are repositioned.
+			const auto moved = [this] (const placed_view &pv) -> bool {
+				if (!pv.native)
+					return false;
+
+				const auto hwnd = pv.native->get_window();
+				const auto previous = _native_locations.find(pv.native.get());
+
+				return !hwnd || ::GetParent(hwnd) != _hwnd || _native_locations.end() == previous
+					|| !same_location(previous->second, pv.location);
+			};
+			helpers::defer_window_pos dwp(count_if(_views.begin(), _views.end(), moved));
 
 			for (auto i = _views.begin(); i != _views.end(); ++i)
 			{
-				if (i->native)
+				if (moved(*i))
 					dwp.update_location(i->native->get_window(_hwnd), i->location);
 			}
 			if (!_overlay_views.empty())
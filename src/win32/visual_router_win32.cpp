@@ -21,6 +21,7 @@
 #include <wpl/win32/visual_router.h>
 
 #include <agge/math.h>
+#include <wpl/frame_scheduler.h>
 #include <wpl/helpers.h>
 #include <wpl/misc/statistics_view.h>
 #include <wpl/win32/helpers.h>
@@ -36,6 +37,7 @@ namespace wpl
 	{
 		namespace
 		{
+			const size_t c_max_pending_rectangles = 8;
 			LARGE_INTEGER c_tmp;
 			float c_counter_period = 1000.0f / static_cast<float>(::QueryPerformanceFrequency(&c_tmp), c_tmp.QuadPart);
 
@@ -54,15 +56,77 @@ namespace wpl
 
 				::InvalidateRect(hwnd, &rc, FALSE);
 			}
+
+			template <typename CallbackT>
+			void enumerate_update_region(HWND hwnd, const CallbackT &callback)
+			{
+				const shared_ptr<void> rgn(::CreateRectRgn(0, 0, 0, 0), &::DeleteObject);
+				const auto hrgn = static_cast<HRGN>(rgn.get());
+
+				if (::GetUpdateRgn(hwnd, hrgn, FALSE) <= NULLREGION)
+					return;
+
+				vector<BYTE> buffer(::GetRegionData(hrgn, 0, nullptr));
+				const auto data = reinterpret_cast<RGNDATA *>(buffer.data());
+
+				if (buffer.empty() || !::GetRegionData(hrgn, static_cast<DWORD>(buffer.size()), data))
+					return;
+
+				const auto rects = reinterpret_cast<const RECT *>(data->Buffer);
+
+				for (DWORD i = 0; i != data->rdh.nCount; ++i)
+					callback(create_rect<int>(rects[i].left, rects[i].top, rects[i].right, rects[i].bottom));
+			}
 		}
 
-		visual_router::visual_router(HWND hwnd, const vector<placed_view> &views, const form_context &context)
+		visual_router::visual_router(HWND hwnd, const vector<placed_view> &views, const form_context &context,
+				bool profiled)
 			: _hwnd(hwnd), _underlying(views, *this), _rasterizer(new gcontext::rasterizer_type), _context(context),
-				_offset(zero()), _measure_draw(false)
+				_offset(zero()), _pending(c_max_pending_rectangles), _measure_draw(false)
 		{
+			auto profiler = profiled ? context.frame_profiler_ : nullptr;
+
 #ifdef WPL_SHOW_STATISTICS
-			_statistics_view.reset(new misc::statistics_view(context.text_engine));
+			if (profiled)
+			{
+				_statistics_view.reset(new misc::statistics_view(context.text_engine));
+				if (!profiler)
+					profiler = make_shared<frame_profiler>();
+			}
 #endif
+			_underlying.set_draw_pool(context.draw_pool_);
+			_underlying.set_profiler(profiler);
+			if (_statistics_view && profiler)
+			{
+				const auto p = profiler.get();
+
+				_profiler_connection = profiler->frame_completed += [this, p] (const frame_record &f) {
+					const auto slowest = p->slowest_views(1);
+
+					_statistics_view->set_value("Render", static_cast<float>(1e3 * f.draw_time), "ms");
+					_statistics_view->set_value("Render, p95", static_cast<float>(1e3 * p->percentile(0.95)), "ms");
+					_statistics_view->set_value("Layout", static_cast<float>(1e3 * f.layout_time), "ms");
+					_statistics_view->set_value("Render calls", static_cast<int>(f.render_calls), "");
+					_statistics_view->set_value("Invalidations", static_cast<int>(f.invalidations), "");
+					if (!slowest.empty())
+					{
+						_statistics_view->set_value("Slowest view", static_cast<int>(slowest[0].index), "");
+						_statistics_view->set_value("Slowest view, max", static_cast<float>(1e3 * slowest[0].draw_time),
+							"ms");
+					}
+				};
+			}
+			if (const auto scheduler = context.frame_scheduler_)
+			{
+				_frame_connection = scheduler->frame += [this] {
+					if (_pending.empty())
+						return;
+					for (auto i = _pending.begin(); i != _pending.end(); ++i)
+						invalidate_window(_hwnd, *i);
+					_pending.clear();
+					::UpdateWindow(_hwnd);
+				};
+			}
 		}
 
 		visual_router::~visual_router()
@@ -71,6 +135,9 @@ namespace wpl
 		void visual_router::reload_views()
 		{	_underlying.reload_views();	}
 
+		void visual_router::reindex_views()
+		{	_underlying.reindex_views();	}
+
 		void visual_router::set_offset(const agge_vector<int> &offset)
 		{	_offset = offset;	}
 
@@ -89,6 +156,12 @@ namespace wpl
 				break;
 
 			case WM_PAINT:
+				// The update region includes exposed areas the router is not aware of - these must be redrawn too.
+				enumerate_update_region(hwnd, [this] (rect_i area) {
+					wpl::offset(area, _offset.dx, _offset.dy);
+					_underlying.invalidate(area);
+				});
+
 				LARGE_INTEGER time = {};
 				helpers::paint_sequence ps(hwnd);
 				auto &backbuffer = *_context.backbuffer;
@@ -99,17 +172,15 @@ namespace wpl
 				gcontext ctx(backbuffer, *_context.renderer, *_context.text_engine, offset += _offset);
 
 				_rasterizer->reset();
-				stopwatch(time);
 				_underlying.draw(ctx, _rasterizer);
 				if (_statistics_view)
 					_statistics_view->draw(ctx, _rasterizer);
-				const auto render_time = stopwatch(time);
+				stopwatch(time);
 				backbuffer.blit(ps.hdc, ps.rcPaint.left, ps.rcPaint.top, ps.width(), ps.height());
 				const auto blit_time = stopwatch(time);
 
 				if (_statistics_view && _measure_draw)
 				{
-					_statistics_view->set_value("Render", render_time, "ms");
 					_statistics_view->set_value("Blit", blit_time, "ms");
 					_statistics_view->set_value("Invalid rect", create_box<int>(ps.width(), ps.height()), "");
 					invalidate_window(_hwnd, _statistics_view->update());
@@ -126,8 +197,21 @@ namespace wpl
 			auto area2 = area;
 
 			wpl::offset(area2, -_offset.dx, -_offset.dy);
-			invalidate_window(_hwnd, area2);
 			_measure_draw = true;
+			if (!_context.frame_scheduler_)
+				return invalidate_window(_hwnd, area2);
+			_pending.add(area2);
+			_context.frame_scheduler_->request_frame();
+		}
+
+		bool visual_router::scroll(const rect_i &area, int dx, int dy)
+		{
+			RECT rc = {	area.x1 - _offset.dx, area.y1 - _offset.dy, area.x2 - _offset.dx, area.y2 - _offset.dy	};
+
+			// Exposed areas are invalidated by the router, pending update region is moved by the system.
+			::ScrollWindowEx(_hwnd, dx, dy, &rc, &rc, NULL, NULL, 0);
+			_measure_draw = true;
+			return true;
 		}
 	}
 }
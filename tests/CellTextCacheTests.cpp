@@ -0,0 +1,226 @@
+#include <wpl/controls/cell_text_cache.h>
+
+#include <tests/common/helpers-visual.h>
+
+#include <ut/assert.h>
+#include <ut/test.h>
+
+using namespace agge;
+using namespace std;
+
+namespace wpl
+{
+	namespace tests
+	{
+		using controls::cell_text_cache;
+
+		begin_test_suite( CellTextCacheTests )
+			test( NothingIsFoundInEmptyCache )
+			{
+				// INIT
+				cell_text_cache c(10);
+
+				// ACT / ASSERT
+				assert_null(c.find(0, 0, create_rect(0.0f, 0.0f, 10.0f, 10.0f)));
+				assert_null(c.find(3, 1, create_rect(0.0f, 0.0f, 10.0f, 10.0f)));
+				assert_equal(0u, c.size());
+			}
+
+
+			test( AcquiredRunIsFoundForTheSameCell )
+			{
+				// INIT
+				cell_text_cache c(10);
+
+				// ACT
+				auto &r1 = c.acquire(0, 0, create_rect(0.0f, 0.0f, 10.0f, 10.0f));
+				auto &r2 = c.acquire(3, 1, create_rect(0.0f, 0.0f, 10.0f, 10.0f));
+				auto &r3 = c.acquire(1, 3, create_rect(0.0f, 0.0f, 10.0f, 10.0f));
+
+				r1.foreground = color::make(1, 2, 3);
+
+				// ASSERT
+				assert_not_null(r1.raster.get());
+				assert_equal(&r1, c.find(0, 0, create_rect(0.0f, 0.0f, 10.0f, 10.0f)));
+				assert_equal(&r2, c.find(3, 1, create_rect(0.0f, 0.0f, 10.0f, 10.0f)));
+				assert_equal(&r3, c.find(1, 3, create_rect(0.0f, 0.0f, 10.0f, 10.0f)));
+				assert_null(c.find(1, 1, create_rect(0.0f, 0.0f, 10.0f, 10.0f)));
+				assert_equal(3u, c.size());
+			}
+
+
+			test( RunIsLaidOutRelativeToIntegralOriginAndIsFoundAtOtherIntegralOffsets )
+			{
+				// INIT
+				cell_text_cache c(10);
+
+				// ACT
+				auto &r = c.acquire(7, 2, create_rect(10.5f, 20.25f, 40.5f, 35.25f));
+
+				// ASSERT
+				assert_equal(create_rect(0.5f, 0.25f, 30.5f, 15.25f), r.box);
+				assert_equal(&r, c.find(7, 2, create_rect(10.5f, 20.25f, 40.5f, 35.25f)));
+				assert_equal(&r, c.find(7, 2, create_rect(-3.5f, 120.25f, 26.5f, 135.25f)));
+
+				// ACT / ASSERT
+				assert_null(c.find(7, 2, create_rect(10.0f, 20.25f, 40.0f, 35.25f)));
+				assert_null(c.find(7, 2, create_rect(10.5f, 20.25f, 41.5f, 35.25f)));
+				assert_null(c.find(7, 2, create_rect(10.5f, 20.25f, 40.5f, 35.0f)));
+			}
+
+
+			test( ReacquiringCellReplacesItsRun )
+			{
+				// INIT
+				cell_text_cache c(10);
+				auto &r1 = c.acquire(7, 2, create_rect(0.0f, 0.0f, 10.0f, 10.0f));
+
+				// ACT
+				auto &r2 = c.acquire(7, 2, create_rect(0.0f, 0.0f, 20.0f, 10.0f));
+
+				// ASSERT
+				assert_equal(&r1, &r2);
+				assert_equal(1u, c.size());
+				assert_null(c.find(7, 2, create_rect(0.0f, 0.0f, 10.0f, 10.0f)));
+				assert_equal(&r2, c.find(7, 2, create_rect(0.0f, 0.0f, 20.0f, 10.0f)));
+			}
+
+
+			test( LeastRecentlyUsedRunsAreEvictedAboveCapacity )
+			{
+				// INIT
+				cell_text_cache c(3);
+				const auto b = create_rect(0.0f, 0.0f, 10.0f, 10.0f);
+
+				c.acquire(0, 0, b);
+				c.acquire(1, 0, b);
+				c.acquire(2, 0, b);
+				c.find(0, 0, b);
+
+				// ACT
+				c.acquire(3, 0, b);
+
+				// ASSERT
+				assert_equal(3u, c.size());
+				assert_not_null(c.find(0, 0, b));
+				assert_null(c.find(1, 0, b));
+				assert_not_null(c.find(2, 0, b));
+				assert_not_null(c.find(3, 0, b));
+
+				// ACT
+				c.acquire(4, 0, b);
+
+				// ASSERT
+				assert_equal(3u, c.size());
+				assert_null(c.find(0, 0, b));
+				assert_not_null(c.find(2, 0, b));
+				assert_not_null(c.find(3, 0, b));
+				assert_not_null(c.find(4, 0, b));
+			}
+
+
+			test( ReducingCapacityEvictsLeastRecentlyUsedRuns )
+			{
+				// INIT
+				cell_text_cache c(4);
+				const auto b = create_rect(0.0f, 0.0f, 10.0f, 10.0f);
+
+				c.acquire(0, 0, b);
+				c.acquire(1, 0, b);
+				c.acquire(2, 0, b);
+				c.acquire(3, 0, b);
+				c.find(1, 0, b);
+
+				// ACT
+				c.set_capacity(2);
+
+				// ASSERT
+				assert_equal(2u, c.size());
+				assert_null(c.find(0, 0, b));
+				assert_not_null(c.find(1, 0, b));
+				assert_null(c.find(2, 0, b));
+				assert_not_null(c.find(3, 0, b));
+
+				// ACT
+				c.set_capacity(3);
+				c.acquire(4, 0, b);
+				c.acquire(5, 0, b);
+
+				// ASSERT
+				assert_equal(3u, c.size());
+				assert_null(c.find(1, 0, b));
+				assert_not_null(c.find(3, 0, b));
+				assert_not_null(c.find(4, 0, b));
+				assert_not_null(c.find(5, 0, b));
+			}
+
+
+			test( CellsAreKeptApartAcrossTheWholeIndexRange )
+			{
+				// INIT
+				cell_text_cache c(10);
+				const auto b = create_rect(0.0f, 0.0f, 10.0f, 10.0f);
+				const auto high_row = static_cast<cell_text_cache::row_index_type>(1) << (8 * sizeof(size_t) - 16);
+				const auto last_row = static_cast<cell_text_cache::row_index_type>(-1);
+
+				// ACT
+				auto &r1 = c.acquire(0, 0, b);
+				auto &r2 = c.acquire(high_row, 0, b);
+				auto &r3 = c.acquire(last_row, 0, b);
+				auto &r4 = c.acquire(0, -1, b);
+				auto &r5 = c.acquire(last_row, 32767, b);
+
+				// ASSERT
+				assert_equal(5u, c.size());
+				assert_equal(&r1, c.find(0, 0, b));
+				assert_equal(&r2, c.find(high_row, 0, b));
+				assert_equal(&r3, c.find(last_row, 0, b));
+				assert_equal(&r4, c.find(0, -1, b));
+				assert_equal(&r5, c.find(last_row, 32767, b));
+				assert_null(c.find(high_row, -1, b));
+			}
+
+
+			test( RowRangeInvalidationRemovesRunsOfTheRowsOnly )
+			{
+				// INIT
+				cell_text_cache c(100);
+				const auto b = create_rect(0.0f, 0.0f, 10.0f, 10.0f);
+
+				for (unsigned row = 0; row != 10; ++row)
+					c.acquire(row, 0, b), c.acquire(row, 1, b);
+
+				// ACT
+				c.invalidate(3, 4);
+
+				// ASSERT
+				assert_equal(12u, c.size());
+				assert_not_null(c.find(2, 0, b));
+				assert_not_null(c.find(2, 1, b));
+				assert_null(c.find(3, 0, b));
+				assert_null(c.find(6, 1, b));
+				assert_not_null(c.find(7, 0, b));
+				assert_not_null(c.find(7, 1, b));
+			}
+
+
+			test( ClearedCacheHasNoRuns )
+			{
+				// INIT
+				cell_text_cache c(100);
+				const auto b = create_rect(0.0f, 0.0f, 10.0f, 10.0f);
+
+				c.acquire(0, 0, b);
+				c.acquire(1, 0, b);
+
+				// ACT
+				c.clear();
+
+				// ASSERT
+				assert_equal(0u, c.size());
+				assert_null(c.find(0, 0, b));
+				assert_null(c.find(1, 0, b));
+			}
+		end_test_suite
+	}
+}
@@ -0,0 +1,193 @@
+//	Copyright (c) 2011-2022 by Artem A. Gevorkyan (gevorkyan.org)
+//
+//	Permission is hereby granted, free of charge, to any person obtaining a copy
+//	of this software and associated documentation files (the "Software"), to deal
+//	in the Software without restriction, including without limitation the rights
+//	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//	copies of the Software, and to permit persons to whom the Software is
+//	furnished to do so, subject to the following conditions:
+//
+//	The above copyright notice and this permission notice shall be included in
+//	all copies or substantial portions of the Software.
+//
+//	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+//	THE SOFTWARE.
+
+#include <wpl/delegate.h>
+
+#include <memory>
+#include <string>
+#include <ut/assert.h>
+#include <ut/test.h>
+
+using namespace std;
+
+namespace wpl
+{
+	namespace tests
+	{
+		namespace
+		{
+			int g_calls;
+			int g_arg;
+
+			void f0()
+			{	++g_calls;	}
+
+			void f1(int arg1)
+			{	++g_calls, g_arg = arg1;	}
+
+			struct counter
+			{
+				void increment(int by)
+				{	value += by;	}
+
+				int value;
+			};
+
+			struct large_callable
+			{
+				void operator ()(int arg1) const
+				{	*target = arg1 + static_cast<int>(padding[0] + padding[7]);	}
+
+				int *target;
+				double padding[8];
+			};
+		}
+
+		begin_test_suite( DelegateTests )
+			init( Init )
+			{
+				g_calls = 0;
+				g_arg = 0;
+			}
+
+
+			test( DefaultConstructedDelegateIsEmpty )
+			{
+				// INIT / ACT
+				delegate<void ()> d0;
+				delegate<void (int)> d1;
+				delegate<void (int, const string &)> d2;
+
+				// ACT / ASSERT
+				assert_is_false(d0);
+				assert_is_false(d1);
+				assert_is_false(d2);
+			}
+
+
+			test( FunctionsAreInvokedViaDelegate )
+			{
+				// INIT
+				delegate<void ()> d0 = &f0;
+				delegate<void (int)> d1 = f1;
+
+				// ACT / ASSERT
+				assert_is_true(d0);
+				assert_is_true(d1);
+
+				// ACT
+				d0();
+				d1(123);
+
+				// ASSERT
+				assert_equal(2, g_calls);
+				assert_equal(123, g_arg);
+
+				// ACT
+				d1(17);
+
+				// ASSERT
+				assert_equal(3, g_calls);
+				assert_equal(17, g_arg);
+			}
+
+
+			test( BoundMemberFunctionsAreInvoked )
+			{
+				// INIT
+				counter c = {	10	};
+				delegate<void (int)> d = bind(&counter::increment, &c, placeholders::_1);
+
+				// ACT
+				d(3);
+				d(7);
+
+				// ASSERT
+				assert_equal(20, c.value);
+			}
+
+
+			test( SmallAndLargeCallablesAreInvokedAndCopied )
+			{
+				// INIT
+				auto small_value = 0;
+				auto large_value = 0;
+				large_callable l = {	&large_value, {	1.0, 0, 0, 0, 0, 0, 0, 2.0	}	};
+				delegate<void (int)> d1 = [&small_value] (int v) {	small_value = v;	};
+				delegate<void (int)> d2 = l;
+
+				// ACT
+				delegate<void (int)> d1c = d1;
+				delegate<void (int)> d2c = d2;
+
+				d1 = delegate<void (int)>();
+				d2 = delegate<void (int)>();
+				d1c(11);
+				d2c(13);
+
+				// ASSERT
+				assert_is_false(d1);
+				assert_is_false(d2);
+				assert_equal(11, small_value);
+				assert_equal(16, large_value);
+			}
+
+
+			test( CapturedStateIsReleasedOnResetAndDestruction )
+			{
+				// INIT
+				const auto state1 = make_shared<int>();
+				const auto state2 = make_shared<string>("some long text that will not fit into a small buffer");
+				string padding(100, ' ');
+				unique_ptr< delegate<void ()> > d1(new delegate<void ()>([state1] {	}));
+				delegate<void ()> d2 = [state2, padding] {	};
+
+				// ASSERT
+				assert_equal(2, state1.use_count());
+				assert_equal(2, state2.use_count());
+
+				// ACT
+				d1.reset();
+				d2 = delegate<void ()>();
+
+				// ASSERT
+				assert_equal(1, state1.use_count());
+				assert_equal(1, state2.use_count());
+			}
+
+
+			test( AssignmentReplacesCallable )
+			{
+				// INIT
+				auto a = 0, b = 0;
+				delegate<void (int, int)> d1 = [&a] (int x, int y) {	a = x + y;	};
+				const delegate<void (int, int)> d2 = [&b] (int x, int y) {	b = x * y;	};
+
+				// ACT
+				d1 = d2;
+				d1(3, 5);
+
+				// ASSERT
+				assert_equal(0, a);
+				assert_equal(15, b);
+			}
+		end_test_suite
+	}
+}
@@ -0,0 +1,177 @@
+#include <wpl/dirty_region.h>
+
+#include <tests/common/helpers-visual.h>
+
+#include <ut/assert.h>
+#include <ut/test.h>
+
+using namespace std;
+
+namespace wpl
+{
+	namespace tests
+	{
+		namespace
+		{
+			vector<rect_i> get_rectangles(const dirty_region &region)
+			{	return vector<rect_i>(region.begin(), region.end());	}
+		}
+
+		begin_test_suite( DirtyRegionTests )
+			test( NewRegionIsEmpty )
+			{
+				// INIT / ACT
+				dirty_region r(5);
+
+				// ASSERT
+				assert_is_true(r.empty());
+				assert_is_empty(get_rectangles(r));
+			}
+
+
+			test( EmptyRectanglesAreIgnored )
+			{
+				// INIT
+				dirty_region r(5);
+
+				// ACT
+				r.add(create_rect(10, 10, 10, 20));
+				r.add(create_rect(10, 10, 20, 10));
+				r.add(create_rect(10, 10, 5, 20));
+
+				// ASSERT
+				assert_is_true(r.empty());
+			}
+
+
+			test( DisjointRectanglesAreKeptSeparately )
+			{
+				// INIT
+				dirty_region r(5);
+
+				// ACT
+				r.add(create_rect(0, 0, 10, 10));
+				r.add(create_rect(100, 100, 110, 113));
+				r.add(create_rect(11, 0, 21, 10));
+
+				// ASSERT
+				rect_i reference[] = {
+					create_rect(0, 0, 10, 10), create_rect(100, 100, 110, 113), create_rect(11, 0, 21, 10),
+				};
+
+				assert_is_false(r.empty());
+				assert_equal(reference, get_rectangles(r));
+			}
+
+
+			test( OverlappingRectanglesAreUnited )
+			{
+				// INIT
+				dirty_region r(5);
+
+				r.add(create_rect(0, 0, 10, 10));
+				r.add(create_rect(100, 100, 110, 110));
+
+				// ACT
+				r.add(create_rect(5, 7, 20, 30));
+
+				// ASSERT
+				rect_i reference1[] = {	create_rect(100, 100, 110, 110), create_rect(0, 0, 20, 30),	};
+
+				assert_equal(reference1, get_rectangles(r));
+
+				// ACT
+				r.add(create_rect(101, 103, 105, 107));
+
+				// ASSERT
+				rect_i reference2[] = {	create_rect(0, 0, 20, 30), create_rect(100, 100, 110, 110),	};
+
+				assert_equal(reference2, get_rectangles(r));
+			}
+
+
+			test( AdjacentAlignedRectanglesAreUnited )
+			{
+				// INIT
+				dirty_region r(5);
+
+				// ACT
+				r.add(create_rect(0, 0, 10, 10));
+				r.add(create_rect(10, 0, 20, 10));
+				r.add(create_rect(0, 10, 20, 15));
+
+				// ASSERT
+				rect_i reference[] = {	create_rect(0, 0, 20, 15),	};
+
+				assert_equal(reference, get_rectangles(r));
+			}
+
+
+			test( UnitingCascadesToRectanglesOverlappingTheResult )
+			{
+				// INIT
+				dirty_region r(5);
+
+				r.add(create_rect(0, 0, 10, 10));
+				r.add(create_rect(20, 0, 30, 10));
+				r.add(create_rect(50, 50, 60, 60));
+
+				// ACT
+				r.add(create_rect(5, 0, 25, 10));
+
+				// ASSERT
+				rect_i reference[] = {	create_rect(50, 50, 60, 60), create_rect(0, 0, 30, 10),	};
+
+				assert_equal(reference, get_rectangles(r));
+			}
+
+
+			test( CheapestPairIsUnitedWhenLimitIsExceeded )
+			{
+				// INIT
+				dirty_region r(3);
+
+				r.add(create_rect(0, 0, 10, 10));
+				r.add(create_rect(100, 0, 110, 10));
+				r.add(create_rect(0, 100, 10, 110));
+
+				// ACT
+				r.add(create_rect(12, 0, 22, 10));
+
+				// ASSERT
+				rect_i reference1[] = {
+					create_rect(100, 0, 110, 10), create_rect(0, 100, 10, 110), create_rect(0, 0, 22, 10),
+				};
+
+				assert_equal(reference1, get_rectangles(r));
+
+				// ACT
+				r.add(create_rect(0, 112, 10, 120));
+
+				// ASSERT
+				rect_i reference2[] = {
+					create_rect(100, 0, 110, 10), create_rect(0, 0, 22, 10), create_rect(0, 100, 10, 120),
+				};
+
+				assert_equal(reference2, get_rectangles(r));
+			}
+
+
+			test( ClearingRegionEmptiesIt )
+			{
+				// INIT
+				dirty_region r(5);
+
+				r.add(create_rect(0, 0, 10, 10));
+				r.add(create_rect(100, 0, 110, 10));
+
+				// ACT
+				r.clear();
+
+				// ASSERT
+				assert_is_true(r.empty());
+				assert_is_empty(get_rectangles(r));
+			}
+		end_test_suite
+	}
+}
@@ -0,0 +1,142 @@
+#include <wpl/draw_pool.h>
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <ut/assert.h>
+#include <ut/test.h>
+
+using namespace std;
+
+namespace wpl
+{
+	namespace tests
+	{
+		begin_test_suite( DrawPoolTests )
+			test( ConcurrencyIncludesCallingThread )
+			{
+				// INIT / ACT
+				draw_pool p1(1), p3(3), p0(0);
+
+				// ASSERT
+				assert_equal(1u, p1.concurrency());
+				assert_equal(3u, p3.concurrency());
+				assert_equal(1u, p0.concurrency());
+			}
+
+
+			test( EachJobIsRunExactlyOnce )
+			{
+				// INIT
+				draw_pool p(4);
+				mutex mtx;
+				vector<unsigned> log;
+
+				// ACT
+				p.run(37, [&] (unsigned index) {
+					lock_guard<mutex> l(mtx);
+
+					log.push_back(index);
+				});
+
+				// ASSERT
+				assert_equal(37u, log.size());
+				sort(log.begin(), log.end());
+				for (unsigned i = 0; i != 37; ++i)
+					assert_equal(i, log[i]);
+
+				// INIT
+				log.clear();
+
+				// ACT
+				p.run(0, [&] (unsigned index) {	log.push_back(index);	});
+				p.run(2, [&] (unsigned index) {
+					lock_guard<mutex> l(mtx);
+
+					log.push_back(index + 100);
+				});
+
+				// ASSERT
+				sort(log.begin(), log.end());
+				unsigned reference[] = {	100, 101,	};
+
+				assert_equal(reference, log);
+			}
+
+
+			test( SingleThreadedPoolRunsJobsOnCallingThread )
+			{
+				// INIT
+				draw_pool p(1);
+				vector<thread::id> log;
+
+				// ACT
+				p.run(3, [&] (unsigned) {	log.push_back(this_thread::get_id());	});
+
+				// ASSERT
+				thread::id reference[] = {	this_thread::get_id(), this_thread::get_id(), this_thread::get_id(),	};
+
+				assert_equal(reference, log);
+			}
+
+
+			test( JobsAreRunConcurrently )
+			{
+				// INIT
+				draw_pool p(3);
+				mutex mtx;
+				condition_variable cv;
+				unsigned arrived = 0;
+				bool all_met = true;
+
+				// ACT
+				p.run(3, [&] (unsigned) {
+					unique_lock<mutex> l(mtx);
+
+					++arrived;
+					cv.notify_all();
+					all_met &= cv.wait_for(l, chrono::seconds(10), [&] {	return arrived == 3;	});
+				});
+
+				// ASSERT
+				assert_is_true(all_met);
+			}
+
+
+			test( ExceptionFromJobIsRethrownAfterAllJobsComplete )
+			{
+				// INIT
+				draw_pool p(2);
+				mutex mtx;
+				unsigned completed = 0;
+				const auto job = [&] (unsigned index) {
+					if (index == 1)
+						throw runtime_error("failed");
+
+					lock_guard<mutex> l(mtx);
+
+					++completed;
+				};
+
+				// ACT / ASSERT
+				assert_throws(p.run(5, job), runtime_error);
+
+				// ASSERT
+				assert_equal(4u, completed);
+
+				// ACT (the pool remains usable)
+				p.run(2, [&] (unsigned) {
+					lock_guard<mutex> l(mtx);
+
+					++completed;
+				});
+
+				// ASSERT
+				assert_equal(6u, completed);
+			}
+		end_test_suite
+	}
+}
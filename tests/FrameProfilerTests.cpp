@@ -0,0 +1,177 @@
+#include <wpl/frame_profiler.h>
+
+#include <thread>
+#include <ut/assert.h>
+#include <ut/test.h>
+
+using namespace std;
+
+namespace wpl
+{
+	namespace tests
+	{
+		namespace
+		{
+			void add_frame(frame_profiler &p, double view_time = 0.0)
+			{
+				p.begin_frame();
+				p.view_drawn(0, view_time);
+				p.end_frame();
+			}
+		}
+
+		begin_test_suite( FrameProfilerTests )
+			test( FrameRecordsViewTimesCountersAndInvalidations )
+			{
+				// INIT
+				frame_profiler p;
+				vector<frame_record> log;
+				auto c = p.frame_completed += [&] (const frame_record &f) {	log.push_back(f);	};
+
+				p.invalidated();
+				p.invalidated();
+				p.layout_done(0.25);
+				p.layout_done(0.5);
+
+				// ACT
+				p.begin_frame();
+				p.view_drawn(3, 0.125);
+				p.view_drawn(1, 0.5);
+				p.get_counters().calls += 7;
+				p.get_counters().area += 1000;
+				this_thread::sleep_for(chrono::milliseconds(2));
+				p.end_frame();
+
+				// ASSERT
+				assert_equal(1u, log.size());
+				assert_equal(2u, log[0].invalidations);
+				assert_equal(0.75, log[0].layout_time);
+				assert_equal(7u, log[0].render_calls);
+				assert_equal(1000u, log[0].rasterized_area);
+				assert_is_true(log[0].draw_time >= 0.002);
+				assert_equal(2u, log[0].views.size());
+				assert_equal(3u, log[0].views[0].index);
+				assert_equal(0.125, log[0].views[0].draw_time);
+				assert_equal(1u, log[0].views[1].index);
+				assert_equal(0.5, log[0].views[1].draw_time);
+				assert_equal(7u, p.last_frame().render_calls);
+
+				// ACT
+				p.begin_frame();
+				p.end_frame();
+
+				// ASSERT
+				assert_equal(2u, log.size());
+				assert_equal(0u, log[1].invalidations);
+				assert_equal(0.0, log[1].layout_time);
+				assert_equal(0u, log[1].render_calls);
+				assert_equal(0u, log[1].rasterized_area);
+				assert_is_true(log[1].views.empty());
+			}
+
+
+			test( HistoryIsLimitedToTheLatestFrames )
+			{
+				// INIT
+				frame_profiler p(3);
+
+				// ACT
+				for (auto i = 0; i != 5; ++i)
+					p.invalidated(), add_frame(p);
+
+				// ASSERT
+				assert_equal(3u, p.get_history().size());
+			}
+
+
+			test( PercentilesAreTakenOverDrawTimesInHistory )
+			{
+				// INIT
+				frame_profiler p(100);
+
+				assert_equal(0.0, p.percentile(0.5));
+
+				for (auto i = 0; i != 10; ++i)
+					add_frame(p);
+
+				// ACT / ASSERT
+				assert_is_true(p.percentile(0.0) <= p.percentile(0.5));
+				assert_is_true(p.percentile(0.5) <= p.percentile(0.95));
+				assert_is_true(p.percentile(0.95) <= p.percentile(1.0));
+				for (auto i = p.get_history().begin(); i != p.get_history().end(); ++i)
+					assert_is_true(i->draw_time <= p.percentile(1.0));
+			}
+
+
+			test( HistogramPutsLongFramesIntoTheLastBucket )
+			{
+				// INIT
+				frame_profiler p;
+
+				add_frame(p);
+				add_frame(p);
+
+				// ACT
+				const auto h1 = p.histogram(1000.0, 3);
+				const auto h2 = p.histogram(1e-12, 2);
+
+				// ASSERT
+				unsigned reference1[] = {	2, 0, 0,	};
+				unsigned reference2[] = {	0, 2,	};
+
+				assert_equal(reference1, h1);
+				assert_equal(reference2, h2);
+			}
+
+
+			test( SlowestViewsAreRankedByTheirWorstDrawTime )
+			{
+				// INIT
+				frame_profiler p;
+
+				p.begin_frame();
+				p.view_drawn(1, 0.1);
+				p.view_drawn(2, 0.3);
+				p.view_drawn(3, 0.2);
+				p.end_frame();
+				p.begin_frame();
+				p.view_drawn(1, 0.5);
+				p.view_drawn(3, 0.1);
+				p.end_frame();
+
+				// ACT
+				const auto v = p.slowest_views(2);
+
+				// ASSERT
+				assert_equal(2u, v.size());
+				assert_equal(1u, v[0].index);
+				assert_equal(0.5, v[0].draw_time);
+				assert_equal(2u, v[1].index);
+				assert_equal(0.3, v[1].draw_time);
+			}
+
+
+			test( AllViewsSeenAreReturnedWhenFewerThanRequested )
+			{
+				// INIT
+				frame_profiler p;
+
+				p.begin_frame();
+				p.view_drawn(7, 0.1);
+				p.view_drawn(4, 0.2);
+				p.view_drawn(7, 0.3);
+				p.end_frame();
+
+				// ACT
+				const auto v = p.slowest_views(5);
+
+				// ASSERT
+				assert_equal(2u, v.size());
+				assert_equal(7u, v[0].index);
+				assert_equal(0.3, v[0].draw_time);
+				assert_equal(4u, v[1].index);
+				assert_equal(0.2, v[1].draw_time);
+			}
+		end_test_suite
+	}
+}
@@ -0,0 +1,334 @@
+#include <wpl/frame_scheduler.h>
+
+#include <tests/common/mock-queue.h>
+
+#include <ut/assert.h>
+#include <ut/test.h>
+
+using namespace std;
+
+namespace wpl
+{
+	namespace tests
+	{
+		begin_test_suite( FrameSchedulerTests )
+			clock clock_;
+			queue queue_;
+
+			timestamp time;
+			mocks::queue_container queued;
+
+			init( Init )
+			{
+				time = 1000;
+				clock_ = [this] { return this->time; };
+				queue_ = mocks::create_queue(queued);
+			}
+
+
+			void run_queued()
+			{
+				auto t = queued.front();
+
+				queued.pop();
+				t.task();
+			}
+
+
+			test( FrameRequestsAreCoalescedIntoASingleFrame )
+			{
+				// INIT
+				auto frames = 0;
+				frame_scheduler s(clock_, queue_);
+				auto c = s.frame += [&] {	frames++;	};
+
+				// ACT
+				s.request_frame();
+				s.request_frame();
+				s.request_frame();
+
+				// ASSERT
+				assert_equal(1u, queued.size());
+				assert_equal(0, queued.front().defer_by);
+				assert_equal(0, frames);
+
+				// ACT
+				run_queued();
+
+				// ASSERT
+				assert_equal(1, frames);
+				assert_is_true(queued.empty());
+				assert_equal(1u, s.get_statistics().frames);
+			}
+
+
+			test( NextFrameIsPacedByTargetRate )
+			{
+				// INIT
+				auto frames = 0;
+				frame_scheduler s(clock_, queue_, 50);
+				auto c = s.frame += [&] {	frames++;	};
+
+				s.request_frame();
+				run_queued();
+				time += 5;
+
+				// ACT
+				s.request_frame();
+
+				// ASSERT
+				assert_equal(1u, queued.size());
+				assert_equal(15, queued.front().defer_by);
+
+				// INIT
+				time += 15;
+
+				// ACT
+				run_queued();
+
+				// ASSERT
+				assert_equal(2, frames);
+
+				// INIT
+				s.set_rate(10);
+				time += 40;
+
+				// ACT
+				s.request_frame();
+				run_queued();
+				time += 1;
+				s.request_frame();
+
+				// ASSERT
+				assert_equal(99, queued.front().defer_by);
+			}
+
+
+			test( FrameIsRequestedFromWithinFrameHandlerForTheNextFrame )
+			{
+				// INIT
+				auto frames = 0;
+				frame_scheduler s(clock_, queue_, 100);
+				auto c = s.frame += [&] {
+					if (++frames < 3)
+						s.request_frame();
+				};
+
+				s.request_frame();
+
+				// ACT
+				run_queued();
+
+				// ASSERT
+				assert_equal(1, frames);
+				assert_equal(1u, queued.size());
+				assert_equal(10, queued.front().defer_by);
+
+				// ACT
+				time += 10;
+				run_queued();
+				time += 10;
+				run_queued();
+
+				// ASSERT
+				assert_equal(3, frames);
+				assert_is_true(queued.empty());
+			}
+
+
+			test( DeferredTasksRunOnFrameTicksBeforeFrameIsEmitted )
+			{
+				// INIT
+				vector<int> log;
+				frame_scheduler s(clock_, queue_, 50);
+				auto c = s.frame += [&] {	log.push_back(0);	};
+
+				// ACT
+				s.defer([&] {	log.push_back(1), s.request_frame();	}, 7);
+				s.defer([&] {	log.push_back(2);	}, 3);
+
+				// ASSERT
+				assert_equal(2u, queued.size());
+				assert_equal(3, queued.back().defer_by);
+
+				// ACT
+				time += 3;
+				run_queued(); // Stale tick.
+				run_queued();
+
+				// ASSERT
+				int reference1[] = {	2,	};
+
+				assert_equal(reference1, log);
+				assert_equal(1u, queued.size());
+				assert_equal(20, queued.front().defer_by);
+
+				// ACT
+				time += 20;
+				run_queued();
+
+				// ASSERT
+				int reference2[] = {	2, 1, 0,	};
+
+				assert_equal(reference2, log);
+			}
+
+
+			test( QueueAdapterDefersTasksToFrames )
+			{
+				// INIT
+				auto called = 0;
+				frame_scheduler s(clock_, queue_);
+				auto q = s.get_queue();
+
+				// ACT
+				assert_is_true(q([&] {	called++;	}, 10));
+
+				// ASSERT
+				assert_equal(1u, queued.size());
+				assert_equal(10, queued.front().defer_by);
+				assert_equal(0, called);
+
+				// ACT
+				time += 10;
+				run_queued();
+
+				// ASSERT
+				assert_equal(1, called);
+			}
+
+
+			test( EarlierRequestOverridesPendingLaterTick )
+			{
+				// INIT
+				auto frames = 0, called = 0;
+				frame_scheduler s(clock_, queue_);
+				auto c = s.frame += [&] {	frames++;	};
+
+				s.defer([&] {	called++;	}, 100);
+
+				// ACT
+				s.request_frame();
+
+				// ASSERT
+				assert_equal(2u, queued.size());
+				assert_equal(0, queued.back().defer_by);
+
+				// ACT
+				run_queued(); // Stale tick.
+
+				// ASSERT
+				assert_equal(0, frames);
+
+				// ACT
+				run_queued();
+
+				// ASSERT
+				assert_equal(1, frames);
+				assert_equal(0, called);
+				assert_equal(1u, queued.size());
+				assert_equal(100, queued.front().defer_by);
+			}
+
+
+			test( IdleTasksRunOnlyWithinRemainingFrameBudget )
+			{
+				// INIT
+				vector<int> log;
+				frame_scheduler s(clock_, queue_, 100);
+				auto c = s.frame += [&] {	log.push_back(0), time += 4;	};
+
+				s.request_frame();
+				s.idle([&] {	log.push_back(1), time += 5;	});
+				s.idle([&] {	log.push_back(2), time += 5;	});
+				s.idle([&] {	log.push_back(3);	});
+
+				// ACT
+				run_queued();
+
+				// ASSERT
+				int reference1[] = {	0, 1, 2,	};
+
+				assert_equal(reference1, log);
+				assert_equal(1u, queued.size());
+
+				// ACT
+				run_queued();
+
+				// ASSERT
+				int reference2[] = {	0, 1, 2, 3,	};
+
+				assert_equal(reference2, log);
+				assert_is_true(queued.empty());
+			}
+
+
+			test( LateFramesAreAccountedAsDropped )
+			{
+				// INIT
+				frame_scheduler s(clock_, queue_, 100);
+				auto c = s.frame += [&] {	time += 25;	};
+
+				s.request_frame();
+
+				// ACT
+				run_queued();
+
+				// ASSERT
+				assert_equal(0u, s.get_statistics().dropped_frames);
+				assert_equal(25, s.get_statistics().longest_frame);
+
+				// INIT
+				s.request_frame();
+
+				// ACT
+				time += 1;
+				run_queued();
+
+				// ASSERT
+				assert_equal(2u, s.get_statistics().frames);
+				assert_equal(0u, s.get_statistics().dropped_frames);
+
+				// INIT
+				s.request_frame();
+
+				// ACT
+				time += 32;
+				run_queued();
+
+				// ASSERT
+				assert_equal(3u, s.get_statistics().frames);
+				assert_equal(3u, s.get_statistics().dropped_frames);
+
+				// ACT
+				s.reset_statistics();
+
+				// ASSERT
+				assert_equal(0u, s.get_statistics().frames);
+				assert_equal(0u, s.get_statistics().dropped_frames);
+				assert_equal(0, s.get_statistics().longest_frame);
+			}
+
+
+			test( PendingTicksAreIgnoredAfterSchedulerIsDestroyed )
+			{
+				// INIT
+				auto frames = 0;
+				unique_ptr<frame_scheduler> s(new frame_scheduler(clock_, queue_));
+				auto c = s->frame += [&] {	frames++;	};
+				auto q = s->get_queue();
+
+				s->request_frame();
+
+				// ACT
+				c.reset();
+				s.reset();
+				run_queued();
+
+				// ASSERT
+				assert_equal(0, frames);
+				assert_is_false(q([] {}, 0));
+			}
+		end_test_suite
+	}
+}
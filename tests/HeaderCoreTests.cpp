@@ -494,12 +494,112 @@ namespace wpl
 					default:	throw 0;
 					}
 				};
+				m->invalidate(headers_model::npos());
 
 				// ACT / ASSERT
 				assert_equal(21, static_cast<const control &>(hdr).min_height());
 			}
 
 
+			test( MinimumHeightIsMeasuredOnceUntilLayoutChanges )
+			{
+				// INIT
+				tracking_header hdr(cursor_manager_);
+				const control &as_control = hdr;
+				column_t c[] = {	{	"", 17	}, {	"", 13	},	};
+				const auto m = mocks::headers_model::create(c, headers_model::npos(), true);
+				auto measured = 0;
+
+				resize(hdr, 1000, 33);
+				hdr.set_model(m);
+				hdr.on_measure_item = [&] (const headers_model &, headers_model::index_type) -> agge::box<int> {
+					return measured++, agge::create_box(10, 5);
+				};
+
+				// ACT / ASSERT
+				assert_equal(5, as_control.min_height());
+				assert_equal(5, as_control.min_height(100));
+				assert_equal(5, as_control.min_height());
+
+				// ASSERT
+				assert_equal(2, measured);
+
+				// ACT
+				hdr.layout_changed(false);
+
+				// ACT / ASSERT
+				assert_equal(5, as_control.min_height());
+				assert_equal(5, as_control.min_height());
+
+				// ASSERT
+				assert_equal(4, measured);
+			}
+
+
+			test( LayoutChangeIsSignalledWhenMeasuredMinimumHeightChanges )
+			{
+				// INIT
+				tracking_header hdr(cursor_manager_);
+				const control &as_control = hdr;
+				column_t c[] = {	{	"", 17	}, {	"", 13	},	};
+				const auto m = mocks::headers_model::create(c, headers_model::npos(), true);
+				auto h = 5;
+				vector<bool> log;
+				const auto conn = hdr.layout_changed += [&] (bool hierarchy_changed) {
+					log.push_back(hierarchy_changed);
+				};
+
+				resize(hdr, 1000, 33);
+				hdr.set_model(m);
+				hdr.on_measure_item = [&] (const headers_model &, headers_model::index_type) -> agge::box<int> {
+					return agge::create_box(10, h);
+				};
+				h = 7;
+
+				// ACT
+				m->invalidate(headers_model::npos());
+
+				// ASSERT
+				assert_is_empty(log); // Nobody has measured the height yet.
+
+				// INIT
+				as_control.min_height();
+
+				// ACT
+				m->invalidate(0);
+
+				// ASSERT
+				assert_is_empty(log);
+
+				// INIT
+				h = 11;
+
+				// ACT
+				m->invalidate(1);
+
+				// ASSERT
+				bool reference1[] = {	false,	};
+
+				assert_equal(reference1, log);
+				assert_equal(11, as_control.min_height());
+
+				// ACT
+				hdr.set_model(mocks::headers_model::create(c, headers_model::npos(), true));
+
+				// ASSERT
+				assert_equal(reference1, log);
+
+				// ACT
+				hdr.set_model(mocks::headers_model::create());
+
+				// ASSERT
+				bool reference2[] = {	false, false,	};
+
+				assert_equal(reference2, log);
+				assert_equal(0, as_control.min_height());
+			}
+
+
 			test( MouseIsCapturedOnStartingWidthUpdate )
 			{
 				// INIT
@@ -0,0 +1,181 @@
+#include <wpl/layer_cache.h>
+
+#include <ut/assert.h>
+#include <ut/test.h>
+
+using namespace std;
+
+namespace wpl
+{
+	namespace tests
+	{
+		namespace
+		{
+			const size_t c_pixel = sizeof(gcontext::pixel_type);
+		}
+
+		begin_test_suite( LayerCacheTests )
+			int keys[10];
+
+			test( NothingIsFoundInEmptyCache )
+			{
+				// INIT
+				layer_cache c(1000);
+
+				// ACT / ASSERT
+				assert_null(c.find(&keys[0], 3, 4));
+				assert_equal(0u, c.size());
+			}
+
+
+			test( AcquiredLayerIsOfRequestedSizeAndIsFoundLater )
+			{
+				// INIT
+				layer_cache c(1000);
+
+				// ACT
+				auto l1 = c.acquire(&keys[0], 3, 4);
+				auto l2 = c.acquire(&keys[1], 7, 5);
+
+				// ASSERT
+				assert_not_null(l1);
+				assert_equal(3u, l1->width());
+				assert_equal(4u, l1->height());
+				assert_not_null(l2);
+				assert_equal(7u, l2->width());
+				assert_equal(5u, l2->height());
+				assert_equal(47u * c_pixel, c.size());
+
+				// ACT / ASSERT
+				assert_equal(l1, c.find(&keys[0], 3, 4));
+				assert_equal(l2, c.find(&keys[1], 7, 5));
+				assert_null(c.find(&keys[2], 7, 5));
+			}
+
+
+			test( AcquiredLayerIsCleared )
+			{
+				// INIT
+				layer_cache c(1000);
+				auto l = c.acquire(&keys[0], 3, 2);
+
+				l->row_ptr(1)[2].components[0] = 17;
+				c.invalidate(&keys[0]);
+
+				// ACT
+				l = c.acquire(&keys[0], 3, 2);
+
+				// ASSERT
+				assert_equal(0u, l->row_ptr(1)[2].components[0]);
+			}
+
+
+			test( LayerIsNotFoundForMismatchingSize )
+			{
+				// INIT
+				layer_cache c(1000);
+
+				c.acquire(&keys[0], 3, 4);
+
+				// ACT / ASSERT
+				assert_null(c.find(&keys[0], 4, 4));
+				assert_null(c.find(&keys[0], 3, 5));
+
+				// ACT
+				c.acquire(&keys[0], 10, 2);
+
+				// ASSERT
+				assert_not_null(c.find(&keys[0], 10, 2));
+				assert_equal(20u * c_pixel, c.size());
+			}
+
+
+			test( InvalidatedLayerIsNotFound )
+			{
+				// INIT
+				layer_cache c(1000);
+
+				c.acquire(&keys[0], 3, 4);
+				c.acquire(&keys[1], 3, 4);
+
+				// ACT
+				c.invalidate(&keys[1]);
+				c.invalidate(&keys[2]);
+
+				// ASSERT
+				assert_not_null(c.find(&keys[0], 3, 4));
+				assert_null(c.find(&keys[1], 3, 4));
+				assert_equal(24u * c_pixel, c.size());
+			}
+
+
+			test( LeastRecentlyUsedLayersAreEvictedWhenBudgetIsExceeded )
+			{
+				// INIT
+				layer_cache c(30 * c_pixel);
+
+				c.acquire(&keys[0], 10, 1);
+				c.acquire(&keys[1], 10, 1);
+				c.acquire(&keys[2], 10, 1);
+				c.find(&keys[0], 10, 1);
+
+				// ACT
+				c.acquire(&keys[3], 5, 2);
+
+				// ASSERT
+				assert_not_null(c.find(&keys[0], 10, 1));
+				assert_null(c.find(&keys[1], 10, 1));
+				assert_not_null(c.find(&keys[2], 10, 1));
+				assert_not_null(c.find(&keys[3], 5, 2));
+				assert_equal(30u * c_pixel, c.size());
+
+				// ACT
+				c.acquire(&keys[4], 20, 1);
+
+				// ASSERT
+				assert_null(c.find(&keys[0], 10, 1));
+				assert_null(c.find(&keys[2], 10, 1));
+				assert_not_null(c.find(&keys[3], 5, 2));
+				assert_not_null(c.find(&keys[4], 20, 1));
+				assert_equal(30u * c_pixel, c.size());
+			}
+
+
+			test( LayersExceedingBudgetAreNotAcquired )
+			{
+				// INIT
+				layer_cache c(30 * c_pixel);
+
+				c.acquire(&keys[0], 10, 1);
+				c.acquire(&keys[1], 10, 1);
+
+				// ACT / ASSERT
+				assert_null(c.acquire(&keys[2], 31, 1));
+				assert_null(c.acquire(&keys[1], 4, 8));
+
+				// ASSERT
+				assert_not_null(c.find(&keys[0], 10, 1));
+				assert_null(c.find(&keys[1], 10, 1));
+				assert_equal(10u * c_pixel, c.size());
+			}
+
+
+			test( ClearingCacheReleasesAllLayers )
+			{
+				// INIT
+				layer_cache c(1000);
+
+				c.acquire(&keys[0], 3, 4);
+				c.acquire(&keys[1], 3, 4);
+
+				// ACT
+				c.clear();
+
+				// ASSERT
+				assert_null(c.find(&keys[0], 3, 4));
+				assert_null(c.find(&keys[1], 3, 4));
+				assert_equal(0u, c.size());
+			}
+		end_test_suite
+	}
+}
@@ -1022,6 +1022,162 @@ namespace wpl
 			}
 
 
+			test( RangeInvalidationInvalidatesVisibleRowsOnly )
+			{
+				// INIT
+				tracking_listview lv;
+				const auto m = create_model(1000, 1);
+				vector<agge::rect_i> log;
+
+				lv.item_height = 10;
+				resize(lv, 100, 40);
+				lv.set_columns_model(mocks::headers_model::create("", 100));
+				lv.set_model(m);
+
+				const auto c = lv.invalidate += [&] (const agge::rect_i *r) {
+					assert_not_null(r);
+					log.push_back(*r);
+				};
+
+				// ACT
+				m->invalidate_range(1, 2);
+
+				// ASSERT
+				agge::rect_i reference1[] = {	create_rect(0, 10, 100, 30),	};
+
+				assert_equal(reference1, log);
+
+				// ACT
+				m->invalidate_range(0, 1);
+				m->invalidate_range(3, 5);
+
+				// ASSERT
+				agge::rect_i reference2[] = {
+					create_rect(0, 10, 100, 30), create_rect(0, 0, 100, 10), create_rect(0, 30, 100, 40),
+				};
+
+				assert_equal(reference2, log);
+
+				// INIT
+				lv.item_height = 7;
+				resize(lv, 113, 30);
+				lv.get_vscroll_model()->set_window(10.5, 0);
+				log.clear();
+
+				// ACT
+				m->invalidate_range(7, 4);
+				m->invalidate_range(12, 1);
+				m->invalidate_range(14, table_model_base::npos());
+
+				// ASSERT
+				agge::rect_i reference3[] = {
+					create_rect(0, 0, 113, 4), create_rect(0, 10, 113, 18), create_rect(0, 24, 113, 30),
+				};
+
+				assert_equal(reference3, log);
+			}
+
+
+			test( RowInvalidationInvalidatesTheRowOnlyIfVisible )
+			{
+				// INIT
+				tracking_listview lv;
+				const auto m = create_model(1000, 1);
+				vector<agge::rect_i> log;
+
+				lv.item_height = 10;
+				resize(lv, 100, 40);
+				lv.set_columns_model(mocks::headers_model::create("", 100));
+				lv.set_model(m);
+
+				const auto c = lv.invalidate += [&] (const agge::rect_i *r) {
+					assert_not_null(r);
+					log.push_back(*r);
+				};
+
+				// ACT
+				m->invalidate(2);
+				m->invalidate(0);
+				m->invalidate(4);
+				m->invalidate(999);
+
+				// ASSERT
+				agge::rect_i reference[] = {	create_rect(0, 20, 100, 30), create_rect(0, 0, 100, 10),	};
+
+				assert_equal(reference, log);
+			}
+
+
+			test( InvalidationOfOffscreenRangesDoesNotInvalidateView )
+			{
+				// INIT
+				tracking_listview lv;
+				const auto m = create_model(1000, 1);
+				auto invalidations = 0;
+
+				lv.item_height = 10;
+				resize(lv, 100, 40);
+				lv.set_columns_model(mocks::headers_model::create("", 100));
+				lv.set_model(m);
+				lv.get_vscroll_model()->set_window(100, 0);
+
+				const auto c = lv.invalidate += [&] (const agge::rect_i *) {	invalidations++;	};
+
+				// ACT
+				m->invalidate_range(0, 100);
+				m->invalidate_range(104, 10);
+				m->invalidate_range(990, table_model_base::npos());
+				m->invalidate_range(1000, 10);
+				m->invalidate_range(50, 0);
+
+				// ASSERT
+				assert_equal(0, invalidations);
+
+				// INIT
+				lv.set_model(shared_ptr<richtext_table_model>());
+				lv.get_vscroll_model()->set_window(0, 0);
+				invalidations = 0;
+
+				// ACT
+				m->invalidate_range(0, 1);
+
+				// ASSERT
+				assert_equal(0, invalidations);
+			}
+
+
+			test( RangeInvalidationInvalidatesEverythingOnCountChange )
+			{
+				// INIT
+				tracking_listview lv;
+				const auto m = create_model(1000, 1);
+				auto invalidations = 0;
+
+				lv.item_height = 10;
+				resize(lv, 100, 40);
+				lv.set_columns_model(mocks::headers_model::create("", 100));
+				lv.set_model(m);
+
+				const auto c = lv.invalidate += [&] (const agge::rect_i *r) {
+					assert_null(r);
+					invalidations++;
+				};
+
+				// ACT
+				m->items.resize(1500);
+				m->invalidate_range(2, 1);
+
+				// ASSERT
+				assert_equal(1, invalidations);
+
+				// ACT
+				m->invalidate_range(table_model_base::npos(), 1);
+
+				// ASSERT
+				assert_equal(2, invalidations);
+			}
+
+
 			test( VerticalScrollModelRangeIsInvalidatedOnlyWhenModelCountChanges )
 			{
 				// INIT
@@ -1132,6 +1288,7 @@ namespace wpl
 				// INIT
 				auto invalidations = 0;
 				auto scroll_invalidations = 0;
+				vector< pair<int, int> > scrolls;
 				tracking_listview lv;
 				const auto sm = lv.get_vscroll_model();
 
@@ -1146,6 +1303,7 @@ namespace wpl
 					scroll_invalidations++;
 					assert_is_false(invalidate_range);
 				};
+				const auto c3 = lv.scroll += [&] (int dx, int dy) {	scrolls.push_back(make_pair(dx, dy));	};
 
 				// ACT
 				lv.make_visible(31);
@@ -1176,7 +1334,9 @@ namespace wpl
 
 				// ASSERT
 				assert_equal(4, scroll_invalidations);
-				assert_equal(4, invalidations);
+				assert_equal(3, invalidations);
+				assert_equal(1u, scrolls.size());
+				assert_equal(make_pair(0, 7), scrolls.back());
 				assert_approx_equal(33.0, sm->get_window().first, 0.001);
 			}
 
@@ -1347,6 +1507,7 @@ namespace wpl
 				// INIT
 				auto invalidations = 0;
 				auto sinvalidations = 0;
+				vector< pair<int, int> > scrolls;
 				tracking_listview lv;
 				const auto sm = lv.get_hscroll_model();
 				column_t columns[] = {
@@ -1366,14 +1527,17 @@ namespace wpl
 					sinvalidations++;
 					assert_is_false(invalidate_range);
 				};
+				const auto c3 = lv.scroll += [&] (int dx, int dy) {	scrolls.push_back(make_pair(dx, dy));	};
 
 				// ACT
 				sm->set_window(10, 101);
 
 				// ACT / ASSERT
 				assert_equal_pred(make_pair(10, 101), sm->get_window(), eq());
-				assert_equal(1, invalidations);
+				assert_equal(0, invalidations);
 				assert_equal(1, sinvalidations);
+				assert_equal(1u, scrolls.size());
+				assert_equal(make_pair(-10, 0), scrolls.back());
 
 				// ACT
 				sm->set_window(71.37, 101);
@@ -1386,8 +1550,9 @@ namespace wpl
 
 				// ACT / ASSERT
 				assert_equal_pred(make_pair(-50, 101), sm->get_window(), eq());
-				assert_equal(3, invalidations);
+				assert_equal(2, invalidations);
 				assert_equal(3, sinvalidations);
+				assert_equal(1u, scrolls.size());
 			}
 
 
@@ -0,0 +1,314 @@
+#include <wpl/marshalled_signal.h>
+
+#include <tests/common/mock-queue.h>
+
+#include <algorithm>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <ut/assert.h>
+#include <ut/test.h>
+
+using namespace std;
+
+namespace wpl
+{
+	namespace tests
+	{
+		begin_test_suite( MarshalledSignalTests )
+			queue queue_;
+			mocks::queue_container queued;
+
+			init( Init )
+			{
+				queue_ = mocks::create_queue(queued);
+			}
+
+
+			test( PostedNotificationsAreDeliveredFromQueueOnly )
+			{
+				// INIT
+				marshalled_signal<void (int)> s(queue_);
+				vector<int> log;
+				auto c = s += [&] (int v) {	log.push_back(v);	};
+
+				// ACT
+				s.post(17);
+
+				// ASSERT
+				assert_is_empty(log);
+				assert_equal(1u, queued.size());
+				assert_equal(0, queued.front().defer_by);
+
+				// ACT
+				queued.front().task();
+
+				// ASSERT
+				int reference[] = {	17,	};
+
+				assert_equal(reference, log);
+			}
+
+
+			test( DuplicatePendingNotificationsAreCoalescedIntoASingleBatch )
+			{
+				// INIT
+				marshalled_signal<void (unsigned)> s(queue_);
+				vector<unsigned> log;
+				auto c = s += [&] (unsigned v) {	log.push_back(v);	};
+
+				// ACT
+				s.post(static_cast<unsigned>(-1));
+				s.post(static_cast<unsigned>(-1));
+				s.post(3);
+				s.post(static_cast<unsigned>(-1));
+				s.post(3);
+				s.post(1);
+
+				// ASSERT
+				assert_equal(1u, queued.size());
+
+				// ACT
+				queued.front().task();
+
+				// ASSERT
+				unsigned reference[] = {	static_cast<unsigned>(-1), 3, 1,	};
+
+				assert_equal(reference, log);
+			}
+
+
+			test( AbsorbingNotificationReplacesPendingOnesUntilDelivery )
+			{
+				// INIT
+				marshalled_signal<void (unsigned)> s(queue_, static_cast<unsigned>(-1));
+				vector<unsigned> log;
+				auto c = s += [&] (unsigned v) {	log.push_back(v);	};
+
+				// ACT
+				s.post(3);
+				s.post(1);
+				s.post(static_cast<unsigned>(-1));
+				s.post(4);
+				s.post(static_cast<unsigned>(-1));
+				queued.front().task();
+
+				// ASSERT
+				unsigned reference1[] = {	static_cast<unsigned>(-1),	};
+
+				assert_equal(reference1, log);
+
+				// INIT
+				log.clear();
+
+				// ACT
+				s.post(4);
+				s.post(3);
+				s.post(4);
+				queued.back().task();
+
+				// ASSERT
+				unsigned reference2[] = {	4, 3,	};
+
+				assert_equal(2u, queued.size());
+				assert_equal(reference2, log);
+			}
+
+
+			test( ArgumentlessNotificationsAreCoalesced )
+			{
+				// INIT
+				marshalled_signal<void ()> s(queue_);
+				auto called = 0;
+				auto c = s += [&] {	called++;	};
+
+				// ACT
+				s.post();
+				s.post();
+				s.post();
+				queued.front().task();
+
+				// ASSERT
+				assert_equal(1u, queued.size());
+				assert_equal(1, called);
+			}
+
+
+			test( AllArgumentsAreComparedForCoalescing )
+			{
+				// INIT
+				marshalled_signal<void (int, const string &)> s(queue_);
+				vector< pair<int, string> > log;
+				auto c = s += [&] (int v, const string &text) {	log.push_back(make_pair(v, text));	};
+
+				// ACT
+				s.post(1, "lorem");
+				s.post(1, "ipsum");
+				s.post(2, "lorem");
+				s.post(1, "lorem");
+				queued.front().task();
+
+				// ASSERT
+				pair<int, string> reference[] = {
+					make_pair(1, "lorem"), make_pair(1, "ipsum"), make_pair(2, "lorem"),
+				};
+
+				assert_equal(1u, queued.size());
+				assert_equal(reference, log);
+			}
+
+
+			test( NotificationsPostedAfterDeliveryAreScheduledAgain )
+			{
+				// INIT
+				marshalled_signal<void (int)> s(queue_);
+				vector<int> log;
+				auto c = s += [&] (int v) {	log.push_back(v);	};
+
+				s.post(1);
+				queued.front().task();
+				queued.pop();
+
+				// ACT
+				s.post(1);
+				s.post(2);
+
+				// ASSERT
+				assert_equal(1u, queued.size());
+
+				// ACT
+				queued.front().task();
+
+				// ASSERT
+				int reference[] = {	1, 1, 2,	};
+
+				assert_equal(reference, log);
+			}
+
+
+			test( NotificationsPostedDuringDeliveryGoToTheNextBatch )
+			{
+				// INIT
+				marshalled_signal<void (int)> s(queue_);
+				vector<int> log;
+				auto c = s += [&] (int v) {
+					log.push_back(v);
+					if (v < 3)
+						s.post(v + 1);
+				};
+
+				s.post(1);
+
+				// ACT
+				queued.front().task();
+
+				// ASSERT
+				int reference1[] = {	1,	};
+
+				assert_equal(reference1, log);
+				assert_equal(2u, queued.size());
+
+				// ACT
+				queued.pop();
+				queued.front().task();
+
+				// ASSERT
+				int reference2[] = {	1, 2,	};
+
+				assert_equal(reference2, log);
+			}
+
+
+			test( PendingNotificationsAreNotDeliveredAfterSignalDestruction )
+			{
+				// INIT
+				unique_ptr< marshalled_signal<void (int)> > s(new marshalled_signal<void (int)>(queue_));
+				auto called = 0;
+				auto c = *s += [&] (int) {	called++;	};
+
+				s->post(1);
+
+				// ACT
+				s.reset();
+				queued.front().task();
+
+				// ASSERT
+				assert_equal(0, called);
+			}
+
+
+			test( SchedulingIsRetriedIfQueueRejectsTheTask )
+			{
+				// INIT
+				auto accept = false;
+				auto attempts = 0;
+				marshalled_signal<void (int)> s([&] (const queue_task &task, timespan defer_by) -> bool {
+					attempts++;
+					return accept ? queue_(task, defer_by) : false;
+				});
+				vector<int> log;
+				auto c = s += [&] (int v) {	log.push_back(v);	};
+
+				// ACT
+				s.post(1);
+				s.post(2);
+
+				// ASSERT
+				assert_equal(2, attempts);
+				assert_equal(0u, queued.size());
+
+				// INIT
+				accept = true;
+
+				// ACT
+				s.post(3);
+				s.post(1);
+				queued.front().task();
+
+				// ASSERT
+				int reference[] = {	1, 2, 3,	};
+
+				assert_equal(3, attempts);
+				assert_equal(reference, log);
+			}
+
+
+			test( NotificationsFromMultipleThreadsAreDeliveredInASingleBatch )
+			{
+				// INIT
+				mutex mtx;
+				marshalled_signal<void (int)> s([&] (const queue_task &task, timespan defer_by) -> bool {
+					lock_guard<mutex> l(mtx);
+					return queue_(task, defer_by);
+				});
+				vector<int> log;
+				auto c = s += [&] (int v) {	log.push_back(v);	};
+				vector< shared_ptr<thread> > threads;
+
+				// ACT
+				for (auto t = 0; t != 4; ++t)
+				{
+					threads.push_back(make_shared<thread>([&s] {
+						for (auto i = 0; i != 1000; ++i)
+							s.post(i % 100);
+					}));
+				}
+				for (auto i = threads.begin(); i != threads.end(); ++i)
+					(*i)->join();
+
+				// ASSERT
+				assert_equal(1u, queued.size());
+
+				// ACT
+				queued.front().task();
+
+				// ASSERT
+				sort(log.begin(), log.end());
+
+				assert_equal(100u, log.size());
+				for (auto i = 0; i != 100; ++i)
+					assert_equal(i, log[i]);
+			}
+		end_test_suite
+	}
+}
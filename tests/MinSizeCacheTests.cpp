@@ -0,0 +1,97 @@
+#include <wpl/min_size_cache.h>
+
+#include <ut/assert.h>
+#include <ut/test.h>
+
+using namespace std;
+
+namespace wpl
+{
+	namespace tests
+	{
+		begin_test_suite( MinSizeCacheTests )
+			test( SizesAreMeasuredOncePerConstraint )
+			{
+				// INIT
+				signal<void (bool)> layout_changed;
+				min_size_cache c(layout_changed);
+				vector<int> log;
+
+				// ACT / ASSERT
+				assert_equal(10, c.height(100, [&] {	return log.push_back(100), 10;	}));
+				assert_equal(20, c.height(200, [&] {	return log.push_back(200), 20;	}));
+				assert_equal(10, c.height(100, [&] {	return log.push_back(-1), -1;	}));
+				assert_equal(20, c.height(200, [&] {	return log.push_back(-1), -1;	}));
+				assert_equal(30, c.width(100, [&] {	return log.push_back(1100), 30;	}));
+				assert_equal(30, c.width(100, [&] {	return log.push_back(-1), -1;	}));
+
+				// ASSERT
+				int reference[] = {	100, 200, 1100,	};
+
+				assert_equal(reference, log);
+			}
+
+
+			test( SizesAreRemeasuredAfterLayoutChange )
+			{
+				// INIT
+				signal<void (bool)> layout_changed;
+				min_size_cache c(layout_changed);
+
+				c.height(100, [] {	return 10;	});
+				c.width(100, [] {	return 20;	});
+
+				// ACT
+				layout_changed(false);
+
+				// ACT / ASSERT
+				assert_equal(11, c.height(100, [] {	return 11;	}));
+				assert_equal(21, c.width(100, [] {	return 21;	}));
+
+				// ACT
+				layout_changed(true);
+
+				// ACT / ASSERT
+				assert_equal(12, c.height(100, [] {	return 12;	}));
+				assert_equal(22, c.width(100, [] {	return 22;	}));
+			}
+
+
+			test( ClearingDropsAllSizes )
+			{
+				// INIT
+				signal<void (bool)> layout_changed;
+				min_size_cache c(layout_changed);
+
+				c.height(100, [] {	return 10;	});
+				c.width(100, [] {	return 20;	});
+
+				// ACT
+				c.clear();
+
+				// ACT / ASSERT
+				assert_equal(11, c.height(100, [] {	return 11;	}));
+				assert_equal(21, c.width(100, [] {	return 21;	}));
+			}
+
+
+			test( OldestConstraintsAreEvictedAboveCapacity )
+			{
+				// INIT
+				signal<void (bool)> layout_changed;
+				min_size_cache c(layout_changed, 2);
+
+				c.height(1, [] {	return 10;	});
+				c.height(2, [] {	return 20;	});
+
+				// ACT
+				c.height(3, [] {	return 30;	});
+
+				// ACT / ASSERT
+				assert_equal(20, c.height(2, [] {	return -1;	}));
+				assert_equal(30, c.height(3, [] {	return -1;	}));
+				assert_equal(11, c.height(1, [] {	return 11;	}));
+			}
+		end_test_suite
+	}
+}
@@ -4,6 +4,7 @@
 
 #include "common/helpers.h"
 
+#include <list>
 #include <ut/assert.h>
 #include <ut/test.h>
 
@@ -99,6 +99,49 @@ namespace wpl
 			}
 
 
+			test( ViewsAreLocatedByIndexAfterReloadAndReindexing )
+			{
+				// INIT
+				agge::point<int> pt;
+				auto point = [&pt] (int x, int y) -> agge::point<int> & {
+					pt.x = x, pt.y = y;
+					return pt;
+				};
+				mouse_router mr(views, mrhost);
+				shared_ptr<view> v[] = {	make_shared<view>(), make_shared<view>(), make_shared<view>(),	};
+				placed_view pv[] = {
+					{ v[0], nullptr_nv, { 0, 0, 200, 100 }	},
+					{ v[1], nullptr_nv, { 10, 10, 20, 20 }	},
+					{ v[2], nullptr_nv, { 15, 15, 30, 30 }	},
+				};
+
+				views.assign(begin(pv), end(pv));
+
+				// ACT
+				mr.reload_views();
+
+				// ACT / ASSERT
+				assert_equal(view_and_target(v[2], v[2].get()), mr.from(point(15, 15)));
+				assert_equal(create_point(0, 0), pt);
+				assert_equal(view_and_target(v[1], v[1].get()), mr.from(point(14, 15)));
+				assert_equal(create_point(4, 5), pt);
+				assert_equal(view_and_target(v[0], v[0].get()), mr.from(point(150, 50)));
+				assert_equal(create_point(150, 50), pt);
+				assert_null(mr.from(point(200, 50)));
+
+				// INIT
+				views[1].location = create_rect(100, 50, 120, 70);
+
+				// ACT
+				mr.reindex_views();
+
+				// ACT / ASSERT
+				assert_equal(view_and_target(v[0], v[0].get()), mr.from(point(14, 15)));
+				assert_equal(view_and_target(v[1], v[1].get()), mr.from(point(119, 69)));
+				assert_equal(create_point(19, 19), pt);
+			}
+
+
 			test( MouseEventsAreRedirectedWithOffset )
 			{
 				// INIT
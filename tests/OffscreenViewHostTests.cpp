@@ -0,0 +1,305 @@
+#include <wpl/offscreen/view_host.h>
+
+#include <tests/common/mock-queue.h>
+#include <tests/common/helpers.h>
+#include <tests/common/helpers-visual.h>
+#include <tests/common/mock-control.h>
+#include <tests/common/Mockups.h>
+#include <wpl/frame_scheduler.h>
+
+#include <ut/assert.h>
+#include <ut/test.h>
+
+using namespace agge;
+using namespace std;
+
+namespace wpl
+{
+	namespace tests
+	{
+		namespace
+		{
+			const auto nullptr_nv = shared_ptr<native_view>();
+
+			class painting_view : public view
+			{
+			public:
+				painting_view(color color_)
+					: fill(color_)
+				{	}
+
+			public:
+				color fill;
+
+			private:
+				virtual void draw(gcontext &ctx, gcontext::rasterizer_ptr &/*rasterizer*/) const override
+				{	rectangle(ctx, fill, 0, 0, 1000, 1000);	}
+			};
+		}
+
+		begin_test_suite( OffscreenViewHostTests )
+			form_context context;
+			shared_ptr<mocks::control> root;
+			color color_o, color_a, color_b;
+			gcontext::pixel_type o, a, b;
+
+			init( Init )
+			{
+				context.renderer = make_shared<gcontext::renderer_type>(1);
+				context.text_engine = create_faked_text_engine();
+				root = make_shared<mocks::control>();
+				o = make_pixel_real(color_o = color::make(0, 0, 0));
+				a = make_pixel_real(color_a = color::make(255, 0, 0));
+				b = make_pixel_real(color_b = color::make(0, 255, 0));
+			}
+
+
+			test( RootIsLaidOutToTheSizeOfHost )
+			{
+				// INIT
+				offscreen::view_host host(context, 100, 50);
+
+				// ACT
+				host.set_root(root);
+
+				// ASSERT
+				box<int> reference1[] = {	{	100, 50	},	};
+
+				assert_equal(reference1, root->size_log);
+
+				// ACT
+				host.resize(30, 20);
+
+				// ASSERT
+				box<int> reference2[] = {	{	100, 50	}, {	30, 20	},	};
+
+				assert_equal(reference2, root->size_log);
+				assert_equal(30u, host.get_surface().width());
+				assert_equal(20u, host.get_surface().height());
+			}
+
+
+			test( ViewsAreRenderedIntoSurface )
+			{
+				// INIT
+				offscreen::view_host host(context, 6, 4);
+				placed_view pv[] = {
+					{	make_shared< mocks::filling_visual<view> >(color_o), nullptr_nv, {	0, 0, 6, 4	},	},
+					{	make_shared< mocks::filling_visual<view> >(color_a), nullptr_nv, {	1, 1, 4, 3	},	},
+					{	make_shared< mocks::filling_visual<view> >(color_b), nullptr_nv, {	3, 2, 6, 4	},	},
+				};
+
+				root->views = mkvector(pv);
+				host.set_root(root);
+
+				// ACT
+				const auto rendered = host.render();
+
+				// ASSERT
+				const gcontext::pixel_type reference[] = {
+					o, o, o, o, o, o,
+					o, a, a, a, o, o,
+					o, a, a, b, b, b,
+					o, o, o, b, b, b,
+				};
+
+				assert_is_true(rendered);
+				assert_equal(reference, host.get_surface());
+
+				// ACT / ASSERT
+				assert_is_false(host.render());
+			}
+
+
+			test( OnlyInvalidatedAreasAreRendered )
+			{
+				// INIT
+				offscreen::view_host host(context, 100, 100);
+				const auto v = make_shared< mocks::logging_visual<view> >();
+				placed_view pv[] = {	{	v, nullptr_nv, {	10, 10, 90, 90	},	},	};
+				const rect_i area = {	5, 7, 15, 9	};
+
+				root->views = mkvector(pv);
+				host.set_root(root);
+				host.render();
+				v->update_area_log.clear();
+
+				// ACT
+				v->invalidate(&area);
+				host.render();
+
+				// ASSERT
+				rect_i reference[] = {	{	5, 7, 15, 9	},	};
+
+				assert_equal(reference, v->update_area_log);
+			}
+
+
+			test( ScrolledPixelsAreMovedWithinSurfaceAndOnlyExposedAreaIsRendered )
+			{
+				// INIT
+				offscreen::view_host host(context, 4, 4);
+				const auto v = make_shared<painting_view>(color_a);
+				placed_view pv[] = {	{	v, nullptr_nv, {	0, 0, 4, 4	},	},	};
+
+				root->views = mkvector(pv);
+				host.set_root(root);
+				host.render();
+				v->fill = color_b;
+
+				// ACT
+				v->scroll(0, -1);
+				host.render();
+
+				// ASSERT
+				const gcontext::pixel_type reference1[] = {
+					a, a, a, a,
+					a, a, a, a,
+					a, a, a, a,
+					b, b, b, b,
+				};
+
+				assert_equal(reference1, host.get_surface());
+
+				// ACT
+				v->fill = color_o;
+				v->scroll(-2, 0);
+				host.render();
+
+				// ASSERT
+				const gcontext::pixel_type reference2[] = {
+					a, a, o, o,
+					a, a, o, o,
+					a, a, o, o,
+					b, b, o, o,
+				};
+
+				assert_equal(reference2, host.get_surface());
+			}
+
+
+			test( InvalidAreasAreRenderedOnScheduledFrames )
+			{
+				// INIT
+				timestamp time = 0;
+				mocks::queue_container queued;
+				const auto v = make_shared< mocks::logging_visual<view> >();
+				placed_view pv[] = {	{	v, nullptr_nv, {	0, 0, 100, 100	},	},	};
+				const rect_i area = {	3, 4, 10, 11	};
+
+				context.frame_scheduler_ = make_shared<frame_scheduler>([&] {	return time;	}, mocks::create_queue(queued));
+
+				offscreen::view_host host(context, 100, 100);
+
+				root->views = mkvector(pv);
+
+				// ACT
+				host.set_root(root);
+
+				// ASSERT
+				assert_equal(1u, queued.size());
+				assert_is_empty(v->update_area_log);
+
+				// ACT
+				queued.front().task(), queued.pop();
+
+				// ASSERT
+				assert_equal(1u, v->update_area_log.size());
+				assert_is_false(host.render());
+
+				// ACT
+				v->invalidate(&area);
+				v->invalidate(&area);
+
+				// ASSERT
+				assert_equal(1u, queued.size());
+
+				// ACT
+				time += 20;
+				queued.front().task(), queued.pop();
+
+				// ASSERT
+				rect_i reference[] = {	{	0, 0, 100, 100	}, {	3, 4, 10, 11	},	};
+
+				assert_equal(reference, v->update_area_log);
+			}
+
+
+			test( MouseInputIsRoutedToViewsUnderCursor )
+			{
+				// INIT
+				offscreen::view_host host(context, 100, 100);
+				shared_ptr< mocks::logging_mouse_input<view> > v[] = {
+					make_shared< mocks::logging_mouse_input<view> >(), make_shared< mocks::logging_mouse_input<view> >(),
+				};
+				placed_view pv[] = {
+					{	v[0], nullptr_nv, {	0, 0, 50, 100	},	},
+					{	v[1], nullptr_nv, {	50, 0, 100, 100	},	},
+				};
+
+				root->views = mkvector(pv);
+				host.set_root(root);
+
+				// ACT
+				host.mouse_move(0, 10, 20);
+				host.mouse_down(mouse_input::left, 0, 11, 21);
+				host.mouse_up(mouse_input::left, mouse_input::left, 12, 22);
+				host.mouse_move(0, 60, 30);
+				host.mouse_scroll(0, 61, 31, 0, -1);
+				host.mouse_leave();
+
+				// ASSERT
+				mocks::mouse_event reference1[] = {
+					mocks::me_enter(), mocks::me_move(0, 10, 20),
+					mocks::me_down(mouse_input::left, 0, 11, 21), mocks::me_up(mouse_input::left, mouse_input::left, 12, 22),
+					mocks::me_leave(),
+				};
+				mocks::mouse_event reference2[] = {
+					mocks::me_enter(), mocks::me_move(0, 10, 30), mocks::me_scroll(0, 11, 31, 0, -1), mocks::me_leave(),
+				};
+
+				assert_equal(reference1, v[0]->events_log);
+				assert_equal(reference2, v[1]->events_log);
+			}
+
+
+			test( KeyboardInputGoesToFocusedView )
+			{
+				// INIT
+				offscreen::view_host host(context, 100, 100);
+				shared_ptr< mocks::logging_key_input<view> > v[] = {
+					make_shared< mocks::logging_key_input<view> >(), make_shared< mocks::logging_key_input<view> >(),
+				};
+				placed_view pv[] = {
+					{	v[0], nullptr_nv, {	0, 0, 50, 100	}, 1	},
+					{	v[1], nullptr_nv, {	50, 0, 100, 100	}, 2	},
+				};
+
+				root->views = mkvector(pv);
+				host.set_root(root);
+
+				// ACT
+				host.got_focus();
+				host.key_down(keyboard_input::down, 0);
+				host.key_up(keyboard_input::down, 0);
+				host.key_down(keyboard_input::tab, 0);
+				host.key_down(keyboard_input::up, keyboard_input::shift);
+
+				// ASSERT
+				mocks::keyboard_event reference1[] = {
+					{	mocks::keyboard_event::focusin, 0, 0	},
+					{	mocks::keyboard_event::keydown, keyboard_input::down, 0	},
+					{	mocks::keyboard_event::keyup, keyboard_input::down, 0	},
+					{	mocks::keyboard_event::focusout, 0, 0	},
+				};
+				mocks::keyboard_event reference2[] = {
+					{	mocks::keyboard_event::focusin, 0, 0	},
+					{	mocks::keyboard_event::keydown, keyboard_input::up, keyboard_input::shift	},
+				};
+
+				assert_equal(reference1, v[0]->events);
+				assert_equal(reference2, v[1]->events);
+			}
+		end_test_suite
+	}
+}
@@ -0,0 +1,212 @@
+#include <wpl/rasterizer_pool.h>
+
+#include <ut/assert.h>
+#include <ut/test.h>
+
+using namespace std;
+
+namespace wpl
+{
+	namespace tests
+	{
+		namespace
+		{
+			void add_square(gcontext::rasterizer_type &rasterizer, int size)
+			{
+				rasterizer.move_to(0, 0);
+				rasterizer.line_to(size, 0);
+				rasterizer.line_to(size, size);
+				rasterizer.line_to(0, size);
+				rasterizer.close_polygon();
+			}
+		}
+
+		begin_test_suite( RasterizerPoolTests )
+			test( EmptyPoolCreatesNewRasterizers )
+			{
+				// INIT
+				rasterizer_pool p;
+
+				// ACT
+				auto r1 = p.acquire();
+				auto r2 = p.acquire();
+
+				// ASSERT
+				assert_not_null(r1.get());
+				assert_not_null(r2.get());
+				assert_not_equal(r1.get(), r2.get());
+				assert_equal(0u, p.idle());
+			}
+
+
+			test( ReleasedRasterizersAreReused )
+			{
+				// INIT
+				rasterizer_pool p;
+				auto r1 = p.acquire();
+				auto r2 = p.acquire();
+				const auto pr1 = r1.get();
+				const auto pr2 = r2.get();
+
+				add_square(*r1, 10);
+
+				// ACT
+				p.release(r1);
+				p.release(r2);
+
+				// ASSERT
+				assert_null(r1.get());
+				assert_null(r2.get());
+				assert_equal(2u, p.idle());
+
+				// ACT
+				auto r3 = p.acquire();
+				auto r4 = p.acquire();
+
+				// ASSERT
+				assert_equal(0u, p.idle());
+				assert_is_true(r3.get() == pr1 || r3.get() == pr2);
+				assert_is_true(r4.get() == pr1 || r4.get() == pr2);
+				assert_not_equal(r3.get(), r4.get());
+			}
+
+
+			test( RasterizersReleasedWithLargePathsAreFreedOnTrim )
+			{
+				// INIT
+				rasterizer_pool p(100);
+				auto r1 = p.acquire();
+				auto r2 = p.acquire();
+				auto r3 = p.acquire();
+				const auto pr2 = r2.get();
+
+				add_square(*r1, 20);
+				add_square(*r2, 5);
+				add_square(*r3, 30);
+				p.release(r1);
+				p.release(r2);
+				p.release(r3);
+
+				// ACT
+				p.trim();
+
+				// ASSERT
+				assert_equal(1u, p.idle());
+				assert_equal(pr2, p.acquire().get());
+			}
+
+
+			test( SmallRasterizersArePreferredOnAcquire )
+			{
+				// INIT
+				rasterizer_pool p(100);
+				auto r1 = p.acquire();
+				auto r2 = p.acquire();
+				const auto pr2 = r2.get();
+
+				add_square(*r1, 20);
+				p.release(r1);
+				p.release(r2);
+
+				// ACT / ASSERT
+				assert_equal(pr2, p.acquire().get());
+			}
+
+
+			test( AllIdleRasterizersAreFreedOnTrimAfterLargePathIsRendered )
+			{
+				// INIT
+				rasterizer_pool p(100);
+				auto r1 = p.acquire();
+				auto r2 = p.acquire();
+
+				p.release(r1);
+				p.release(r2);
+
+				// ACT
+				p.rendered(101);
+				p.trim();
+
+				// ASSERT
+				assert_equal(0u, p.idle());
+
+				// INIT
+				r1 = p.acquire();
+				p.release(r1);
+
+				// ACT
+				p.rendered(100);
+				p.trim();
+
+				// ASSERT
+				assert_equal(1u, p.idle());
+			}
+
+
+			test( RasterizerInUseIsReplacedOnTrimAfterLargePathIsRendered )
+			{
+				// INIT
+				rasterizer_pool p(100);
+				gcontext::rasterizer_ptr r(new gcontext::rasterizer_type), empty;
+				const auto pr = r.get();
+
+				// ACT
+				p.rendered(100);
+				p.trim(r);
+
+				// ASSERT
+				assert_equal(pr, r.get());
+
+				// ACT
+				p.rendered(101);
+				p.trim(r);
+				p.trim(empty);
+
+				// ASSERT
+				assert_not_null(r.get());
+				assert_not_equal(pr, r.get());
+				assert_null(empty.get());
+
+				// INIT
+				const auto pr2 = r.get();
+
+				// ACT
+				p.trim(r);
+
+				// ASSERT
+				assert_equal(pr2, r.get());
+			}
+
+
+			test( IdleRasterizersAboveTheLimitAreFreedOnTrim )
+			{
+				// INIT
+				rasterizer_pool p(100, 2);
+				gcontext::rasterizer_ptr r[] = {	p.acquire(), p.acquire(), p.acquire(), p.acquire(),	};
+
+				for (auto i = begin(r); i != end(r); ++i)
+					p.release(*i);
+
+				// ACT
+				p.trim();
+
+				// ASSERT
+				assert_equal(2u, p.idle());
+			}
+
+
+			test( ReleasingEmptyPointerIsNoop )
+			{
+				// INIT
+				rasterizer_pool p;
+				gcontext::rasterizer_ptr r;
+
+				// ACT
+				p.release(r);
+
+				// ASSERT
+				assert_equal(0u, p.idle());
+			}
+		end_test_suite
+	}
+}
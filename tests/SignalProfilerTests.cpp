@@ -0,0 +1,240 @@
+#include <wpl/signal_profiler.h>
+
+#include <wpl/signal.h>
+
+#include "common/mock-control.h"
+
+#include <wpl/models.h>
+#include <ut/assert.h>
+#include <ut/test.h>
+
+using namespace std;
+
+namespace wpl
+{
+	namespace tests
+	{
+		namespace
+		{
+			const signal_statistics *find(const vector<signal_statistics> &statistics, const string &name)
+			{
+				for (auto i = statistics.begin(); i != statistics.end(); ++i)
+				{
+					if (i->name == name)
+						return &*i;
+				}
+				return nullptr;
+			}
+		}
+
+		begin_test_suite( SignalProfilerTests )
+			test( StatisticsAreSharedBetweenRegistrationsOfTheSameName )
+			{
+				// INIT / ACT
+				const auto s1 = register_signal_statistics("profiler.test.a");
+				const auto s2 = register_signal_statistics("profiler.test.b");
+				const auto s3 = register_signal_statistics("profiler.test.a");
+
+				// ASSERT
+				assert_not_null(s1);
+				assert_not_null(s2);
+				assert_equal(s1, s3);
+				assert_not_equal(s1, s2);
+				assert_equal("profiler.test.a", s1->name);
+				assert_equal("profiler.test.b", s2->name);
+				assert_equal(0u, s2->emissions);
+				assert_equal(0u, s2->reentrant_emissions);
+				assert_equal(0u, s2->slot_calls);
+				assert_equal(0.0, s2->total_time);
+				assert_equal(0.0, s2->max_time);
+			}
+
+
+			test( EmissionScopeAccountsEmissionsAndSlotCalls )
+			{
+				// INIT
+				const auto s = register_signal_statistics("profiler.test.scope");
+
+				// ACT
+				{
+					signal_emission_scope scope(s.get(), false);
+
+					scope.slot_called();
+					scope.slot_called();
+				}
+
+				// ASSERT
+				assert_equal(1u, s->emissions);
+				assert_equal(2u, s->slot_calls);
+				assert_equal(0u, s->reentrant_emissions);
+				assert_is_true(s->total_time >= 0.0);
+				assert_equal(s->total_time, s->max_time);
+
+				// ACT
+				{
+					signal_emission_scope scope(s.get(), false);
+					signal_emission_scope nested(s.get(), true);
+
+					nested.slot_called();
+				}
+
+				// ASSERT
+				assert_equal(3u, s->emissions);
+				assert_equal(3u, s->slot_calls);
+				assert_equal(1u, s->reentrant_emissions);
+				assert_is_true(s->max_time <= s->total_time);
+			}
+
+
+			test( EmissionScopeWithoutStatisticsDoesNothing )
+			{
+				// INIT / ACT / ASSERT (must not crash)
+				signal_emission_scope scope(nullptr, true);
+
+				scope.slot_called();
+			}
+
+
+			test( QueriedStatisticsAreOrderedByTotalTime )
+			{
+				// INIT
+				const auto s1 = register_signal_statistics("profiler.test.order.1");
+				const auto s2 = register_signal_statistics("profiler.test.order.2");
+				const auto s3 = register_signal_statistics("profiler.test.order.3");
+
+				s1->total_time = 1e3, s1->emissions = 3;
+				s2->total_time = 3e3, s2->emissions = 5;
+				s3->total_time = 2e3, s3->emissions = 7;
+
+				// ACT
+				const auto statistics = query_signal_statistics();
+
+				// ASSERT
+				assert_is_true(statistics.size() >= 3u);
+				assert_equal("profiler.test.order.2", statistics[0].name);
+				assert_equal(5u, statistics[0].emissions);
+				assert_equal("profiler.test.order.3", statistics[1].name);
+				assert_equal(7u, statistics[1].emissions);
+				assert_equal("profiler.test.order.1", statistics[2].name);
+				assert_equal(3u, statistics[2].emissions);
+
+				// INIT
+				reset_signal_statistics();
+			}
+
+
+			test( ResettingZeroesTheCountersButKeepsTheEntries )
+			{
+				// INIT
+				const auto s = register_signal_statistics("profiler.test.reset");
+
+				s->emissions = 10, s->reentrant_emissions = 2, s->slot_calls = 30;
+				s->total_time = 1.0, s->max_time = 0.5;
+
+				// ACT
+				reset_signal_statistics();
+
+				// ASSERT
+				const auto statistics = query_signal_statistics();
+				const auto entry = find(statistics, "profiler.test.reset");
+
+				assert_not_null(entry);
+				assert_equal(0u, entry->emissions);
+				assert_equal(0u, entry->reentrant_emissions);
+				assert_equal(0u, entry->slot_calls);
+				assert_equal(0.0, entry->total_time);
+				assert_equal(0.0, entry->max_time);
+				assert_equal(0u, s->emissions);
+			}
+
+
+			test( DumpListsAllTheRegisteredSignals )
+			{
+				// INIT
+				const auto s1 = register_signal_statistics("profiler.test.dump.lorem");
+				const auto s2 = register_signal_statistics("profiler.test.dump.ipsum");
+
+				s1->emissions = 12345;
+
+				// ACT
+				const auto text = dump_signal_statistics();
+
+				// ASSERT
+				assert_not_equal(string::npos, text.find("emissions"));
+				assert_not_equal(string::npos, text.find("profiler.test.dump.lorem"));
+				assert_not_equal(string::npos, text.find("profiler.test.dump.ipsum"));
+				assert_not_equal(string::npos, text.find("12345"));
+
+				// INIT
+				reset_signal_statistics();
+			}
+
+#if defined(WPL_PROFILE_SIGNALS)
+
+			test( ProfiledSignalEmissionsAreAccounted )
+			{
+				// INIT
+				signal<void (int)> s;
+				const auto statistics = register_signal_statistics("profiler.test.signal");
+				auto c1 = s += [&] (int depth) {
+					if (depth)
+						s(depth - 1);
+				};
+				auto c2 = s += [] (int) {	};
+
+				s.profile("profiler.test.signal");
+				reset_signal_statistics();
+
+				// ACT
+				s(1);
+
+				// ASSERT
+				assert_equal(2u, statistics->emissions);
+				assert_equal(1u, statistics->reentrant_emissions);
+				assert_equal(4u, statistics->slot_calls);
+			}
+
+
+			test( LayoutAndModelInvalidationSignalsAreProfiledByDefault )
+			{
+				// INIT
+				struct table : table_model_base
+				{
+					virtual index_type get_count() const throw() override
+					{	return 0;	}
+				} t;
+				struct columns : columns_model
+				{
+					virtual index_type get_count() const throw() override
+					{	return 0;	}
+
+					virtual void get_value(index_type /*index*/, short int &/*value*/) const override
+					{	}
+				} c;
+				mocks::control ctl;
+				const auto layout_changed = register_signal_statistics("control.layout_changed");
+				const auto invalidate = register_signal_statistics("table_model.invalidate");
+				const auto invalidate_range = register_signal_statistics("table_model.invalidate_range");
+				const auto columns_invalidate = register_signal_statistics("columns_model.invalidate");
+
+				reset_signal_statistics();
+
+				// ACT
+				ctl.layout_changed(false);
+				ctl.layout_changed(true);
+				t.invalidate(3);
+				t.invalidate_range(1, 2);
+				t.invalidate_range(1, 2);
+				t.invalidate_range(1, 2);
+				c.invalidate(table_model_base::npos());
+
+				// ASSERT
+				assert_equal(2u, layout_changed->emissions);
+				assert_equal(1u, invalidate->emissions);
+				assert_equal(3u, invalidate_range->emissions);
+				assert_equal(1u, columns_invalidate->emissions);
+			}
+#endif
+		end_test_suite
+	}
+}
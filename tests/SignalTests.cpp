@@ -1,6 +1,7 @@
 #include <wpl/signal.h>
 
 #include <string>
+#include <vector>
 #include <ut/assert.h>
 #include <ut/test.h>
 
@@ -449,6 +450,137 @@ namespace wpl
 				assert_equal(1, s10_n);
 				assert_null(ps.get());
 			}
+
+
+			test( SlotsAreCalledInConnectionOrderAfterDisconnections )
+			{
+				// INIT
+				signal<void ()> s;
+				vector<int> log;
+				vector<slot_connection> c;
+
+				for (auto i = 0; i != 7; ++i)
+					c.push_back(s += [&log, i] {	log.push_back(i);	});
+
+				// ACT
+				c[1] = slot_connection();
+				c[4] = slot_connection();
+				c.push_back(s += [&log] {	log.push_back(7);	});
+				s();
+
+				// ASSERT
+				int reference1[] = {	0, 2, 3, 5, 6, 7,	};
+
+				assert_equal(reference1, log);
+
+				// INIT
+				log.clear();
+
+				// ACT
+				c[0] = slot_connection();
+				c[6] = slot_connection();
+				c.push_back(s += [&log] {	log.push_back(8);	});
+				s();
+
+				// ASSERT
+				int reference2[] = {	2, 3, 5, 7, 8,	};
+
+				assert_equal(reference2, log);
+			}
+
+
+			test( SlotsConnectedDuringInvocationAreCalledInTheSamePass )
+			{
+				// INIT
+				signal<void ()> s;
+				vector<int> log;
+				vector<slot_connection> c;
+
+				c.push_back(s += [&] {
+					log.push_back(0);
+					if (c.size() == 1)
+					{
+						for (auto i = 1; i != 30; ++i)
+							c.push_back(s += [&log, i] {	log.push_back(i);	});
+					}
+				});
+
+				// ACT
+				s();
+
+				// ASSERT
+				assert_equal(30u, log.size());
+				for (auto i = 0; i != 30; ++i)
+					assert_equal(i, log[i]);
+
+				// INIT
+				log.clear();
+
+				// ACT
+				s();
+
+				// ASSERT
+				assert_equal(30u, log.size());
+			}
+
+
+			test( SlotsDisconnectedDuringInvocationAfterStorageGrowthAreNotCalled )
+			{
+				// INIT
+				signal<void ()> s;
+				vector<int> log;
+				vector<slot_connection> c;
+
+				c.push_back(s += [&] {
+					log.push_back(0);
+					if (c.size() == 3)
+					{
+						for (auto i = 3; i != 20; ++i)
+							c.push_back(s += [&log, i] {	log.push_back(i);	});
+						c[1] = slot_connection();
+						c[2] = slot_connection();
+						c[10] = slot_connection();
+					}
+				});
+				c.push_back(s += [&log] {	log.push_back(1);	});
+				c.push_back(s += [&log] {	log.push_back(2);	});
+
+				// ACT
+				s();
+
+				// ASSERT
+				int reference1[] = {	0, 3, 4, 5, 6, 7, 8, 9, 11, 12, 13, 14, 15, 16, 17, 18, 19,	};
+
+				assert_equal(reference1, log);
+
+				// INIT
+				log.clear();
+				c[0] = slot_connection();
+
+				// ACT
+				s();
+
+				// ASSERT
+				int reference2[] = {	3, 4, 5, 6, 7, 8, 9, 11, 12, 13, 14, 15, 16, 17, 18, 19,	};
+
+				assert_equal(reference2, log);
+			}
+
+
+			test( ConnectionKeepsSlotStorageAliveAfterSignalDestruction )
+			{
+				// INIT
+				unique_ptr< signal<void ()> > s(new signal<void ()>);
+				slot_connection c1 = *s += &s1_f;
+				slot_connection c2 = *s += &s1x_f;
+
+				// ACT
+				s.reset();
+
+				// ACT / ASSERT (must not fail)
+				c1 = slot_connection();
+				c2 = slot_connection();
+			}
 		end_test_suite
 	}
 }
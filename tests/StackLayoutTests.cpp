@@ -7,6 +7,8 @@
 #include <tests/common/mock-control.h>
 #include <tests/common/Mockups.h>
 
+#include <thread>
+#include <type_traits>
 #include <ut/assert.h>
 #include <ut/test.h>
 #include <wpl/view.h>
@@ -27,6 +29,19 @@ namespace wpl
 				bool operator ()(const placed_view &lhs, const placed_view &rhs) const
 				{	return lhs.location == rhs.location && lhs.tab_order == rhs.tab_order;	}
 			};
+
+			class hosting_control : public mocks::control
+			{
+			public:
+				virtual void layout(const placed_view_appender &append_view, const agge::box<int> &box) override
+				{
+					on_layout(box);
+					mocks::control::layout(append_view, box);
+				}
+
+			public:
+				function<void (const agge::box<int> &box)> on_layout;
+			};
 		}
 
 		begin_test_suite( StackLayoutTests )
@@ -1425,6 +1440,252 @@ namespace wpl
 				assert_equal(reference2_shared[3], controls[3]->for_height_log);
 			}
 
+
+			test( UnchangedStackKeepsCachedViewsWithoutLayingOutChildren )
+			{
+				// INIT
+				auto c1 = make_shared<mocks::control>();
+				auto c2 = make_shared<mocks::control>();
+				placed_view pv1 = {	make_shared<view>(), nullptr_nv, create_rect(1, 2, 3, 4), 1,	};
+				placed_view pv2 = {	make_shared<view>(), nullptr_nv, create_rect(5, 6, 7, 8), 1,	};
+				stack s(true, cursor_manager_);
+				layout_cache cache;
+
+				c1->views.push_back(pv1);
+				c2->views.push_back(pv2);
+				s.add(c1, pixels(10), false, 3);
+				s.add(c2, pixels(20), false, 4);
+				cache.layout(s, make_box(100, 50));
+
+				// ACT
+				cache.layout(s, make_box(100, 50));
+
+				// ASSERT
+				placed_view reference[] = {
+					{ pv1.regular, nullptr_nv, create_rect(1, 2, 3, 4), 3 },
+					{ pv2.regular, nullptr_nv, create_rect(15, 6, 17, 8), 4 },
+				};
+
+				assert_equal(reference, cache.get_views());
+				assert_equal(1u, c1->size_log.size());
+				assert_equal(1u, c2->size_log.size());
+
+				// ACT
+				cache.layout(s, make_box(100, 51));
+
+				// ASSERT
+				agge::box<int> reference_box1[] = {	{ 10, 50 }, { 10, 51 },	};
+				agge::box<int> reference_box2[] = {	{ 20, 50 }, { 20, 51 },	};
+
+				assert_equal(reference, cache.get_views());
+				assert_equal(reference_box1, c1->size_log);
+				assert_equal(reference_box2, c2->size_log);
+			}
+
+
+			test( StackLaidOutWithoutCacheLaysOutChildrenEveryTime )
+			{
+				// INIT
+				auto c = make_shared<mocks::control>();
+				vector<placed_view> v;
+				stack s(true, cursor_manager_);
+
+				s.add(c, pixels(10));
+
+				// ACT
+				s.layout(make_appender(v), make_box(100, 50));
+				s.layout(make_appender(v), make_box(100, 50));
+
+				// ASSERT
+				assert_equal(2u, c->size_log.size());
+			}
+
+
+			test( OnlyContainersAboveTheChangedChildLayOutTheirChildrenAgain )
+			{
+				// INIT
+				auto c1 = make_shared<mocks::control>();
+				auto c2 = make_shared<mocks::control>();
+				auto c3 = make_shared<mocks::control>();
+				auto inner1 = make_shared<stack>(false, cursor_manager_);
+				auto inner2 = make_shared<stack>(false, cursor_manager_);
+				auto inner3 = make_shared<stack>(false, cursor_manager_);
+				stack outer(true, cursor_manager_);
+				layout_cache cache;
+				placed_view pv1 = {	make_shared<view>(), nullptr_nv, create_rect(0, 0, 3, 4), 1,	};
+				placed_view pv2 = {	make_shared<view>(), nullptr_nv, create_rect(0, 0, 7, 8), 1,	};
+				placed_view pv3 = {	make_shared<view>(), nullptr_nv, create_rect(1, 1, 9, 9), 1,	};
+
+				c1->views.push_back(pv1);
+				c2->views.push_back(pv2);
+				c3->views.push_back(pv3);
+				inner1->add(c1, percents(100));
+				inner2->add(c2, percents(100));
+				inner3->add(c3, percents(100));
+				inner2->add(inner3, pixels(20));
+				outer.add(inner1, pixels(30));
+				outer.add(inner2, percents(100));
+				cache.layout(outer, make_box(100, 50));
+
+				const vector<placed_view> v1 = cache.get_views();
+
+				// ACT
+				c1->layout_changed(false);
+				cache.layout(outer, make_box(100, 50));
+
+				// ASSERT
+				assert_equal(v1, cache.get_views());
+				assert_equal(2u, c1->size_log.size());
+				assert_equal(1u, c2->size_log.size());
+				assert_equal(1u, c3->size_log.size());
+
+				// ACT
+				c2->layout_changed(false);
+				cache.layout(outer, make_box(100, 50));
+
+				// ASSERT
+				assert_equal(v1, cache.get_views());
+				assert_equal(2u, c1->size_log.size());
+				assert_equal(2u, c2->size_log.size());
+				assert_equal(1u, c3->size_log.size()); // A nested container is kept.
+
+				// ACT
+				c3->layout_changed(false);
+				cache.layout(outer, make_box(100, 50));
+
+				// ASSERT
+				assert_equal(v1, cache.get_views());
+				assert_equal(2u, c1->size_log.size());
+				assert_equal(3u, c2->size_log.size());
+				assert_equal(2u, c3->size_log.size()); // ...and remains cached after having been kept.
+			}
+
+
+			test( MovedContainersKeepTheirViewsShifted )
+			{
+				// INIT
+				auto c1 = make_shared<mocks::control>();
+				auto c2 = make_shared<mocks::control>();
+				auto inner = make_shared<stack>(false, cursor_manager_);
+				stack outer(true, cursor_manager_);
+				layout_cache cache;
+				placed_view pv1 = {	make_shared<view>(), nullptr_nv, create_rect(0, 0, 3, 4), 1,	};
+				placed_view pv2 = {	make_shared<view>(), nullptr_nv, create_rect(1, 2, 7, 8), 1,	};
+
+				c1->views.push_back(pv1);
+				c2->views.push_back(pv2);
+				inner->add(c2, percents(100));
+				outer.add(c1, pixels(30));
+				outer.add(inner, pixels(40), false, 7);
+				outer.add(make_shared<mocks::control>(), percents(100));
+				cache.layout(outer, make_box(100, 50));
+
+				// ACT
+				outer.set_spacing(5);
+				cache.layout(outer, make_box(100, 50));
+
+				// ASSERT
+				placed_view reference[] = {
+					{ pv1.regular, nullptr_nv, create_rect(0, 0, 3, 4), 1 },
+					{ pv2.regular, nullptr_nv, create_rect(36, 2, 42, 8), 7 },
+				};
+
+				assert_equal(reference, cache.get_views());
+				assert_equal(1u, c2->size_log.size());
+			}
+
+			test( ContainerCreatedAtTheAddressOfADestroyedOneIsLaidOutAnew )
+			{
+				// INIT
+				auto c1 = make_shared<mocks::control>();
+				auto c2 = make_shared<mocks::control>();
+				placed_view pv1 = {	make_shared<view>(), nullptr_nv, create_rect(1, 2, 3, 4), 1,	};
+				placed_view pv2 = {	make_shared<view>(), nullptr_nv, create_rect(5, 6, 7, 8), 1,	};
+				aligned_storage<sizeof(stack), alignof(stack)>::type storage;
+				layout_cache cache;
+
+				c1->views.push_back(pv1);
+				c2->views.push_back(pv2);
+
+				auto s1 = new (&storage) stack(true, cursor_manager_);
+
+				s1->add(c1, pixels(10));
+				cache.layout(*s1, make_box(100, 50));
+				s1->~stack();
+
+				auto s2 = new (&storage) stack(true, cursor_manager_);
+
+				s2->add(c2, pixels(10));
+
+				// ACT
+				cache.layout(*s2, make_box(100, 50));
+				s2->~stack();
+
+				// ASSERT
+				placed_view reference[] = {
+					{ pv2.regular, nullptr_nv, create_rect(5, 6, 7, 8), 1 },
+				};
+
+				assert_equal(reference, cache.get_views());
+				assert_equal(1u, c2->size_log.size());
+			}
+
+
+			test( CacheLaidOutFromWithinAnotherCachesLayoutKeepsItsOwnViews )
+			{
+				// INIT
+				auto host = make_shared<hosting_control>();
+				auto c = make_shared<mocks::control>();
+				placed_view pv1 = {	make_shared<view>(), nullptr_nv, create_rect(1, 2, 3, 4), 1,	};
+				placed_view pv2 = {	make_shared<view>(), nullptr_nv, create_rect(5, 6, 7, 8), 1,	};
+				stack outer(true, cursor_manager_), inner(false, cursor_manager_);
+				layout_cache cache, nested_cache;
+
+				host->views.push_back(pv1);
+				c->views.push_back(pv2);
+				host->on_layout = [&] (const agge::box<int> &box) {	nested_cache.layout(inner, box);	};
+				inner.add(c, pixels(10));
+				outer.add(make_shared<mocks::control>(), pixels(20));
+				outer.add(host, pixels(30));
+
+				// ACT
+				cache.layout(outer, make_box(100, 50));
+
+				// ASSERT
+				placed_view reference1[] = {	{ pv1.regular, nullptr_nv, create_rect(21, 2, 23, 4), 1 },	};
+				placed_view reference2[] = {	{ pv2.regular, nullptr_nv, create_rect(5, 6, 7, 8), 1 },	};
+
+				assert_equal(reference1, cache.get_views());
+				assert_equal(reference2, nested_cache.get_views());
+			}
+
+
+			test( ContainersLaidOutOnOtherThreadsDoNotPlaceViewsToTheCacheBeingLaidOut )
+			{
+				// INIT
+				auto host = make_shared<hosting_control>();
+				auto c = make_shared<mocks::control>();
+				placed_view pv = {	make_shared<view>(), nullptr_nv, create_rect(5, 6, 7, 8), 1,	};
+				stack outer(true, cursor_manager_), other(false, cursor_manager_);
+				layout_cache cache;
+				vector<placed_view> v;
+
+				c->views.push_back(pv);
+				host->on_layout = [&] (const agge::box<int> &box) {
+					thread([&] {	other.layout(make_appender(v), box);	}).join();
+				};
+				other.add(c, pixels(10));
+				outer.add(host, pixels(30));
+
+				// ACT
+				cache.layout(outer, make_box(100, 50));
+
+				// ASSERT
+				placed_view reference[] = {	{ pv.regular, nullptr_nv, create_rect(5, 6, 7, 8), 1 },	};
+
+				assert_equal(reference, v);
+				assert_is_empty(cache.get_views());
+			}
 		end_test_suite
 	}
 }
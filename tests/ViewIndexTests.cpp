@@ -0,0 +1,198 @@
+#include <wpl/view_index.h>
+
+#include <algorithm>
+#include <tests/common/helpers-visual.h>
+
+#include <ut/assert.h>
+#include <ut/test.h>
+
+using namespace std;
+
+namespace wpl
+{
+	namespace tests
+	{
+		namespace
+		{
+			placed_view make_pv(int x1, int y1, int x2, int y2)
+			{
+				placed_view pv = {	nullptr, nullptr, create_rect(x1, y1, x2, y2), 0, false	};
+				return pv;
+			}
+
+			const placed_view *find_linear(const vector<placed_view> &views, agge::point<int> point)
+			{
+				for (auto i = views.rbegin(); i != views.rend(); ++i)
+				{
+					const auto &w = i->location;
+
+					if (w.x1 <= point.x && point.x < w.x2 && w.y1 <= point.y && point.y < w.y2)
+						return &*i;
+				}
+				return nullptr;
+			}
+
+			vector<size_t> query_unique(const view_index &index, const rect_i &area)
+			{
+				vector<size_t> result;
+
+				index.query(result, area);
+				sort(result.begin(), result.end());
+				result.erase(unique(result.begin(), result.end()), result.end());
+				return result;
+			}
+		}
+
+		begin_test_suite( ViewIndexTests )
+			test( IndexIsCurrentOnlyForTheViewsItWasBuiltFor )
+			{
+				// INIT
+				view_index index;
+				vector<placed_view> views;
+
+				views.push_back(make_pv(0, 0, 10, 10));
+				views.push_back(make_pv(5, 5, 30, 20));
+
+				// ACT / ASSERT
+				assert_is_false(index.is_current(views));
+
+				// ACT
+				index.rebuild(views);
+
+				// ASSERT
+				assert_is_true(index.is_current(views));
+
+				// ACT
+				views.push_back(make_pv(5, 5, 30, 20));
+
+				// ASSERT
+				assert_is_false(index.is_current(views));
+			}
+
+
+			test( TopmostViewContainingPointIsFound )
+			{
+				// INIT
+				view_index index;
+				vector<placed_view> views;
+
+				views.push_back(make_pv(0, 0, 100, 100));
+				views.push_back(make_pv(10, 10, 50, 50));
+				views.push_back(make_pv(40, 40, 60, 60));
+				index.rebuild(views);
+
+				// ACT / ASSERT
+				assert_equal(&views[0], index.hit_test(views, create_point(0, 0)));
+				assert_equal(&views[0], index.hit_test(views, create_point(99, 99)));
+				assert_equal(&views[1], index.hit_test(views, create_point(10, 10)));
+				assert_equal(&views[1], index.hit_test(views, create_point(39, 49)));
+				assert_equal(&views[2], index.hit_test(views, create_point(40, 40)));
+				assert_equal(&views[2], index.hit_test(views, create_point(49, 49)));
+				assert_equal(&views[0], index.hit_test(views, create_point(50, 39)));
+			}
+
+
+			test( PointsOutsideViewsHitNothing )
+			{
+				// INIT
+				view_index index;
+				vector<placed_view> views;
+
+				views.push_back(make_pv(10, 10, 20, 20));
+				views.push_back(make_pv(30, 10, 40, 20));
+				views.push_back(make_pv(10, 30, 20, 40));
+				index.rebuild(views);
+
+				// ACT / ASSERT
+				assert_null(index.hit_test(views, create_point(0, 0)));
+				assert_null(index.hit_test(views, create_point(9, 15)));
+				assert_null(index.hit_test(views, create_point(20, 15)));
+				assert_null(index.hit_test(views, create_point(25, 25)));
+				assert_null(index.hit_test(views, create_point(40, 15)));
+				assert_null(index.hit_test(views, create_point(15, 40)));
+				assert_null(index.hit_test(views, create_point(1000, -1000)));
+			}
+
+
+			test( EmptyViewsAreNeverHit )
+			{
+				// INIT
+				view_index index;
+				vector<placed_view> views;
+
+				views.push_back(make_pv(0, 0, 10, 10));
+				views.push_back(make_pv(5, 5, 5, 10));
+				views.push_back(make_pv(5, 5, 3, 3));
+				index.rebuild(views);
+
+				// ACT / ASSERT
+				assert_equal(&views[0], index.hit_test(views, create_point(5, 5)));
+				assert_equal(&views[0], index.hit_test(views, create_point(4, 4)));
+				assert_is_empty(query_unique(index, create_rect(11, 11, 20, 20)));
+			}
+
+
+			test( HitTestingOfTiledViewsMatchesLinearSearch )
+			{
+				// INIT
+				view_index index;
+				vector<placed_view> views;
+
+				views.push_back(make_pv(0, 0, 1000, 700));
+				for (auto y = 0; y < 700; y += 14)
+				{
+					for (auto x = 0; x < 1000; x += 20)
+						views.push_back(make_pv(x + 1, y + 1, x + 19, y + 13));
+				}
+				views.push_back(make_pv(300, 200, 330, 800));
+				index.rebuild(views);
+
+				// ACT / ASSERT
+				for (auto y = -3; y < 710; y += 3)
+				{
+					for (auto x = -3; x < 1010; x += 7)
+					{
+						const auto point = create_point(x, y);
+
+						assert_equal(find_linear(views, point), index.hit_test(views, point));
+					}
+				}
+			}
+
+
+			test( QueryReturnsAllViewsIntersectingArea )
+			{
+				// INIT
+				view_index index;
+				vector<placed_view> views;
+
+				for (auto y = 0; y < 500; y += 10)
+				{
+					for (auto x = 0; x < 500; x += 10)
+						views.push_back(make_pv(x, y, x + 10, y + 10));
+				}
+				views.push_back(make_pv(-100, -100, 600, 600));
+				index.rebuild(views);
+
+				rect_i areas[] = {
+					create_rect(0, 0, 1, 1), create_rect(15, 25, 37, 41), create_rect(490, 490, 700, 700),
+					create_rect(-50, -50, 0, 0),
+				};
+
+				for (auto a = begin(areas); a != end(areas); ++a)
+				{
+					// ACT
+					const auto result = query_unique(index, *a);
+
+					// ASSERT
+					for (auto i = views.begin(); i != views.end(); ++i)
+					{
+						if (are_intersecting(i->location, *a))
+							assert_is_true(binary_search(result.begin(), result.end(), static_cast<size_t>(i - views.begin())));
+					}
+					assert_is_true(result.size() < views.size() / 2);
+				}
+			}
+		end_test_suite
+	}
+}
@@ -1,9 +1,15 @@
 #include <wpl/visual_router.h>
 
+#include <wpl/controls/background.h>
+#include <wpl/stylesheet_db.h>
+
 #include <tests/common/helpers-visual.h>
 #include <tests/common/mock-router_host.h>
 #include <tests/common/Mockups.h>
 
+#include <algorithm>
+#include <atomic>
+#include <mutex>
 #include <ut/assert.h>
 #include <ut/test.h>
 
@@ -16,6 +22,55 @@ namespace wpl
 		namespace
 		{
 			const auto nullptr_nv = shared_ptr<native_view>();
+
+			class concurrent_logging_view : public view
+			{
+			public:
+				concurrent_logging_view()
+				{	concurrent_draw = true;	}
+
+				vector<agge::rect_i> get_log() const
+				{
+					lock_guard<mutex> l(_mtx);
+					auto log = _log;
+
+					stable_sort(log.begin(), log.end(), [] (const agge::rect_i &lhs, const agge::rect_i &rhs) {
+						return lhs.y1 < rhs.y1;
+					});
+					return log;
+				}
+
+			private:
+				virtual void draw(gcontext &ctx, gcontext::rasterizer_ptr &/*rasterizer*/) const override
+				{
+					lock_guard<mutex> l(_mtx);
+
+					_log.push_back(ctx.update_area());
+				}
+
+			private:
+				mutable mutex _mtx;
+				mutable vector<agge::rect_i> _log;
+			};
+
+			class text_locking_view : public view
+			{
+			public:
+				text_locking_view()
+					: locked(0), unlocked(0)
+				{	concurrent_draw = true;	}
+
+			public:
+				mutable atomic<int> locked, unlocked;
+
+			private:
+				virtual void draw(gcontext &ctx, gcontext::rasterizer_ptr &/*rasterizer*/) const override
+				{
+					const auto l = ctx.lock_text_engine();
+
+					++(l.owns_lock() ? locked : unlocked);
+				}
+			};
 		}
 
 		begin_test_suite( VisualRouterTests )
@@ -422,6 +477,720 @@ namespace wpl
 				assert_equal(2u, v->update_area_log.size());
 			}
 
+
+			test( NonTranscendingViewsAreWindowedToUpdateArea )
+			{
+				// INIT
+				visual_router vr(views, vrhost);
+				gcontext::surface_type surface(20, 10, 0);
+				auto v = make_shared< mocks::logging_visual<view> >();
+				placed_view pv[] = {	{	v, nullptr_nv, {	10, 5, 110, 105	},	},	};
+
+				views = mkvector(pv);
+
+				// ACT
+				gcontext ctx(surface, *renderer, *text_engine, make_vector(30, 50));
+				vr.draw(ctx, rasterizer);
+
+				// ASSERT
+				agge::rect_i reference[] = {	{	20, 45, 40, 55	},	};
+
+				assert_equal(reference, v->update_area_log);
+			}
+
+
+			test( OnlyViewsIntersectingUpdateAreaAreDrawnWhenIndexed )
+			{
+				// INIT
+				visual_router vr(views, vrhost);
+				gcontext::surface_type surface(100, 100, 0);
+				shared_ptr< mocks::logging_visual<view> > v[] = {
+					make_shared< mocks::logging_visual<view> >(), make_shared< mocks::logging_visual<view> >(),
+					make_shared< mocks::logging_visual<view> >(), make_shared< mocks::logging_visual<view> >(),
+				};
+				placed_view pv[] = {
+					{	v[0], nullptr_nv, {	0, 0, 1000, 1000	},	},
+					{	v[1], nullptr_nv, {	500, 500, 600, 600	},	},
+					{	v[2], nullptr_nv, {	50, 50, 70, 70	},	},
+					{	v[3], nullptr_nv, {	900, 900, 1000, 1000	},	},
+				};
+
+				views = mkvector(pv);
+				v[3]->transcending = true;
+				vr.reload_views();
+
+				// ACT
+				gcontext ctx(surface, *renderer, *text_engine, make_vector(20, 20));
+				vr.draw(ctx, rasterizer);
+
+				// ASSERT
+				agge::rect_i reference0[] = {	{	20, 20, 120, 120	},	};
+				agge::rect_i reference2[] = {	{	0, 0, 20, 20	},	};
+
+				assert_equal(reference0, v[0]->update_area_log);
+				assert_is_empty(v[1]->update_area_log);
+				assert_equal(reference2, v[2]->update_area_log);
+				assert_equal(1u, v[3]->update_area_log.size());
+
+				// INIT
+				views[1].location = create_rect(10, 10, 30, 30);
+				v[0]->update_area_log.clear();
+				v[2]->update_area_log.clear();
+
+				// ACT
+				vr.reindex_views();
+				vr.draw(ctx, rasterizer);
+
+				// ASSERT
+				agge::rect_i reference1[] = {	{	10, 10, 20, 20	},	};
+
+				assert_equal(reference0, v[0]->update_area_log);
+				assert_equal(reference1, v[1]->update_area_log);
+				assert_equal(reference2, v[2]->update_area_log);
+			}
+
+
+			test( OnlyInvalidatedAreasAreDrawnWithIntersectingViews )
+			{
+				// INIT
+				visual_router vr(views, vrhost);
+				gcontext::surface_type surface(1000, 1000, 0);
+				shared_ptr< mocks::logging_visual<view> > v[] = {
+					make_shared< mocks::logging_visual<view> >(), make_shared< mocks::logging_visual<view> >(),
+					make_shared< mocks::logging_visual<view> >(),
+				};
+				placed_view pv[] = {
+					{	v[0], nullptr_nv, {	0, 0, 100, 100	},	},
+					{	v[1], nullptr_nv, {	200, 0, 300, 100	},	},
+					{	v[2], nullptr_nv, {	0, 200, 100, 300	},	},
+				};
+				const agge::rect_i area = {	10, 11, 20, 23	};
+
+				views = mkvector(pv);
+				vr.reload_views();
+				v[0]->invalidate(&area);
+				v[2]->invalidate(nullptr);
+
+				// ACT
+				gcontext ctx(surface, *renderer, *text_engine, agge::zero());
+				vr.draw(ctx, rasterizer);
+
+				// ASSERT
+				agge::rect_i reference0[] = {	{	10, 11, 20, 23	},	};
+				agge::rect_i reference2[] = {	{	0, 0, 100, 100	},	};
+
+				assert_equal(reference0, v[0]->update_area_log);
+				assert_is_empty(v[1]->update_area_log);
+				assert_equal(reference2, v[2]->update_area_log);
+
+				// INIT
+				v[0]->update_area_log.clear();
+				v[2]->update_area_log.clear();
+
+				// ACT (dirty region is consumed by drawing)
+				vr.draw(ctx, rasterizer);
+
+				// ASSERT
+				assert_equal(1u, v[0]->update_area_log.size());
+				assert_equal(1u, v[1]->update_area_log.size());
+				assert_equal(1u, v[2]->update_area_log.size());
+			}
+
+
+			test( InvalidatedAreasAreLimitedToUpdateArea )
+			{
+				// INIT
+				visual_router vr(views, vrhost);
+				gcontext::surface_type surface(50, 50, 0);
+				auto v = make_shared< mocks::logging_visual<view> >();
+				placed_view pv[] = {	{	v, nullptr_nv, {	0, 0, 300, 300	},	},	};
+				const agge::rect_i area1 = {	10, 10, 20, 20	};
+				const agge::rect_i area2 = {	140, 140, 160, 160	};
+
+				views = mkvector(pv);
+				vr.reload_views();
+				v->invalidate(&area1);
+				v->invalidate(&area2);
+
+				// ACT
+				gcontext ctx(surface, *renderer, *text_engine, make_vector(120, 120));
+				vr.draw(ctx, rasterizer);
+
+				// ASSERT
+				agge::rect_i reference[] = {	{	140, 140, 160, 160	},	};
+
+				assert_equal(reference, v->update_area_log);
+			}
+
+
+			test( HostInvalidatedAreasAreDrawnAlongWithViewInvalidations )
+			{
+				// INIT
+				visual_router vr(views, vrhost);
+				gcontext::surface_type surface(1000, 1000, 0);
+				shared_ptr< mocks::logging_visual<view> > v[] = {
+					make_shared< mocks::logging_visual<view> >(), make_shared< mocks::logging_visual<view> >(),
+				};
+				placed_view pv[] = {
+					{	v[0], nullptr_nv, {	0, 0, 100, 100	},	},
+					{	v[1], nullptr_nv, {	200, 0, 300, 100	},	},
+				};
+				const agge::rect_i area = {	1, 2, 3, 4	};
+				auto host_invalidations = 0;
+
+				views = mkvector(pv);
+				vrhost.on_invalidate = [&] (const agge::rect_i &) {	host_invalidations++;	};
+				vr.reload_views();
+				v[0]->invalidate(&area);
+
+				// ACT
+				vr.invalidate(create_rect(250, 50, 270, 60));
+				gcontext ctx(surface, *renderer, *text_engine, agge::zero());
+				vr.draw(ctx, rasterizer);
+
+				// ASSERT
+				agge::rect_i reference0[] = {	{	1, 2, 3, 4	},	};
+				agge::rect_i reference1[] = {	{	50, 50, 70, 60	},	};
+
+				assert_equal(1, host_invalidations);
+				assert_equal(reference0, v[0]->update_area_log);
+				assert_equal(reference1, v[1]->update_area_log);
+			}
+
+
+			test( CachedViewsAreRenderedOffscreenOnceUntilInvalidated )
+			{
+				// INIT
+				visual_router vr(views, vrhost);
+				gcontext::surface_type surface(100, 100, 0);
+				gcontext ctx(surface, *renderer, *text_engine, agge::zero());
+				shared_ptr< mocks::logging_visual<view> > v[] = {
+					make_shared< mocks::logging_visual<view> >(), make_shared< mocks::logging_visual<view> >(),
+				};
+				placed_view pv[] = {
+					{	v[0], nullptr_nv, {	10, 10, 30, 25	},	},
+					{	v[1], nullptr_nv, {	40, 10, 60, 20	},	},
+				};
+
+				v[0]->cached = true;
+				views = mkvector(pv);
+				vr.reload_views();
+
+				// ACT
+				vr.draw(ctx, rasterizer);
+				vr.draw(ctx, rasterizer);
+
+				// ASSERT
+				agge::rect_i reference1[] = {	{	0, 0, 20, 15	},	};
+				agge::rect_i reference2[] = {	{	0, 0, 20, 10	}, {	0, 0, 20, 10	},	};
+
+				assert_equal(reference1, v[0]->update_area_log);
+				assert_equal(reference2, v[1]->update_area_log);
+
+				// ACT
+				v[0]->invalidate(nullptr);
+				vr.draw(ctx, rasterizer);
+				vr.draw(ctx, rasterizer);
+
+				// ASSERT
+				agge::rect_i reference3[] = {	{	0, 0, 20, 15	}, {	0, 0, 20, 15	},	};
+
+				assert_equal(reference3, v[0]->update_area_log);
+			}
+
+
+			test( CachedViewsAreCompositedIntoUpdateArea )
+			{
+				// INIT
+				visual_router vr(views, vrhost);
+				agge::color color_o = agge::color::make(0, 0, 0);
+				gcontext::pixel_type o = make_pixel_real(color_o);
+				agge::color color_a = agge::color::make(255, 0, 0);
+				gcontext::pixel_type a = make_pixel_real(color_a);
+				agge::color color_b = agge::color::make(0, 255, 0);
+				gcontext::pixel_type b = make_pixel_real(color_b);
+				shared_ptr<view> v[] = {
+					make_shared< mocks::filling_visual<view> >(color_a),
+					make_shared< mocks::filling_visual<view> >(color_b),
+				};
+				placed_view pv[] = {
+					{	v[0], nullptr_nv, {	1, 1, 6, 4	},	},
+					{	v[1], nullptr_nv, {	4, 2, 8, 5	},	},
+				};
+				gcontext::surface_type surface(8, 5, 0);
+				gcontext ctx(surface, *renderer, *text_engine, agge::zero());
+
+				v[0]->cached = true;
+				v[1]->cached = true;
+				views = mkvector(pv);
+				vr.reload_views();
+				reset(surface, o);
+				vr.draw(ctx, rasterizer);
+				reset(surface, o);
+
+				// ACT
+				auto windowed = ctx.window(2, 0, 5, 5);
+
+				vr.draw(windowed, rasterizer);
+
+				// ASSERT
+				const gcontext::pixel_type reference[] = {
+					o, o, o, o, o, o, o, o,
+					o, o, a, a, a, o, o, o,
+					o, o, a, a, b, o, o, o,
+					o, o, a, a, b, o, o, o,
+					o, o, o, o, b, o, o, o,
+				};
+
+				assert_equal(reference, surface);
+			}
+
+
+			test( OpaqueBackgroundsAreRetainedInLayersAndCompositedFromThem )
+			{
+				// INIT
+				visual_router vr(views, vrhost);
+				stylesheet_db ss;
+				agge::color color_o = agge::color::make(0, 0, 0);
+				gcontext::pixel_type o = make_pixel_real(color_o);
+				agge::color color_a = agge::color::make(255, 0, 0);
+				gcontext::pixel_type a = make_pixel_real(color_a);
+				const auto bg = make_shared<controls::solid_background>();
+				placed_view pv[] = {	{	bg, nullptr_nv, {	1, 1, 4, 3	},	},	};
+				gcontext::surface_type surface(5, 4, 0);
+				gcontext ctx(surface, *renderer, *text_engine, agge::zero());
+
+				ss.set_color("background", color_a);
+				bg->apply_styles(ss);
+				views = mkvector(pv);
+				vr.reload_views();
+				reset(surface, o);
+
+				// ACT
+				vr.draw(ctx, rasterizer);
+
+				// ASSERT
+				assert_is_true(bg->cached);
+				assert_equal(3u * 2u * sizeof(gcontext::pixel_type), vr.get_layers().size());
+
+				// INIT
+				reset(surface, o);
+				vr.invalidate(create_rect(0, 0, 5, 4));
+
+				// ACT
+				vr.draw(ctx, rasterizer);
+
+				// ASSERT
+				const gcontext::pixel_type reference[] = {
+					o, o, o, o, o,
+					o, a, a, a, o,
+					o, a, a, a, o,
+					o, o, o, o, o,
+				};
+
+				assert_equal(reference, surface);
+				assert_equal(3u * 2u * sizeof(gcontext::pixel_type), vr.get_layers().size());
+
+				// INIT
+				ss.set_color("background", agge::color::make(255, 0, 0, 128));
+
+				// ACT
+				bg->apply_styles(ss);
+
+				// ASSERT
+				assert_is_false(bg->cached);
+			}
+
+
+			test( ScrolledViewPixelsAreMovedByHostAndOnlyExposedAreasAreRedrawn )
+			{
+				// INIT
+				visual_router vr(views, vrhost);
+				gcontext::surface_type surface(200, 100, 0);
+				gcontext ctx(surface, *renderer, *text_engine, agge::zero());
+				const auto v = make_shared< mocks::logging_visual<view> >();
+				placed_view pv[] = {	{	v, nullptr_nv, {	10, 20, 110, 60	},	},	};
+				vector<agge::rect_i> scrolled, invalidated;
+				vector< pair<int, int> > deltas;
+
+				views = mkvector(pv);
+				vr.reload_views();
+				vrhost.on_scroll = [&] (const agge::rect_i &area, int dx, int dy) -> bool {
+					scrolled.push_back(area);
+					deltas.push_back(make_pair(dx, dy));
+					return true;
+				};
+				vrhost.on_invalidate = [&] (const agge::rect_i &area) {	invalidated.push_back(area);	};
+
+				// ACT
+				v->scroll(0, -7);
+
+				// ASSERT
+				agge::rect_i reference1[] = {	{	10, 20, 110, 60	},	};
+				pair<int, int> reference2[] = {	make_pair(0, -7),	};
+				agge::rect_i reference3[] = {	{	10, 53, 110, 60	},	};
+
+				assert_equal(reference1, scrolled);
+				assert_equal(reference2, deltas);
+				assert_equal(reference3, invalidated);
+
+				// ACT
+				vr.draw(ctx, rasterizer);
+
+				// ASSERT
+				agge::rect_i reference4[] = {	{	0, 33, 100, 40	},	};
+
+				assert_equal(reference4, v->update_area_log);
+
+				// INIT
+				invalidated.clear();
+
+				// ACT
+				v->scroll(5, 3);
+
+				// ASSERT
+				agge::rect_i reference5[] = {	{	10, 20, 15, 60	}, {	10, 20, 110, 23	},	};
+
+				assert_equal(reference5, invalidated);
+			}
+
+
+			test( ScrollingFallsBackToFullInvalidationWhenPixelsCannotBeReused )
+			{
+				// INIT
+				visual_router vr(views, vrhost);
+				gcontext::surface_type surface(200, 100, 0);
+				gcontext ctx(surface, *renderer, *text_engine, agge::zero());
+				shared_ptr< mocks::logging_visual<view> > v[] = {
+					make_shared< mocks::logging_visual<view> >(), make_shared< mocks::logging_visual<view> >(),
+				};
+				placed_view pv[] = {
+					{	v[0], nullptr_nv, {	10, 20, 110, 60	},	},
+					{	v[1], nullptr_nv, {	120, 20, 140, 60	},	},
+				};
+				auto scrolls = 0;
+				auto host_scrolls = true;
+				vector<agge::rect_i> invalidated;
+
+				views = mkvector(pv);
+				vr.reload_views();
+				vrhost.on_scroll = [&] (const agge::rect_i &, int, int) -> bool {
+					scrolls++;
+					return host_scrolls;
+				};
+				vrhost.on_invalidate = [&] (const agge::rect_i &area) {	invalidated.push_back(area);	};
+
+				// ACT (too far)
+				v[0]->scroll(0, 40);
+				v[0]->scroll(-100, 0);
+				vr.draw(ctx, rasterizer);
+
+				// ACT (pending damage)
+				v[0]->invalidate(nullptr);
+				v[0]->scroll(0, 1);
+				vr.draw(ctx, rasterizer);
+
+				// ASSERT
+				agge::rect_i reference1[] = {
+					{	10, 20, 110, 60	}, {	10, 20, 110, 60	}, {	10, 20, 110, 60	}, {	10, 20, 110, 60	},
+				};
+
+				assert_equal(0, scrolls);
+				assert_equal(reference1, invalidated);
+
+				// INIT
+				invalidated.clear();
+				host_scrolls = false;
+
+				// ACT (host is unable to scroll)
+				v[0]->scroll(0, 1);
+				vr.draw(ctx, rasterizer);
+
+				// ASSERT
+				agge::rect_i reference2[] = {	{	10, 20, 110, 60	},	};
+
+				assert_equal(1, scrolls);
+				assert_equal(reference2, invalidated);
+
+				// INIT
+				invalidated.clear();
+				host_scrolls = true;
+				views[1].location = create_rect(100, 50, 140, 60);
+				vr.reindex_views();
+
+				// ACT (overlapped by a view on top)
+				v[0]->scroll(0, 1);
+
+				// ASSERT
+				assert_equal(1, scrolls);
+				assert_equal(reference2, invalidated);
+
+				// INIT
+				invalidated.clear();
+				vr.draw(ctx, rasterizer);
+
+				// ACT (the view on top may scroll)
+				v[1]->scroll(0, 1);
+
+				// ASSERT
+				agge::rect_i reference3[] = {	{	100, 50, 140, 51	},	};
+
+				assert_equal(2, scrolls);
+				assert_equal(reference3, invalidated);
+			}
+
+
+			test( UpdateAreaIsDrawnInBandsWhenAllViewsAreConcurrent )
+			{
+				// INIT
+				visual_router vr(views, vrhost);
+				gcontext::surface_type surface(200, 300, 0);
+				gcontext ctx(surface, *renderer, *text_engine, agge::zero());
+				shared_ptr<concurrent_logging_view> v[] = {
+					make_shared<concurrent_logging_view>(), make_shared<concurrent_logging_view>(),
+				};
+				placed_view pv[] = {
+					{	v[0], nullptr_nv, {	0, 0, 200, 300	},	},
+					{	v[1], nullptr_nv, {	50, 100, 150, 150	},	},
+				};
+
+				views = mkvector(pv);
+				vr.reload_views();
+				vr.set_draw_pool(make_shared<draw_pool>(4));
+
+				// ACT
+				auto windowed = ctx.window(0, 0, 200, 256);
+
+				vr.draw(windowed, rasterizer);
+
+				// ASSERT
+				agge::rect_i reference1[] = {
+					{	0, 0, 200, 64	}, {	0, 64, 200, 128	}, {	0, 128, 200, 192	}, {	0, 192, 200, 256	},
+				};
+				agge::rect_i reference2[] = {	{	0, 0, 100, 28	}, {	0, 28, 100, 50	},	};
+
+				assert_equal(reference1, v[0]->get_log());
+				assert_equal(reference2, v[1]->get_log());
+			}
+
+
+			test( TextEngineIsLockedForViewsDrawnInConcurrentBandsOnly )
+			{
+				// INIT
+				visual_router vr1(views, vrhost), vr2(views, vrhost);
+				gcontext::surface_type surface(200, 256, 0);
+				gcontext ctx(surface, *renderer, *text_engine, agge::zero());
+				const auto v = make_shared<text_locking_view>();
+				placed_view pv[] = {	{	v, nullptr_nv, {	0, 0, 200, 256	},	},	};
+
+				views = mkvector(pv);
+				vr1.reload_views();
+				vr2.reload_views();
+				vr1.set_draw_pool(make_shared<draw_pool>(4));
+
+				// ACT
+				vr1.draw(ctx, rasterizer);
+
+				// ASSERT
+				assert_equal(4, v->locked.load());
+				assert_equal(0, v->unlocked.load());
+
+				// ACT
+				vr2.draw(ctx, rasterizer);
+
+				// ASSERT
+				assert_equal(4, v->locked.load());
+				assert_equal(1, v->unlocked.load());
+			}
+
+
+			test( BandsCrossedByNonConcurrentViewsAreDrawnSequentially )
+			{
+				// INIT
+				visual_router vr(views, vrhost);
+				gcontext::surface_type surface(200, 300, 0);
+				gcontext ctx(surface, *renderer, *text_engine, agge::zero());
+				const auto v1 = make_shared<concurrent_logging_view>();
+				const auto v2 = make_shared< mocks::logging_visual<view> >();
+				placed_view pv[] = {
+					{	v1, nullptr_nv, {	0, 0, 200, 300	},	},
+					{	v2, nullptr_nv, {	0, 290, 10, 300	},	},
+				};
+
+				views = mkvector(pv);
+				vr.reload_views();
+				vr.set_draw_pool(make_shared<draw_pool>(4));
+
+				// ACT
+				auto windowed = ctx.window(0, 0, 200, 127);
+
+				vr.draw(ctx, rasterizer);
+				vr.draw(windowed, rasterizer);
+
+				// ASSERT
+				agge::rect_i reference1[] = {
+					{	0, 0, 200, 75	}, {	0, 0, 200, 127	}, {	0, 75, 200, 150	}, {	0, 150, 200, 225	},
+					{	0, 225, 200, 300	},
+				};
+				agge::rect_i reference2[] = {	{	0, 0, 10, 10	},	};
+
+				assert_equal(reference1, v1->get_log());
+				assert_equal(reference2, v2->update_area_log);
+			}
+
+
+			test( UpdateAreaIsDrawnSequentiallyIfFewerThanTwoBandsAreConcurrent )
+			{
+				// INIT
+				visual_router vr(views, vrhost);
+				gcontext::surface_type surface(200, 300, 0);
+				gcontext ctx(surface, *renderer, *text_engine, agge::zero());
+				const auto v1 = make_shared<concurrent_logging_view>();
+				const auto v2 = make_shared< mocks::logging_visual<view> >();
+				placed_view pv[] = {
+					{	v1, nullptr_nv, {	0, 0, 200, 300	},	},
+					{	v2, nullptr_nv, {	0, 10, 10, 250	},	},
+				};
+
+				views = mkvector(pv);
+				vr.reload_views();
+				vr.set_draw_pool(make_shared<draw_pool>(4));
+
+				// ACT
+				vr.draw(ctx, rasterizer);
+
+				// ASSERT
+				agge::rect_i reference[] = {	{	0, 0, 200, 300	},	};
+
+				assert_equal(reference, v1->get_log());
+				assert_equal(1u, v2->update_area_log.size());
+			}
+
+
+			test( BandedDrawingProducesTheSameImageAsSequential )
+			{
+				// INIT
+				visual_router vr1(views, vrhost), vr2(views, vrhost);
+				gcontext::surface_type surface1(100, 200, 0), surface2(100, 200, 0);
+				gcontext ctx1(surface1, *renderer, *text_engine, agge::zero());
+				gcontext ctx2(surface2, *renderer, *text_engine, agge::zero());
+				shared_ptr<view> v[] = {
+					make_shared< mocks::filling_visual<view> >(agge::color::make(255, 0, 0)),
+					make_shared< mocks::filling_visual<view> >(agge::color::make(0, 255, 0)),
+					make_shared< mocks::filling_visual<view> >(agge::color::make(0, 0, 255)),
+				};
+				placed_view pv[] = {
+					{	v[0], nullptr_nv, {	0, 0, 100, 200	},	},
+					{	v[1], nullptr_nv, {	10, 30, 70, 170	},	},
+					{	v[2], nullptr_nv, {	50, 60, 90, 190	},	},
+				};
+
+				for (auto i = begin(v); i != end(v); ++i)
+					(*i)->concurrent_draw = true;
+				v[1]->cached = true;
+				views = mkvector(pv);
+				vr1.reload_views();
+				vr2.reload_views();
+				vr2.set_draw_pool(make_shared<draw_pool>(3));
+
+				// ACT
+				vr1.draw(ctx1, rasterizer);
+				vr2.draw(ctx2, rasterizer);
+
+				// ASSERT
+				for (agge::count_t y = 0; y != surface1.height(); ++y)
+				{
+					for (agge::count_t x = 0; x != surface1.width(); ++x)
+						assert_equal(surface1.row_ptr(y)[x], surface2.row_ptr(y)[x]);
+				}
+			}
+
+
+
+			test( ProfiledFramesRecordDrawnViewsRenderCallsAndInvalidations )
+			{
+				// INIT
+				const auto profiler = make_shared<frame_profiler>();
+				visual_router vr(views, vrhost);
+				gcontext::surface_type surface(100, 100, 0);
+				gcontext ctx(surface, *renderer, *text_engine, agge::zero());
+				const auto v1 = make_shared< mocks::logging_visual<view> >();
+				const auto v2 = make_shared< mocks::logging_visual<view> >();
+				placed_view pv[] = {
+					{ v1, nullptr_nv, { 0, 0, 50, 100 }	},
+					{ v2, nullptr_nv, { 50, 0, 100, 100 }	},
+				};
+				vector<frame_record> log;
+				auto c = profiler->frame_completed += [&] (const frame_record &f) {	log.push_back(f);	};
+
+				views.assign(begin(pv), end(pv));
+				vr.reload_views();
+				vr.set_profiler(profiler);
+
+				// ACT
+				vr.draw(ctx, rasterizer);
+
+				// ASSERT
+				assert_equal(1u, log.size());
+				assert_equal(2u, log[0].render_calls);
+				assert_equal(0u, log[0].invalidations);
+				assert_equal(2u, log[0].views.size());
+				assert_equal(0u, log[0].views[0].index);
+				assert_equal(1u, log[0].views[1].index);
+
+				// INIT
+				const agge::rect_i area = { 1, 2, 3, 4 };
+
+				v2->invalidate(nullptr);
+				v2->invalidate(&area);
+
+				// ACT
+				vr.draw(ctx, rasterizer);
+
+				// ASSERT
+				assert_equal(2u, log.size());
+				assert_equal(2u, log[1].invalidations);
+				assert_equal(1u, log[1].render_calls);
+				assert_equal(1u, log[1].views.size());
+				assert_equal(1u, log[1].views[0].index);
+			}
+
+
+			test( ViewsDrawnInBandsAreProfiledOncePerFrame )
+			{
+				// INIT
+				const auto profiler = make_shared<frame_profiler>();
+				visual_router vr(views, vrhost);
+				gcontext::surface_type surface(100, 256, 0);
+				gcontext ctx(surface, *renderer, *text_engine, agge::zero());
+				shared_ptr<view> v[] = {
+					make_shared< mocks::filling_visual<view> >(agge::color::make(255, 0, 0)),
+					make_shared< mocks::filling_visual<view> >(agge::color::make(0, 255, 0)),
+				};
+				placed_view pv[] = {
+					{	v[0], nullptr_nv, {	0, 0, 100, 256	},	},
+					{	v[1], nullptr_nv, {	10, 30, 70, 200	},	},
+				};
+				vector<frame_record> log;
+				auto c = profiler->frame_completed += [&] (const frame_record &f) {	log.push_back(f);	};
+
+				for (auto i = begin(v); i != end(v); ++i)
+					(*i)->concurrent_draw = true;
+				v[1]->cached = true;
+				views = mkvector(pv);
+				vr.reload_views();
+				vr.set_draw_pool(make_shared<draw_pool>(4));
+				vr.set_profiler(profiler);
+
+				// ACT
+				vr.draw(ctx, rasterizer);
+
+				// ASSERT
+				assert_equal(1u, log.size());
+				assert_equal(2u, log[0].views.size());
+				assert_equal(0u, log[0].views[0].index);
+				assert_equal(1u, log[0].views[1].index);
+			}
 		end_test_suite
 	}
 }
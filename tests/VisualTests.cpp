@@ -4,7 +4,9 @@
 #include <tests/common/helpers-visual.h>
 
 #include <agge/blenders_generic.h>
+#include <agge/figures.h>
 #include <agge/filling_rules.h>
+#include <agge/path.h>
 #include <ut/assert.h>
 #include <ut/test.h>
 
@@ -42,6 +44,26 @@ namespace wpl
 			}
 
 
+			test( VisualIsNotCachedByDefault )
+			{
+				// INIT
+				visual v;
+
+				// ACT / ASSERT
+				assert_is_false(v.cached);
+			}
+
+
+			test( VisualDrawIsNotConcurrentByDefault )
+			{
+				// INIT
+				visual v;
+
+				// ACT / ASSERT
+				assert_is_false(v.concurrent_draw);
+			}
+
+
 			test( ImageIsDrawnAtCoordinatesUnchangedNoOffsetNoWindow )
 			{
 				// INIT
@@ -258,6 +280,179 @@ namespace wpl
 
 				assert_equal(reference2, s);
 			}
+
+
+			test( BlitCopiesSourcePixelsClippedByWindowAndSurface )
+			{
+				// INIT
+				gcontext::surface_type s(8, 8, 0);
+				gcontext::surface_type source(3, 3, 0);
+				gcontext ctx(s, *renderer, *text_engine, agge::zero());
+
+				reset(s, o);
+				reset(source, x);
+
+				// ACT
+				ctx.window(1, 2, 7, 8).blit(source, 5, 1);
+
+				// ASSERT
+				const gcontext::pixel_type reference1[] = {
+					o, o, o, o, o, o, o, o,
+					o, o, o, o, o, o, o, o,
+					o, o, o, o, o, x, x, o,
+					o, o, o, o, o, x, x, o,
+					o, o, o, o, o, o, o, o,
+					o, o, o, o, o, o, o, o,
+					o, o, o, o, o, o, o, o,
+					o, o, o, o, o, o, o, o,
+				};
+
+				assert_equal(reference1, s);
+
+				// INIT
+				reset(s, o);
+
+				// ACT
+				ctx.translate(1, -1).window(1, 0, 6, 5).blit(source, 3, 0);
+
+				// ASSERT
+				const gcontext::pixel_type reference2[] = {
+					o, o, o, o, x, x, x, o,
+					o, o, o, o, x, x, x, o,
+					o, o, o, o, o, o, o, o,
+					o, o, o, o, o, o, o, o,
+					o, o, o, o, o, o, o, o,
+					o, o, o, o, o, o, o, o,
+					o, o, o, o, o, o, o, o,
+					o, o, o, o, o, o, o, o,
+				};
+
+				assert_equal(reference2, s);
+
+				// INIT
+				reset(s, o);
+
+				// ACT
+				ctx.blit(source, -2, 6);
+
+				// ASSERT
+				const gcontext::pixel_type reference3[] = {
+					o, o, o, o, o, o, o, o,
+					o, o, o, o, o, o, o, o,
+					o, o, o, o, o, o, o, o,
+					o, o, o, o, o, o, o, o,
+					o, o, o, o, o, o, o, o,
+					o, o, o, o, o, o, o, o,
+					x, o, o, o, o, o, o, o,
+					x, o, o, o, o, o, o, o,
+				};
+
+				assert_equal(reference3, s);
+			}
+
+
+			test( AlignedFillSetsPixelsClippedByWindowAndSurface )
+			{
+				// INIT
+				gcontext::surface_type s(8, 8, 0);
+				gcontext ctx(s, *renderer, *text_engine, agge::zero());
+				gcontext::rasterizer_ptr ras(new gcontext::rasterizer_type);
+
+				reset(s, o);
+
+				// ACT
+				ctx.fill(ras, create_rect(1.0f, 2.0f, 4.0f, 5.0f), blender_t(color_x));
+				ctx.fill(ras, create_rect(6.0f, 6.0f, 10.0f, 10.0f), blender_t(color_x));
+
+				// ASSERT
+				const gcontext::pixel_type reference1[] = {
+					o, o, o, o, o, o, o, o,
+					o, o, o, o, o, o, o, o,
+					o, x, x, x, o, o, o, o,
+					o, x, x, x, o, o, o, o,
+					o, x, x, x, o, o, o, o,
+					o, o, o, o, o, o, o, o,
+					o, o, o, o, o, o, x, x,
+					o, o, o, o, o, o, x, x,
+				};
+
+				assert_equal(reference1, s);
+
+				// INIT
+				reset(s, o);
+
+				// ACT
+				gcontext ctx2 = ctx.translate(1, -1).window(1, 0, 6, 5);
+
+				ctx2.fill(ras, create_rect(0.0f, 0.0f, 3.0f, 3.0f), blender_t(color_x));
+				ctx2.fill(ras, create_rect(4.0f, 4.0f, 8.0f, 6.0f), blender_t(color_x));
+
+				// ASSERT
+				const gcontext::pixel_type reference2[] = {
+					o, o, x, x, o, o, o, o,
+					o, o, x, x, o, o, o, o,
+					o, o, o, o, o, o, o, o,
+					o, o, o, o, o, x, x, o,
+					o, o, o, o, o, o, o, o,
+					o, o, o, o, o, o, o, o,
+					o, o, o, o, o, o, o, o,
+					o, o, o, o, o, o, o, o,
+				};
+
+				assert_equal(reference2, s);
+			}
+
+
+			test( FillWithFractionalEdgesMatchesRasterizedRectangle )
+			{
+				const rect_r areas[] = {
+					create_rect(0.5f, 1.0f, 3.0f, 2.5f),
+					create_rect(0.25f, 0.75f, 4.5f, 5.25f),
+					create_rect(1.25f, 0.0f, 1.75f, 3.0f),
+					create_rect(-1.5f, 2.5f, 7.5f, 3.25f),
+				};
+
+				for (auto i = begin(areas); i != end(areas); ++i)
+				{
+					// INIT
+					gcontext::surface_type s(6, 6, 0), reference(6, 6, 0);
+					gcontext ctx(s, *renderer, *text_engine, agge::zero());
+					gcontext ctx_reference(reference, *renderer, *text_engine, agge::zero());
+					gcontext::rasterizer_ptr ras(new gcontext::rasterizer_type);
+
+					reset(s, o);
+					reset(reference, o);
+					add_path(*ras, agge::rectangle(i->x1, i->y1, i->x2, i->y2));
+					ctx_reference(ras, blender_t(color_x), winding<>());
+
+					// ACT
+					ctx.fill(ras, *i, blender_t(color_x));
+
+					// ASSERT
+					for (unsigned y = 0; y != s.height(); ++y)
+					{
+						for (unsigned x_ = 0; x_ != s.width(); ++x_)
+							assert_is_true(reference.row_ptr(y)[x_] == s.row_ptr(y)[x_]);
+					}
+				}
+			}
+
+
+			test( DirectFillIsAccountedInRenderCounters )
+			{
+				// INIT
+				gcontext::surface_type s(8, 8, 0);
+				render_counters counters = {};
+				gcontext ctx = gcontext(s, *renderer, *text_engine, agge::zero()).with_counters(&counters);
+				gcontext::rasterizer_ptr ras(new gcontext::rasterizer_type);
+
+				// ACT
+				ctx.fill(ras, create_rect(1.0f, 2.0f, 4.0f, 5.0f), blender_t(color_x));
+
+				// ASSERT
+				assert_equal(1u, counters.calls.load());
+				assert_equal(9u, counters.area.load());
+			}
 		end_test_suite
 	}
 }
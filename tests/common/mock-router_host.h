@@ -25,9 +25,11 @@ namespace wpl
 			{
 			public:
 				std::function<void (const agge::rect_i &area)> on_invalidate;
+				std::function<bool (const agge::rect_i &area, int dx, int dy)> on_scroll;
 
 			private:
 				virtual void invalidate(const agge::rect_i &area) override;
+				virtual bool scroll(const agge::rect_i &area, int dx, int dy) override;
 			};
 
 
@@ -63,6 +65,9 @@ namespace wpl
 					on_invalidate(area);
 			}
 
+			inline bool visual_router_host::scroll(const agge::rect_i &area, int dx, int dy)
+			{	return on_scroll ? on_scroll(area, dx, dy) : false;	}
+
 
 			inline void mouse_router_host::request_focus(std::shared_ptr<keyboard_input> input)
 			{
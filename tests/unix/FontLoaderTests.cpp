@@ -0,0 +1,702 @@
+#include <wpl/freetype2/font_loader.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <fcntl.h>
+#include <fstream>
+#include <ftw.h>
+#include <future>
+#include <map>
+#include <stdexcept>
+#include <stdlib.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <utime.h>
+#include <ut/assert.h>
+#include <ut/test.h>
+
+using namespace std;
+
+namespace wpl
+{
+	namespace tests
+	{
+		namespace
+		{
+			class temporary_directory : noncopyable
+			{
+			public:
+				temporary_directory()
+				{
+					char path[] = "/tmp/wpl.tests.XXXXXX";
+
+					if (!::mkdtemp(path))
+						throw runtime_error("Cannot create a temporary directory!");
+					_path = path;
+				}
+
+				~temporary_directory()
+				{
+					::nftw(_path.c_str(), [] (const char *path, const struct stat *, int, struct FTW *) {
+						return ::remove(path);
+					}, 16, FTW_DEPTH | FTW_PHYS);
+				}
+
+				string make_directory(const string &relative) const
+				{
+					const auto path = _path + "/" + relative;
+
+					::mkdir(path.c_str(), 0700);
+					return path;
+				}
+
+				string make_file(const string &relative) const
+				{
+					const auto path = _path + "/" + relative;
+
+					::close(::open(path.c_str(), O_CREAT | O_WRONLY, 0600));
+					return path;
+				}
+
+				const string &path() const
+				{	return _path;	}
+
+			private:
+				string _path;
+			};
+
+			void put16(string &data, unsigned value)
+			{	data += static_cast<char>(value >> 8 & 0xFF), data += static_cast<char>(value & 0xFF);	}
+
+			void put32(string &data, unsigned value)
+			{	put16(data, value >> 16), put16(data, value & 0xFFFF);	}
+
+			void put16(string &data, const unsigned *values, size_t count)
+			{
+				while (count--)
+					put16(data, *values++);
+			}
+
+			// Returns the tables of a TrueType font of the family given with a single square glyph mapped to 'A'.
+			map<string, string> create_font_tables(const string &family)
+			{
+				const string style = "Regular";
+				const unsigned head[] = {	0x000B, 1000, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 500, 700, 0, 8, 2, 0, 0,	};
+				const unsigned hhea[] = {	800, 0x10000 - 200, 0, 500, 0, 0, 500, 1, 0, 0, 0, 0, 0, 0, 0, 2,	};
+				const unsigned maxp[] = {	2, 4, 1, 0, 0, 2, 0, 0, 0, 0, 0, 0, 0, 0,	};
+				const unsigned glyf[] = {	1, 0, 0, 500, 700, 3, 0, 0x0101, 0x0101, 0, 500, 0, 0x10000 - 500, 0, 0, 700, 0,	};
+				const unsigned loca[] = {	0, 0, 17,	};
+				const unsigned hmtx[] = {	500, 0, 500, 0,	};
+				const unsigned cmap[] = {	0, 1, 3, 1, 0, 12, 4, 32, 0, 4, 4, 1, 0, 'A', 0xFFFF, 0, 'A', 0xFFFF,
+					0x10000 + 1 - 'A', 1, 0, 0,	};
+				map<string, string> tables;
+
+				put32(tables["head"], 0x10000), put32(tables["head"], 0x10000), put32(tables["head"], 0);
+				put32(tables["head"], 0x5F0F3CF5), put16(tables["head"], head, 19);
+				put32(tables["hhea"], 0x10000), put16(tables["hhea"], hhea, 16);
+				put32(tables["maxp"], 0x10000), put16(tables["maxp"], maxp, 14);
+				put16(tables["glyf"], glyf, 17);
+				put16(tables["loca"], loca, 3);
+				put16(tables["hmtx"], hmtx, 4);
+				put16(tables["cmap"], cmap, 22);
+				put32(tables["post"], 0x30000);
+				tables["post"].resize(32);
+
+				auto &name = tables["name"];
+
+				put16(name, 0), put16(name, 2), put16(name, 30);
+				put16(name, 3), put16(name, 1), put16(name, 0x409), put16(name, 1);
+				put16(name, static_cast<unsigned>(2 * family.size())), put16(name, 0);
+				put16(name, 3), put16(name, 1), put16(name, 0x409), put16(name, 2);
+				put16(name, static_cast<unsigned>(2 * style.size())), put16(name, static_cast<unsigned>(2 * family.size()));
+				for (auto i = family.begin(); i != family.end(); ++i)
+					put16(name, static_cast<unsigned char>(*i));
+				for (auto i = style.begin(); i != style.end(); ++i)
+					put16(name, static_cast<unsigned char>(*i));
+				return tables;
+			}
+
+			void write_font_file(const string &path, const map<string, string> &tables, unsigned version = 0x10000)
+			{
+				auto offset = 12 + 16 * static_cast<unsigned>(tables.size());
+				string data;
+
+				put32(data, version), put16(data, static_cast<unsigned>(tables.size())), put16(data, 128);
+				put16(data, 3), put16(data, 16 * static_cast<unsigned>(tables.size()) - 128);
+				for (auto i = tables.begin(); i != tables.end(); ++i)
+				{
+					data += i->first, put32(data, 0), put32(data, offset);
+					put32(data, static_cast<unsigned>(i->second.size()));
+					offset += (static_cast<unsigned>(i->second.size()) + 3) & ~3u;
+				}
+				for (auto i = tables.begin(); i != tables.end(); ++i)
+					data += i->second, data.resize((data.size() + 3) & ~static_cast<size_t>(3));
+				ofstream(path.c_str(), ios_base::binary).write(data.data(), static_cast<streamsize>(data.size()));
+			}
+
+			void write_font(const string &path, const string &family)
+			{	write_font_file(path, create_font_tables(family));	}
+
+			// The glyph for 'A' is a quadratic arc from (0, 0) via (500, 1000) to (1000, 0), closed by a line.
+			void write_quadratic_font(const string &path, const string &family)
+			{
+				auto tables = create_font_tables(family);
+				auto &glyf = tables["glyf"];
+				const unsigned loca[] = {	0, 0, 15,	};
+
+				glyf.clear(), tables["loca"].clear();
+				put16(glyf, 1), put16(glyf, 0), put16(glyf, 0), put16(glyf, 1000), put16(glyf, 1000);
+				put16(glyf, 2), put16(glyf, 0);
+				glyf += '\x01', glyf += '\x00', glyf += '\x01'; // On, off and on the curve, coordinates are words.
+				put16(glyf, 0), put16(glyf, 500), put16(glyf, 500);
+				put16(glyf, 0), put16(glyf, 1000), put16(glyf, 0x10000 - 1000);
+				glyf.resize(30);
+				put16(tables["loca"], loca, 3);
+				write_font_file(path, tables);
+			}
+
+			// The glyph for 'A' is a cubic arc from (0, 0) via (0, 700) and (1000, 700) to (1000, 0), closed by a line.
+			void write_cubic_font(const string &path, const string &family)
+			{
+				const int deltas[] = {	0, 700, 1000, 0, 0, -700,	};
+				auto tables = create_font_tables(family);
+				string charstring, top_dict, private_dict, cff;
+
+				// 'OTTO' fonts have their outlines in a CFF table (with charstrings in Type 2 format).
+				tables.erase("glyf"), tables.erase("loca");
+				tables["maxp"].clear();
+				put32(tables["maxp"], 0x5000), put16(tables["maxp"], 2);
+				charstring += '\x8B', charstring += '\x8B', charstring += '\x15'; // 0 0 rmoveto
+				for (auto i = begin(deltas); i != end(deltas); ++i)
+					charstring += '\x1C', put16(charstring, static_cast<unsigned>(*i) & 0xFFFF);
+				charstring += '\x08', charstring += '\x0E'; // rrcurveto endchar
+				private_dict += "\x8B\x14\x8B\x15"; // 0 defaultWidthX 0 nominalWidthX
+
+				const auto charstrings_size = 2 + 1 + 3 + 1 + static_cast<unsigned>(charstring.size());
+				const unsigned charstrings_offset = 4 + 9 + 22 + 2 + 2;
+				const unsigned private_offset = charstrings_offset + charstrings_size;
+
+				top_dict += '\x1D', put32(top_dict, charstrings_offset), top_dict += '\x11';
+				top_dict += '\x1D', put32(top_dict, static_cast<unsigned>(private_dict.size()));
+				top_dict += '\x1D', put32(top_dict, private_offset), top_dict += '\x12';
+				cff += string("\x01\x00\x04\x01", 4);
+				cff += string("\x00\x01\x01\x01\x05", 5) + "Test";
+				cff += string("\x00\x01\x01\x01", 4) + static_cast<char>(1 + top_dict.size()) + top_dict;
+				cff += string("\x00\x00\x00\x00", 4); // No strings, no global subroutines.
+				cff += string("\x00\x02\x01\x01\x02", 5) + static_cast<char>(2 + charstring.size());
+				cff += '\x0E' + charstring; // .notdef is a bare endchar.
+				cff += private_dict;
+				tables["CFF "] = cff;
+				write_font_file(path, tables, 0x4F54544F);
+			}
+
+			// Rewrites the font keeping its stamp (size and modification time), so that only its content tells it.
+			void rewrite_font(const string &path, const string &family)
+			{
+				struct stat info;
+				utimbuf times;
+
+				::stat(path.c_str(), &info);
+				write_font(path, family);
+				times.actime = info.st_atime, times.modtime = info.st_mtime;
+				::utime(path.c_str(), &times);
+			}
+
+			void truncate_file(const string &path)
+			{
+				struct stat info;
+
+				::stat(path.c_str(), &info);
+				::truncate(path.c_str(), info.st_size / 2);
+			}
+
+			string loaded_family(font_loader &loader, const string &family)
+			{
+				const auto accessor = loader.load(agge::font_descriptor::create(family, 10));
+
+				return accessor ? accessor->get_descriptor().family : "<none>";
+			}
+
+			class gate : noncopyable
+			{
+			public:
+				gate()
+					: _open(false)
+				{	}
+
+				void wait()
+				{
+					unique_lock<mutex> l(_mtx);
+
+					_opened.wait(l, [this] {	return _open;	});
+				}
+
+				void open()
+				{
+					lock_guard<mutex> l(_mtx);
+
+					_open = true;
+					_opened.notify_all();
+				}
+
+			private:
+				mutex _mtx;
+				condition_variable _opened;
+				bool _open;
+			};
+
+			// Opens the gate on scope exit, so that the loader destroyed before it does not wait for it forever.
+			class gate_opener : noncopyable
+			{
+			public:
+				gate_opener(shared_ptr<gate> gate_)
+					: _gate(gate_)
+				{	}
+
+				~gate_opener()
+				{	_gate->open();	}
+
+			private:
+				shared_ptr<gate> _gate;
+			};
+
+			// Lists the paths given, stalling before the one at 'stall_at' (or before the end) until the gate opens.
+			font_loader::enum_font_files_cb gated_enumerator(const vector<string> &paths, size_t stall_at,
+				shared_ptr<gate> gate_)
+			{
+				const auto next = make_shared<size_t>(0);
+
+				return [paths, stall_at, gate_, next] (string &path) -> bool {
+					if (*next == stall_at)
+						gate_->wait();
+					if (*next == paths.size())
+						return false;
+					path = paths[(*next)++];
+					return true;
+				};
+			}
+
+			bool is_blocked(const future<string> &result)
+			{	return future_status::timeout == result.wait_for(chrono::milliseconds(50));	}
+
+			agge::glyph::outline_ptr load_outline(font_loader &loader, const string &family, int height)
+			{
+				const auto accessor = loader.load(agge::font_descriptor::create(family, height));
+				agge::glyph::glyph_metrics m;
+
+				return accessor->load_glyph(accessor->get_glyph_index('A'), m);
+			}
+
+			size_t count_lines(const agge::glyph::outline_storage &outline)
+			{
+				return static_cast<size_t>(count_if(outline.begin(), outline.end(),
+					[] (const agge::glyph::path_point &p) {	return agge::path_command_line_to == p.command;	}));
+			}
+
+			double distance(double x, double y, double x1, double y1, double x2, double y2)
+			{
+				const auto dx = x2 - x1, dy = y2 - y1;
+				const auto t = (max)(0.0, (min)(1.0, ((x - x1) * dx + (y - y1) * dy) / (dx * dx + dy * dy)));
+
+				return hypot(x - x1 - t * dx, y - y1 - t * dy);
+			}
+
+			// Returns the largest distance of the curve from the polyline it was flattened into by even parameter steps.
+			template <typename CurveT>
+			double max_deviation(const agge::glyph::outline_storage &outline, const CurveT &curve)
+			{
+				const auto n = count_lines(outline);
+				auto deviation = 0.0;
+
+				for (size_t i = 0; i != n; ++i)
+				{
+					for (auto j = 1; j != 16; ++j)
+					{
+						double x, y;
+
+						curve((static_cast<double>(i) + j / 16.0) / static_cast<double>(n), x, y);
+						deviation = (max)(deviation, distance(x, y, outline[i].x, outline[i].y, outline[i + 1].x,
+							outline[i + 1].y));
+					}
+				}
+				return deviation;
+			}
+
+			vector<string> enumerate(const vector<string> &directories)
+			{
+				vector<string> result;
+				string path;
+
+				for (auto e = font_loader::create_fonts_enumerator(directories); e(path); )
+					result.push_back(path);
+				sort(result.begin(), result.end());
+				return result;
+			}
+		}
+
+		begin_test_suite( FontLoaderTests )
+			test( FontFilesAreEnumeratedInNestedDirectories )
+			{
+				// INIT
+				temporary_directory d;
+
+				d.make_directory("truetype");
+				d.make_directory("truetype/dejavu");
+				d.make_directory("opentype");
+				d.make_directory("opentype/noto");
+				d.make_directory("opentype/noto/cjk");
+
+				const string reference[] = {
+					d.make_file("opentype/noto/NotoSans-Bold.OTF"),
+					d.make_file("opentype/noto/cjk/NotoSansCJK-Regular.ttc"),
+					d.make_file("top.ttf"),
+					d.make_file("truetype/dejavu/DejaVuSans.ttf"),
+				};
+
+				// ACT / ASSERT
+				assert_equal(reference, enumerate(vector<string>(1, d.path())));
+			}
+
+
+			test( NonFontFilesAreSkipped )
+			{
+				// INIT
+				temporary_directory d;
+
+				d.make_directory("type1");
+				d.make_file("type1/a.pfb");
+				d.make_file("fonts.dir");
+				d.make_file("fonts.conf");
+				d.make_file("ttf");
+
+				const string reference[] = {	d.make_file("type1/b.ttf"),	};
+
+				// ACT / ASSERT
+				assert_equal(reference, enumerate(vector<string>(1, d.path())));
+			}
+
+
+			test( MissingDirectoriesAreSkipped )
+			{
+				// INIT
+				temporary_directory d;
+				vector<string> directories;
+
+				directories.push_back(d.path() + "/missing");
+				directories.push_back(d.make_directory("present"));
+				directories.push_back(d.make_file("present/not-a-directory.ttf"));
+
+				const string reference[] = {	d.make_file("present/a.otf"), d.path() + "/present/not-a-directory.ttf",	};
+
+				// ACT / ASSERT
+				assert_equal(reference, enumerate(directories));
+			}
+
+
+			test( DirectoriesReachableSeveralTimesAreEnumeratedOnce )
+			{
+				// INIT
+				temporary_directory d;
+				vector<string> directories;
+
+				d.make_directory("a");
+				d.make_directory("a/b");
+				d.make_file("a/b/font.ttf");
+				::symlink((d.path() + "/a").c_str(), (d.path() + "/a/b/loop").c_str());
+				::symlink((d.path() + "/a/b").c_str(), (d.path() + "/b-link").c_str());
+				directories.push_back(d.path());
+				directories.push_back(d.path() + "/a");
+
+				// ACT
+				const auto files = enumerate(directories);
+
+				// ASSERT
+				assert_equal(1u, files.size());
+				assert_equal("/font.ttf", files[0].substr(files[0].size() - 9));
+			}
+
+
+			test( FacesAreIndexedAndLoadedByFamily )
+			{
+				// INIT
+				temporary_directory d;
+
+				d.make_directory("fonts");
+				write_font(d.path() + "/fonts/a.ttf", "Alpha");
+				write_font(d.path() + "/fonts/b.ttf", "Gamma");
+
+				font_loader loader(string(), vector<string>(1, d.path() + "/fonts"));
+
+				// ACT / ASSERT
+				assert_equal("Alpha", loaded_family(loader, "alpha"));
+				assert_equal("Gamma", loaded_family(loader, "Gamma"));
+			}
+
+
+			test( IndexCacheIsReadBackForUnchangedFiles )
+			{
+				// INIT
+				temporary_directory d;
+				const auto fonts = d.make_directory("tab\tand\nnewline");
+				const auto cache = d.path() + "/index";
+
+				write_font(fonts + "/a.ttf", "Zulu");
+				write_font(fonts + "/b\n.ttf", "Second");
+				font_loader(cache, vector<string>(1, fonts)).load(agge::font_descriptor::create("", 10));
+
+				// ACT
+				rewrite_font(fonts + "/a.ttf", "Echo"); // The cache is trusted for the same stamp.
+				font_loader loader(cache, vector<string>(1, fonts));
+
+				// ASSERT
+				assert_equal("Echo", loaded_family(loader, "Zulu"));
+				assert_equal("Second", loaded_family(loader, "second"));
+			}
+
+
+			test( ChangedFilesAreReindexedDespiteTheCache )
+			{
+				// INIT
+				temporary_directory d;
+				const auto font = d.make_directory("fonts") + "/a.ttf";
+				const auto cache = d.path() + "/index";
+
+				write_font(font, "Cached");
+				font_loader(cache, vector<string>(1, d.path() + "/fonts")).load(agge::font_descriptor::create("", 10));
+				write_font(font, "Another family");
+
+				// ACT
+				font_loader loader(cache, vector<string>(1, d.path() + "/fonts"));
+
+				// ASSERT
+				assert_equal("<none>", loaded_family(loader, "Cached"));
+				assert_equal("Another family", loaded_family(loader, "Another family"));
+			}
+
+
+			test( TruncatedIndexCacheIsIgnored )
+			{
+				// INIT
+				temporary_directory d;
+				const auto font = d.make_directory("fonts") + "/a.ttf";
+				const auto cache = d.path() + "/index";
+
+				write_font(font, "Cached");
+				font_loader(cache, vector<string>(1, d.path() + "/fonts")).load(agge::font_descriptor::create("", 10));
+				rewrite_font(font, "Bright");
+				truncate_file(cache);
+
+				// ACT
+				font_loader loader(cache, vector<string>(1, d.path() + "/fonts"));
+
+				// ASSERT
+				assert_equal("<none>", loaded_family(loader, "Cached"));
+				assert_equal("Bright", loaded_family(loader, "Bright"));
+			}
+
+
+			test( MalformedIndexCacheIsIgnoredAndReplaced )
+			{
+				// INIT
+				temporary_directory d;
+				const auto font = d.make_directory("fonts") + "/a.ttf";
+				const auto cache = d.path() + "/index";
+
+				write_font(font, "Direct");
+				ofstream(cache.c_str()) << "wpl.font-index.2 1\n999999:" << font << " 1 1 1\n";
+
+				// ACT
+				font_loader(cache, vector<string>(1, d.path() + "/fonts")).load(agge::font_descriptor::create("", 10));
+				rewrite_font(font, "Cached");
+				font_loader loader(cache, vector<string>(1, d.path() + "/fonts"));
+
+				// ASSERT
+				assert_equal("Cached", loaded_family(loader, "Direct")); // The cache has been rewritten.
+				assert_equal(-1, ::access((cache + ".tmp").c_str(), F_OK));
+			}
+
+			test( LoadWaitsUntilTheFaceRequestedIsIndexed )
+			{
+				// INIT
+				temporary_directory d;
+				const auto g = make_shared<gate>();
+				vector<string> paths;
+
+				paths.push_back(d.path() + "/a.ttf");
+				paths.push_back(d.path() + "/b.ttf");
+				write_font(paths[0], "Alpha");
+				write_font(paths[1], "Gamma");
+
+				font_loader loader(string(), gated_enumerator(paths, 0, g));
+
+				// ACT
+				auto result = async(launch::async, [&] {	return loaded_family(loader, "Gamma");	});
+				gate_opener o(g);
+
+				// ASSERT
+				assert_is_true(is_blocked(result));
+
+				// ACT
+				g->open();
+
+				// ASSERT
+				assert_equal("Gamma", result.get());
+			}
+
+
+			test( CachedFacesAreLoadedWhileIndexingIsIncomplete )
+			{
+				// INIT
+				temporary_directory d;
+				const auto cache = d.path() + "/index";
+				const auto g = make_shared<gate>();
+				vector<string> paths;
+
+				paths.push_back(d.make_directory("fonts") + "/a.ttf");
+				paths.push_back(d.path() + "/fonts/b.ttf");
+				write_font(paths[0], "Alpha");
+				write_font(paths[1], "Gamma");
+				font_loader(cache, vector<string>(1, d.path() + "/fonts")).load(agge::font_descriptor::create("", 10));
+
+				font_loader loader(cache, gated_enumerator(paths, 1, g));
+
+				// ACT
+				auto result = async(launch::async, [&] {	return loaded_family(loader, "Alpha");	});
+				gate_opener o(g);
+
+				// ASSERT
+				assert_is_true(future_status::ready == result.wait_for(chrono::seconds(10)));
+				assert_equal("Alpha", result.get());
+			}
+
+
+			test( MissingFacesAreLookedUpInTheCompleteIndexOnly )
+			{
+				// INIT
+				temporary_directory d;
+				const auto g = make_shared<gate>();
+				vector<string> paths;
+
+				paths.push_back(d.path() + "/a.ttf");
+				paths.push_back(d.path() + "/b.ttf");
+				write_font(paths[0], "Alpha");
+				write_font(paths[1], "Gamma");
+
+				font_loader loader(string(), gated_enumerator(paths, 2, g));
+
+				// ACT
+				auto fallback = async(launch::async, [&] {	return loaded_family(loader, "Beta");	});
+				auto missing = async(launch::async, [&] {	return loaded_family(loader, "Zulu");	});
+				gate_opener o(g);
+
+				// ASSERT
+				assert_is_true(is_blocked(fallback));
+				assert_is_true(is_blocked(missing));
+
+				// ACT
+				g->open();
+
+				// ASSERT
+				assert_equal("Alpha", fallback.get());
+				assert_equal("<none>", missing.get());
+			}
+
+
+			test( FacesAreLoadedFromTheCompleteIndex )
+			{
+				// INIT
+				temporary_directory d;
+
+				write_font(d.path() + "/a.ttf", "Alpha");
+				write_font(d.path() + "/b.ttf", "Gamma");
+
+				font_loader loader(string(), vector<string>(1, d.path()));
+
+				assert_equal("<none>", loaded_family(loader, "Zulu")); // Waits for the complete index.
+
+				// ACT / ASSERT
+				assert_equal("Alpha", loaded_family(loader, "Alpha"));
+				assert_equal("Gamma", loaded_family(loader, "gamma"));
+				assert_equal("Alpha", loaded_family(loader, "Beta"));
+			}
+
+
+			test( NothingIsLoadedFromAnEmptyIndex )
+			{
+				// INIT
+				temporary_directory d;
+				font_loader loader(string(), vector<string>(1, d.path()));
+
+				// ACT / ASSERT
+				assert_equal("<none>", loaded_family(loader, "Alpha"));
+				assert_equal("<none>", loaded_family(loader, ""));
+			}
+
+
+			test( QuadraticCurvesAreFlattenedWithinTheTolerance )
+			{
+				// INIT
+				temporary_directory d;
+
+				write_quadratic_font(d.path() + "/q.ttf", "Quadratic");
+
+				font_loader loader(string(), vector<string>(1, d.path()));
+
+				// ACT
+				const auto outline = load_outline(loader, "Quadratic", 10);
+
+				// ASSERT
+				assert_equal(10u, outline->size()); // Move, ceil(sqrt(0.25 * 20 / 0.1)) segments and close.
+				assert_equal(8u, count_lines(*outline));
+				assert_is_true(max_deviation(*outline, [] (double t, double &x, double &y) {
+					x = 10.0 * t, y = -20.0 * t * (1.0 - t);
+				}) <= 0.1);
+				assert_approx_equal(10.0f, (*outline)[8].x, 0.001);
+				assert_approx_equal(0.0f, (*outline)[8].y, 0.001);
+			}
+
+
+			test( CubicCurvesAreFlattenedWithinTheToleranceAndEndAtTheirEndPoint )
+			{
+				// INIT
+				temporary_directory d;
+
+				write_cubic_font(d.path() + "/c.otf", "Cubic");
+
+				font_loader loader(string(), vector<string>(1, d.path()));
+
+				// ACT
+				const auto outline = load_outline(loader, "Cubic", 10);
+
+				// ASSERT
+				assert_equal(12u, outline->size()); // Move, ceil(sqrt(0.75 * |(10, 7)| / 0.1)) segments and close.
+				assert_equal(10u, count_lines(*outline));
+				assert_is_true(max_deviation(*outline, [] (double t, double &x, double &y) {
+					const auto t_ = 1.0 - t;
+
+					x = 3.0 * t_ * t * t * 10.0 + t * t * t * 10.0, y = -3.0 * t_ * t * (t_ + t) * 7.0;
+				}) <= 0.1);
+				assert_approx_equal(10.0f, (*outline)[10].x, 0.001);
+				assert_approx_equal(0.0f, (*outline)[10].y, 0.001);
+			}
+
+
+			test( CurvesAreFlattenedIntoAtMost64Segments )
+			{
+				// INIT
+				temporary_directory d;
+
+				write_quadratic_font(d.path() + "/q.ttf", "Quadratic");
+				write_cubic_font(d.path() + "/c.otf", "Cubic");
+
+				font_loader loader(string(), vector<string>(1, d.path()));
+
+				// ACT / ASSERT
+				assert_equal(64u, count_lines(*load_outline(loader, "Quadratic", 1000)));
+				assert_equal(64u, count_lines(*load_outline(loader, "Cubic", 1000)));
+				assert_equal(64u, count_lines(*load_outline(loader, "Cubic", 3000)));
+			}
+		end_test_suite
+	}
+}
@@ -42,6 +42,8 @@ namespace wpl
 
 	struct control
 	{
+		control();
+
 		virtual void layout(const placed_view_appender &append_view, const agge::box<int> &box) = 0;
 		virtual int min_height(int for_width = maximum_size) const;
 		virtual int min_width(int for_height = maximum_size) const;
@@ -51,6 +53,9 @@ namespace wpl
 
 
 
+	inline control::control()
+	{	layout_changed.profile("control.layout_changed");	}
+
 	inline int control::min_height(int /*for_width*/) const
 	{	return 0;	}
 
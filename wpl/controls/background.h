@@ -34,6 +34,8 @@ namespace wpl
 		class solid_background : public integrated_control<wpl::control>
 		{
 		public:
+			solid_background();
+
 			void apply_styles(const stylesheet &stylesheet_);
 
 		private:
@@ -0,0 +1,102 @@
+//	Copyright (c) 2011-2022 by Artem A. Gevorkyan (gevorkyan.org)
+//
+//	Permission is hereby granted, free of charge, to any person obtaining a copy
+//	of this software and associated documentation files (the "Software"), to deal
+//	in the Software without restriction, including without limitation the rights
+//	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//	copies of the Software, and to permit persons to whom the Software is
+//	furnished to do so, subject to the following conditions:
+//
+//	The above copyright notice and this permission notice shall be included in
+//	all copies or substantial portions of the Software.
+//
+//	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+//	THE SOFTWARE.
+
+
+#pragma once
+
+#include "../concepts.h"
+#include "../models.h"
+#include "../visual.h"
+
+#include <agge/color.h>
+#include <list>
+#include <unordered_map>
+#include <utility>
+
+namespace wpl
+{
+	namespace controls
+	{
+		// Keeps text of table cells laid out and rasterized relative to the integral part of the cell box origin, so
+		// an unchanged cell is drawn by appending its run to the target rasterizer. A run is valid for the box it was
+		// laid out for (width, height and the fractional part of its origin). The number of runs is limited by the
+		// capacity, least recently used runs are evicted first.
+		class cell_text_cache : noncopyable
+		{
+		public:
+			typedef table_model_base::index_type row_index_type;
+			typedef columns_model::index_type column_index_type;
+
+			struct run
+			{
+				gcontext::rasterizer_ptr raster;
+				agge::color foreground;
+				agge::rect_r box; // The box the run was laid out in, relative to the integral origin.
+			};
+
+		public:
+			explicit cell_text_cache(std::size_t capacity);
+
+			// Returns a run laid out for the box (in target coordinates) or nullptr, if the text must be laid out
+			// again.
+			const run *find(row_index_type row, column_index_type column, const agge::rect_r &box);
+
+			// Returns an empty run to lay the text out into. run::box receives the box to use.
+			run &acquire(row_index_type row, column_index_type column, const agge::rect_r &box);
+
+			void invalidate(row_index_type first, row_index_type count) throw();
+			void clear() throw();
+
+			// Evicts the least recently used runs exceeding the new capacity.
+			void set_capacity(std::size_t capacity) throw();
+
+			std::size_t size() const throw();
+
+			static agge::vector_i origin(const agge::rect_r &box) throw();
+
+		private:
+			typedef std::pair<row_index_type, column_index_type> key_type;
+
+			struct key_hash
+			{
+				std::size_t operator ()(const key_type &key) const throw();
+			};
+
+			struct entry
+			{
+				key_type key;
+				run value;
+			};
+
+			typedef std::list<entry> entries_t;
+			typedef std::unordered_map<key_type, entries_t::iterator, key_hash> index_t;
+
+		private:
+			entries_t _entries; // Most recently used go first.
+			index_t _index;
+			std::size_t _capacity;
+		};
+
+
+
+		inline std::size_t cell_text_cache::size() const throw()
+		{	return _entries.size();	}
+	}
+}
@@ -70,6 +70,8 @@ namespace wpl
 				const headers_model &model, index_type item, unsigned /*item_state_flags*/ state) const = 0;
 
 			std::pair<index_type, handle_type> handle_from_point(int x) const;
+			int measure_min_height() const;
+			void check_min_height();
 
 		private:
 			const std::shared_ptr<cursor_manager> _cursor_manager;
@@ -79,6 +81,8 @@ namespace wpl
 			std::pair<index_type, bool /*ascending*/> _sorted_column;
 			slot_connection _model_invalidation;
 			slot_connection _model_sorting_change;
+			slot_connection _layout_invalidation;
+			mutable int _min_height; // Negative unless measured since the last layout change.
 			bool _ignore_invalidations;
 		};
 	}
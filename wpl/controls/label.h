@@ -23,6 +23,8 @@
 #include "../controls.h"
 #include "integrated.h"
 
+#include "../min_size_cache.h"
+
 #include <agge/color.h>
 
 namespace wpl
@@ -57,6 +59,7 @@ namespace wpl
 			agge::richtext_modifier_t _text;
 			agge::color _color;
 			agge::text_alignment _halign, _valign;
+			min_size_cache _min_sizes;
 		};
 	}
 }
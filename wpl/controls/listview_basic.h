@@ -20,6 +20,7 @@
 
 #pragma once
 
+#include "cell_text_cache.h"
 #include "listview_core.h"
 
 #include <agge/color.h>
@@ -61,6 +62,8 @@ namespace wpl
 			mutable agge::stroke _stroke;
 			mutable agge::dash _dash;
 			mutable agge::richtext_t _text_buffer;
+			mutable cell_text_cache _text_cache;
+			slot_connection _text_invalidation, _text_range_invalidation, _columns_invalidation;
 		};
 	}
 }
@@ -23,6 +23,7 @@
 #include "../animated_models.h"
 #include "../controls.h"
 #include "../factory.h"
+#include "../frame_scheduler.h"
 #include "../helpers.h"
 
 namespace wpl
@@ -37,13 +38,15 @@ namespace wpl
 			{
 				using namespace std;
 
+				const auto animation_queue = context.frame_scheduler_ ? context.frame_scheduler_->get_queue() : context.queue_;
+
 				_header = factory_.create_control<HeaderControlT>(header_type);
 				_hscroller = factory_.create_control<scroller>("hscroller");
 				_hscroller->set_model(shared_ptr<animated_scroll_model>(new animated_scroll_model(this->get_hscroll_model(),
-					context.clock_, context.queue_, smooth_animation())));
+					context.clock_, animation_queue, smooth_animation())));
 				_vscroller = factory_.create_control<scroller>("vscroller");
 				_vscroller->set_model(shared_ptr<animated_scroll_model>(new animated_scroll_model(this->get_vscroll_model(),
-					context.clock_, context.queue_, smooth_animation())));
+					context.clock_, animation_queue, smooth_animation())));
 
 				_scroll_connection = this->get_hscroll_model()->invalidate += [this] (bool) {
 					_header->set_offset(this->get_hscroll_model()->get_window().first);
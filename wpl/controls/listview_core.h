@@ -85,6 +85,8 @@ namespace wpl
 				columns_model::index_type column) const = 0;
 
 			void invalidate_();
+			void invalidate_rows_(index_type first, index_type count);
+			void scroll_(const agge::agge_vector<double> &previous_offset);
 			void selection_clear();
 			void selection_add(index_type item);
 			void selection_remove(index_type item);
@@ -108,7 +110,7 @@ namespace wpl
 			table_model_base::index_type _item_count;
 			std::shared_ptr<vertical_scroll_model> _vsmodel;
 			std::shared_ptr<horizontal_scroll_model> _hsmodel;
-			slot_connection _model_invalidation, _cmodel_invalidation, _selection_invalidation;
+			slot_connection _model_invalidation, _model_range_invalidation, _cmodel_invalidation, _selection_invalidation;
 			agge::agge_vector<double> _offset;
 			mutable agge::real_t _total_width;
 			mutable std::vector< std::pair<agge::real_t /*x1*/, agge::real_t /*x2*/> > _subitem_positions;
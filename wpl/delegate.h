@@ -0,0 +1,421 @@
+//	Copyright (c) 2011-2022 by Artem A. Gevorkyan (gevorkyan.org)
+//
+//	Permission is hereby granted, free of charge, to any person obtaining a copy
+//	of this software and associated documentation files (the "Software"), to deal
+//	in the Software without restriction, including without limitation the rights
+//	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//	copies of the Software, and to permit persons to whom the Software is
+//	furnished to do so, subject to the following conditions:
+//
+//	The above copyright notice and this permission notice shall be included in
+//	all copies or substantial portions of the Software.
+//
+//	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+//	THE SOFTWARE.
+
+#pragma once
+
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace wpl
+{
+	template <typename F>
+	class delegate;
+
+	class delegate_base
+	{
+	public:
+		delegate_base() throw();
+		delegate_base(const delegate_base &other);
+		delegate_base(delegate_base &&other) throw();
+		~delegate_base();
+
+		const delegate_base &operator =(const delegate_base &rhs);
+
+		operator bool() const throw();
+
+	protected:
+		enum operation {	copy_, move_, destroy_	};
+
+		union storage
+		{
+			void *object;
+			double alignment_double;
+			long long alignment_long;
+			void (delegate_base::*alignment_member)();
+			char buffer[4 * sizeof(void *)];
+		};
+
+		typedef void (*manager_fn)(operation op, storage &to, storage &from);
+		typedef void (*invoker_fn)();
+
+		template <typename T>
+		struct local_manager;
+
+		template <typename T>
+		struct heap_manager;
+
+		template <typename T>
+		struct select_manager;
+
+	protected:
+		template <typename T>
+		delegate_base(const T &callable, invoker_fn invoke);
+
+		template <typename T>
+		static T &get(storage &s);
+
+	protected:
+		mutable storage _storage;
+		manager_fn _manager;
+		invoker_fn _invoke;
+
+	private:
+		void reset() throw();
+	};
+
+	template <typename T>
+	struct delegate_base::local_manager
+	{
+		static void construct(storage &s, const T &callable)
+		{	new (s.buffer) T(callable);	}
+
+		static T &get(storage &s)
+		{	return *static_cast<T *>(static_cast<void *>(s.buffer));	}
+
+		static void manage(operation op, storage &to, storage &from)
+		{
+			switch (op)
+			{
+			case copy_:	new (to.buffer) T(get(from));	break;
+			case move_:	new (to.buffer) T(std::move(get(from)));	break;
+			case destroy_:	get(from).~T();	break;
+			}
+		}
+	};
+
+	template <typename T>
+	struct delegate_base::heap_manager
+	{
+		static void construct(storage &s, const T &callable)
+		{	s.object = new T(callable);	}
+
+		static T &get(storage &s)
+		{	return *static_cast<T *>(s.object);	}
+
+		static void manage(operation op, storage &to, storage &from)
+		{
+			switch (op)
+			{
+			case copy_:	to.object = new T(get(from));	break;
+			case move_:	to.object = from.object, from.object = nullptr;	break;
+			case destroy_:	delete static_cast<T *>(from.object);	break;
+			}
+		}
+	};
+
+	template <typename T>
+	struct delegate_base::select_manager
+	{
+		enum {
+			local = sizeof(T) <= sizeof(storage)
+				&& std::alignment_of<storage>::value % std::alignment_of<T>::value == 0,
+		};
+
+		typedef typename std::conditional<local, local_manager<T>, heap_manager<T> >::type type;
+	};
+
+
+	template <>
+	class delegate<void ()> : public delegate_base
+	{
+	public:
+		delegate() throw();
+		template <typename T>
+		delegate(const T &callable);
+
+		void operator ()() const;
+
+	private:
+		typedef void (*invoker)(storage &s);
+
+	private:
+		template <typename T>
+		static void invoke(storage &s);
+	};
+
+	template <typename T1>
+	class delegate<void (T1)> : public delegate_base
+	{
+	public:
+		delegate() throw();
+		template <typename T>
+		delegate(const T &callable);
+
+		void operator ()(T1 arg1) const;
+
+	private:
+		typedef void (*invoker)(storage &s, T1 arg1);
+
+	private:
+		template <typename T>
+		static void invoke(storage &s, T1 arg1);
+	};
+
+	template <typename T1, typename T2>
+	class delegate<void (T1, T2)> : public delegate_base
+	{
+	public:
+		delegate() throw();
+		template <typename T>
+		delegate(const T &callable);
+
+		void operator ()(T1 arg1, T2 arg2) const;
+
+	private:
+		typedef void (*invoker)(storage &s, T1 arg1, T2 arg2);
+
+	private:
+		template <typename T>
+		static void invoke(storage &s, T1 arg1, T2 arg2);
+	};
+
+	template <typename T1, typename T2, typename T3>
+	class delegate<void (T1, T2, T3)> : public delegate_base
+	{
+	public:
+		delegate() throw();
+		template <typename T>
+		delegate(const T &callable);
+
+		void operator ()(T1 arg1, T2 arg2, T3 arg3) const;
+
+	private:
+		typedef void (*invoker)(storage &s, T1 arg1, T2 arg2, T3 arg3);
+
+	private:
+		template <typename T>
+		static void invoke(storage &s, T1 arg1, T2 arg2, T3 arg3);
+	};
+
+	template <typename T1, typename T2, typename T3, typename T4>
+	class delegate<void (T1, T2, T3, T4)> : public delegate_base
+	{
+	public:
+		delegate() throw();
+		template <typename T>
+		delegate(const T &callable);
+
+		void operator ()(T1 arg1, T2 arg2, T3 arg3, T4 arg4) const;
+
+	private:
+		typedef void (*invoker)(storage &s, T1 arg1, T2 arg2, T3 arg3, T4 arg4);
+
+	private:
+		template <typename T>
+		static void invoke(storage &s, T1 arg1, T2 arg2, T3 arg3, T4 arg4);
+	};
+
+	template <typename T1, typename T2, typename T3, typename T4, typename T5>
+	class delegate<void (T1, T2, T3, T4, T5)> : public delegate_base
+	{
+	public:
+		delegate() throw();
+		template <typename T>
+		delegate(const T &callable);
+
+		void operator ()(T1 arg1, T2 arg2, T3 arg3, T4 arg4, T5 arg5) const;
+
+	private:
+		typedef void (*invoker)(storage &s, T1 arg1, T2 arg2, T3 arg3, T4 arg4, T5 arg5);
+
+	private:
+		template <typename T>
+		static void invoke(storage &s, T1 arg1, T2 arg2, T3 arg3, T4 arg4, T5 arg5);
+	};
+
+
+
+	inline delegate_base::delegate_base() throw()
+		: _manager(nullptr), _invoke(nullptr)
+	{	}
+
+	inline delegate_base::delegate_base(const delegate_base &other)
+		: _manager(other._manager), _invoke(other._invoke)
+	{
+		if (_manager)
+			_manager(copy_, _storage, other._storage);
+	}
+
+	inline delegate_base::delegate_base(delegate_base &&other) throw()
+		: _manager(other._manager), _invoke(other._invoke)
+	{
+		if (_manager)
+			_manager(move_, _storage, other._storage);
+	}
+
+	template <typename T>
+	inline delegate_base::delegate_base(const T &callable, invoker_fn invoke)
+		: _manager(&select_manager<T>::type::manage), _invoke(invoke)
+	{	select_manager<T>::type::construct(_storage, callable);	}
+
+	inline delegate_base::~delegate_base()
+	{	reset();	}
+
+	inline const delegate_base &delegate_base::operator =(const delegate_base &rhs)
+	{
+		if (this != &rhs)
+		{
+			delegate_base copy(rhs);
+
+			reset();
+			if (copy._manager)
+				copy._manager(move_, _storage, copy._storage);
+			_manager = copy._manager, _invoke = copy._invoke;
+		}
+		return *this;
+	}
+
+	inline delegate_base::operator bool() const throw()
+	{	return !!_invoke;	}
+
+	template <typename T>
+	inline T &delegate_base::get(storage &s)
+	{	return select_manager<T>::type::get(s);	}
+
+	inline void delegate_base::reset() throw()
+	{
+		if (_manager)
+			_manager(destroy_, _storage, _storage);
+		_manager = nullptr, _invoke = nullptr;
+	}
+
+
+	inline delegate<void ()>::delegate() throw()
+	{	}
+
+	template <typename T>
+	inline delegate<void ()>::delegate(const T &callable)
+		: delegate_base(static_cast<const typename std::decay<T>::type &>(callable),
+			reinterpret_cast<invoker_fn>(static_cast<invoker>(&invoke<typename std::decay<T>::type>)))
+	{	}
+
+	inline void delegate<void ()>::operator ()() const
+	{	reinterpret_cast<invoker>(_invoke)(_storage);	}
+
+	template <typename T>
+	inline void delegate<void ()>::invoke(storage &s)
+	{	get<T>(s)();	}
+
+
+	template <typename T1>
+	inline delegate<void (T1)>::delegate() throw()
+	{	}
+
+	template <typename T1>
+	template <typename T>
+	inline delegate<void (T1)>::delegate(const T &callable)
+		: delegate_base(static_cast<const typename std::decay<T>::type &>(callable),
+			reinterpret_cast<invoker_fn>(static_cast<invoker>(&invoke<typename std::decay<T>::type>)))
+	{	}
+
+	template <typename T1>
+	inline void delegate<void (T1)>::operator ()(T1 arg1) const
+	{	reinterpret_cast<invoker>(_invoke)(_storage, arg1);	}
+
+	template <typename T1>
+	template <typename T>
+	inline void delegate<void (T1)>::invoke(storage &s, T1 arg1)
+	{	get<T>(s)(arg1);	}
+
+
+	template <typename T1, typename T2>
+	inline delegate<void (T1, T2)>::delegate() throw()
+	{	}
+
+	template <typename T1, typename T2>
+	template <typename T>
+	inline delegate<void (T1, T2)>::delegate(const T &callable)
+		: delegate_base(static_cast<const typename std::decay<T>::type &>(callable),
+			reinterpret_cast<invoker_fn>(static_cast<invoker>(&invoke<typename std::decay<T>::type>)))
+	{	}
+
+	template <typename T1, typename T2>
+	inline void delegate<void (T1, T2)>::operator ()(T1 arg1, T2 arg2) const
+	{	reinterpret_cast<invoker>(_invoke)(_storage, arg1, arg2);	}
+
+	template <typename T1, typename T2>
+	template <typename T>
+	inline void delegate<void (T1, T2)>::invoke(storage &s, T1 arg1, T2 arg2)
+	{	get<T>(s)(arg1, arg2);	}
+
+
+	template <typename T1, typename T2, typename T3>
+	inline delegate<void (T1, T2, T3)>::delegate() throw()
+	{	}
+
+	template <typename T1, typename T2, typename T3>
+	template <typename T>
+	inline delegate<void (T1, T2, T3)>::delegate(const T &callable)
+		: delegate_base(static_cast<const typename std::decay<T>::type &>(callable),
+			reinterpret_cast<invoker_fn>(static_cast<invoker>(&invoke<typename std::decay<T>::type>)))
+	{	}
+
+	template <typename T1, typename T2, typename T3>
+	inline void delegate<void (T1, T2, T3)>::operator ()(T1 arg1, T2 arg2, T3 arg3) const
+	{	reinterpret_cast<invoker>(_invoke)(_storage, arg1, arg2, arg3);	}
+
+	template <typename T1, typename T2, typename T3>
+	template <typename T>
+	inline void delegate<void (T1, T2, T3)>::invoke(storage &s, T1 arg1, T2 arg2, T3 arg3)
+	{	get<T>(s)(arg1, arg2, arg3);	}
+
+
+	template <typename T1, typename T2, typename T3, typename T4>
+	inline delegate<void (T1, T2, T3, T4)>::delegate() throw()
+	{	}
+
+	template <typename T1, typename T2, typename T3, typename T4>
+	template <typename T>
+	inline delegate<void (T1, T2, T3, T4)>::delegate(const T &callable)
+		: delegate_base(static_cast<const typename std::decay<T>::type &>(callable),
+			reinterpret_cast<invoker_fn>(static_cast<invoker>(&invoke<typename std::decay<T>::type>)))
+	{	}
+
+	template <typename T1, typename T2, typename T3, typename T4>
+	inline void delegate<void (T1, T2, T3, T4)>::operator ()(T1 arg1, T2 arg2, T3 arg3, T4 arg4) const
+	{	reinterpret_cast<invoker>(_invoke)(_storage, arg1, arg2, arg3, arg4);	}
+
+	template <typename T1, typename T2, typename T3, typename T4>
+	template <typename T>
+	inline void delegate<void (T1, T2, T3, T4)>::invoke(storage &s, T1 arg1, T2 arg2, T3 arg3, T4 arg4)
+	{	get<T>(s)(arg1, arg2, arg3, arg4);	}
+
+
+	template <typename T1, typename T2, typename T3, typename T4, typename T5>
+	inline delegate<void (T1, T2, T3, T4, T5)>::delegate() throw()
+	{	}
+
+	template <typename T1, typename T2, typename T3, typename T4, typename T5>
+	template <typename T>
+	inline delegate<void (T1, T2, T3, T4, T5)>::delegate(const T &callable)
+		: delegate_base(static_cast<const typename std::decay<T>::type &>(callable),
+			reinterpret_cast<invoker_fn>(static_cast<invoker>(&invoke<typename std::decay<T>::type>)))
+	{	}
+
+	template <typename T1, typename T2, typename T3, typename T4, typename T5>
+	inline void delegate<void (T1, T2, T3, T4, T5)>::operator ()(T1 arg1, T2 arg2, T3 arg3, T4 arg4, T5 arg5) const
+	{	reinterpret_cast<invoker>(_invoke)(_storage, arg1, arg2, arg3, arg4, arg5);	}
+
+	template <typename T1, typename T2, typename T3, typename T4, typename T5>
+	template <typename T>
+	inline void delegate<void (T1, T2, T3, T4, T5)>::invoke(storage &s, T1 arg1, T2 arg2, T3 arg3, T4 arg4, T5 arg5)
+	{	get<T>(s)(arg1, arg2, arg3, arg4, arg5);	}
+}
@@ -0,0 +1,77 @@
+//	Copyright (c) 2011-2022 by Artem A. Gevorkyan (gevorkyan.org)
+//
+//	Permission is hereby granted, free of charge, to any person obtaining a copy
+//	of this software and associated documentation files (the "Software"), to deal
+//	in the Software without restriction, including without limitation the rights
+//	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//	copies of the Software, and to permit persons to whom the Software is
+//	furnished to do so, subject to the following conditions:
+//
+//	The above copyright notice and this permission notice shall be included in
+//	all copies or substantial portions of the Software.
+//
+//	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+//	THE SOFTWARE.
+
+#pragma once
+
+#include "types.h"
+
+#include <utility>
+
+#include <vector>
+
+namespace wpl
+{
+	// Keeps invalid area as a bounded list of disjoint rectangles. Overlapping rectangles are always united, while
+	// disjoint ones are only united if it does not grow the area covered, or when the list would exceed the limit
+	// (in which case the pair wasting the least area is chosen).
+	class dirty_region
+	{
+	public:
+		typedef std::vector<rect_i>::const_iterator const_iterator;
+
+	public:
+		explicit dirty_region(std::size_t max_rectangles);
+
+		void add(rect_i area);
+		void clear() throw();
+		void swap(dirty_region &other) throw();
+
+		bool empty() const throw();
+		const_iterator begin() const throw();
+		const_iterator end() const throw();
+
+	private:
+		void merge_cheapest();
+
+	private:
+		std::vector<rect_i> _rectangles;
+		std::size_t _max_rectangles;
+	};
+
+
+
+	inline void dirty_region::clear() throw()
+	{	_rectangles.clear();	}
+
+	inline void dirty_region::swap(dirty_region &other) throw()
+	{
+		std::swap(_max_rectangles, other._max_rectangles);
+		_rectangles.swap(other._rectangles);
+	}
+
+	inline bool dirty_region::empty() const throw()
+	{	return _rectangles.empty();	}
+
+	inline dirty_region::const_iterator dirty_region::begin() const throw()
+	{	return _rectangles.begin();	}
+
+	inline dirty_region::const_iterator dirty_region::end() const throw()
+	{	return _rectangles.end();	}
+}
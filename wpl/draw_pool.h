@@ -0,0 +1,66 @@
+//	Copyright (c) 2011-2022 by Artem A. Gevorkyan (gevorkyan.org)
+//
+//	Permission is hereby granted, free of charge, to any person obtaining a copy
+//	of this software and associated documentation files (the "Software"), to deal
+//	in the Software without restriction, including without limitation the rights
+//	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//	copies of the Software, and to permit persons to whom the Software is
+//	furnished to do so, subject to the following conditions:
+//
+//	The above copyright notice and this permission notice shall be included in
+//	all copies or substantial portions of the Software.
+//
+//	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+//	THE SOFTWARE.
+
+#pragma once
+
+#include "concepts.h"
+
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace wpl
+{
+	// Runs indexed jobs on a fixed set of threads. The thread calling run() takes part in the work and returns when
+	// all the jobs are done. An exception thrown by a job is rethrown from run().
+	class draw_pool : noncopyable
+	{
+	public:
+		typedef std::function<void (unsigned index)> job_type;
+
+	public:
+		explicit draw_pool(unsigned concurrency); // The calling thread is included.
+		~draw_pool();
+
+		unsigned concurrency() const throw();
+		void run(unsigned count, const job_type &job);
+
+	private:
+		void worker();
+		bool take(std::unique_lock<std::mutex> &lock);
+
+	private:
+		std::mutex _mtx;
+		std::condition_variable _ready, _done;
+		const job_type *_job;
+		unsigned _next, _count, _pending;
+		std::exception_ptr _exception;
+		bool _stop;
+		std::vector<std::thread> _threads;
+	};
+
+
+
+	inline unsigned draw_pool::concurrency() const throw()
+	{	return static_cast<unsigned>(_threads.size()) + 1;	}
+}
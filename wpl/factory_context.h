@@ -25,6 +25,9 @@
 
 namespace wpl
 {
+	class draw_pool;
+	class frame_profiler;
+	class frame_scheduler;
 	struct cursor_manager;
 	struct stylesheet;
 
@@ -37,6 +40,9 @@ namespace wpl
 		std::shared_ptr<cursor_manager> cursor_manager_;
 		clock clock_;
 		queue queue_;
+		std::shared_ptr<draw_pool> draw_pool_; // Optional, enables tiled drawing.
+		std::shared_ptr<frame_scheduler> frame_scheduler_; // Optional, paces repaints and animations into frames.
+		std::shared_ptr<frame_profiler> frame_profiler_; // Optional, records statistics of each frame drawn.
 	};
 
 	typedef factory_context form_context;
@@ -48,5 +54,6 @@ namespace wpl
 		std::shared_ptr<cursor_manager> cursor_manager_;
 		clock clock_;
 		queue queue_;
+		std::shared_ptr<frame_scheduler> frame_scheduler_;
 	};
 }
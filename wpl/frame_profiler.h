@@ -0,0 +1,122 @@
+//	Copyright (c) 2011-2022 by Artem A. Gevorkyan (gevorkyan.org)
+//
+//	Permission is hereby granted, free of charge, to any person obtaining a copy
+//	of this software and associated documentation files (the "Software"), to deal
+//	in the Software without restriction, including without limitation the rights
+//	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//	copies of the Software, and to permit persons to whom the Software is
+//	furnished to do so, subject to the following conditions:
+//
+//	The above copyright notice and this permission notice shall be included in
+//	all copies or substantial portions of the Software.
+//
+//	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+//	THE SOFTWARE.
+
+
+#pragma once
+
+#include "concepts.h"
+#include "signal.h"
+#include "visual.h"
+
+#include <chrono>
+#include <deque>
+#include <mutex>
+#include <vector>
+
+namespace wpl
+{
+	struct view_timing
+	{
+		size_t index; // Index of the placed view in the router's views.
+		double draw_time; // In seconds.
+	};
+
+	struct frame_record
+	{
+		double draw_time, layout_time; // In seconds, layout time is accumulated since the previous frame.
+		unsigned invalidations, render_calls;
+		unsigned long long rasterized_area;
+		std::vector<view_timing> views; // In the order of drawing, once per view (summed over bands, if drawn in bands).
+	};
+
+	// Collects per-frame drawing statistics reported by routers and hosts, keeping a rolling history of the
+	// latest frames. Views may report from several threads, the rest is expected on the drawing thread.
+	class frame_profiler : noncopyable
+	{
+	public:
+		class stopwatch;
+
+	public:
+		explicit frame_profiler(size_t history = 240);
+
+		void begin_frame();
+		void view_drawn(size_t index, double draw_time);
+		void end_frame();
+		void layout_done(double layout_time);
+		void invalidated() throw();
+		render_counters &get_counters() throw();
+
+		const frame_record &last_frame() const throw();
+		const std::deque<frame_record> &get_history() const throw();
+		double percentile(double p) const; // Draw time percentile (p within [0; 1]) over the history.
+
+		// Counts draw times over the history, frames longer than the range fall into the last bucket.
+		std::vector<unsigned> histogram(double bucket_width, size_t buckets) const;
+
+		std::vector<view_timing> slowest_views(size_t count) const; // Worst draw times seen over the history.
+
+	public:
+		signal<void (const frame_record &frame)> frame_completed;
+
+	private:
+		typedef std::chrono::steady_clock clock_type;
+
+	private:
+		const size_t _history_size;
+		std::deque<frame_record> _history;
+		frame_record _current, _last;
+		render_counters _counters;
+		clock_type::time_point _frame_start;
+		std::mutex _mtx;
+	};
+
+	class frame_profiler::stopwatch
+	{
+	public:
+		stopwatch();
+
+		double operator ()() const; // Returns seconds since construction.
+
+	private:
+		clock_type::time_point _start;
+	};
+
+
+
+	inline void frame_profiler::invalidated() throw()
+	{	_current.invalidations++;	}
+
+	inline render_counters &frame_profiler::get_counters() throw()
+	{	return _counters;	}
+
+	inline const frame_record &frame_profiler::last_frame() const throw()
+	{	return _last;	}
+
+	inline const std::deque<frame_record> &frame_profiler::get_history() const throw()
+	{	return _history;	}
+
+
+	inline frame_profiler::stopwatch::stopwatch()
+		: _start(clock_type::now())
+	{	}
+
+	inline double frame_profiler::stopwatch::operator ()() const
+	{	return std::chrono::duration<double>(clock_type::now() - _start).count();	}
+}
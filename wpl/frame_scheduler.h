@@ -0,0 +1,86 @@
+//	Copyright (c) 2011-2022 by Artem A. Gevorkyan (gevorkyan.org)
+//
+//	Permission is hereby granted, free of charge, to any person obtaining a copy
+//	of this software and associated documentation files (the "Software"), to deal
+//	in the Software without restriction, including without limitation the rights
+//	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//	copies of the Software, and to permit persons to whom the Software is
+//	furnished to do so, subject to the following conditions:
+//
+//	The above copyright notice and this permission notice shall be included in
+//	all copies or substantial portions of the Software.
+//
+//	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+//	THE SOFTWARE.
+
+
+#pragma once
+
+#include "concepts.h"
+#include "queue.h"
+#include "signal.h"
+
+#include <deque>
+#include <map>
+#include <memory>
+
+namespace wpl
+{
+	// Paces repaints and animations into frames at a target rate. Frame requests and deferred tasks arriving between
+	// frames are coalesced: due tasks run first, then 'frame' is emitted once. Idle tasks run afterwards, only while
+	// the frame interval is not spent. The clock is expected to count milliseconds.
+	class frame_scheduler : noncopyable
+	{
+	public:
+		struct statistics
+		{
+			unsigned frames;
+			unsigned dropped_frames; // Frame intervals missed by frames started late.
+			timespan longest_frame;
+		};
+
+	public:
+		frame_scheduler(const clock &clock_, const queue &queue_, unsigned rate = 60);
+		~frame_scheduler();
+
+		void set_rate(unsigned rate);
+		void request_frame();
+		void defer(const queue_task &task, timespan defer_by);
+		void idle(const queue_task &task);
+
+		// Returns a queue running its tasks on frames, suitable for animations.
+		queue get_queue();
+
+		const statistics &get_statistics() const throw();
+		void reset_statistics() throw();
+
+	public:
+		signal<void ()> frame;
+
+	private:
+		void schedule();
+		void tick();
+
+	private:
+		const clock _clock;
+		const queue _queue;
+		const std::shared_ptr<bool> _alive;
+		timespan _interval;
+		timestamp _next_frame, _tick_at;
+		unsigned _generation;
+		bool _frame_requested, _tick_pending;
+		std::multimap<timestamp, queue_task> _deferred;
+		std::deque<queue_task> _idle;
+		statistics _statistics;
+	};
+
+
+
+	inline const frame_scheduler::statistics &frame_scheduler::get_statistics() const throw()
+	{	return _statistics;	}
+}
@@ -23,9 +23,17 @@
 #include "../visual.h"
 
 #include <agge.text/text_engine.h>
+#include <atomic>
+#include <condition_variable>
+#include <functional>
 #include <map>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
 
 typedef struct FT_FaceRec_ FT_FaceRec;
+typedef struct FT_SizeRec_ FT_SizeRec;
 typedef struct FT_LibraryRec_ FT_LibraryRec;
 typedef struct FT_LibraryRec_ *FT_Library;
 
@@ -36,33 +44,68 @@ namespace wpl
 	class font_loader : public gcontext::text_engine_type::loader, noncopyable
 	{
 	public:
-		font_loader();
+		typedef std::function<bool (std::string &path)> enum_font_files_cb;
+
+	public:
+		// The index is built in background: load() only waits until the face requested (or the complete index for
+		// a fallback) is available.
+		font_loader(); // Persists the font index in the per-user cache location.
+		explicit font_loader(const std::string &index_cache_path, // No index persistence for an empty path.
+			const std::vector<std::string> &font_directories = default_font_directories());
+		font_loader(const std::string &index_cache_path, const enum_font_files_cb &enumerate_font_files);
+		~font_loader();
 
 		virtual agge::font::accessor_ptr load(const agge::font_descriptor &descriptor) override;
 
+		// Listed in the increasing priority: faces found in later directories take over the same descriptors.
+		static std::vector<std::string> default_font_directories();
+
+		// Lists the font files found in the directories and all of their subdirectories.
+		static enum_font_files_cb create_fonts_enumerator(const std::vector<std::string> &font_directories);
+
 	private:
 		struct key_less
 		{
 			bool operator ()(const agge::font_descriptor &lhs, const agge::font_descriptor &rhs) const;
 		};
 
-		typedef std::function<bool (std::string &path)> enum_font_files_cb;
-		typedef std::map<agge::font_descriptor, std::pair<std::string, unsigned>, key_less> key_to_file_t;
+		typedef std::pair<std::string, unsigned> face_id_t;
+		typedef std::map<agge::font_descriptor, face_id_t, key_less> key_to_file_t;
+		typedef std::map< face_id_t, std::weak_ptr<FT_FaceRec> > faces_t;
 
 	private:
-		static enum_font_files_cb create_fonts_enumerator();
-		void build_index();
+		static std::string get_index_cache_path();
+		static std::shared_ptr<const void> map_file(const std::string &path, std::size_t &size);
+		void start_indexing(const std::string &index_cache_path, const enum_font_files_cb &enumerate_font_files);
+		void build_index(const std::string &index_cache_path, const enum_font_files_cb &enumerate_font_files);
+		void add_faces(const std::string &path, const std::vector< std::pair<agge::font_descriptor, unsigned> > &faces);
+		std::shared_ptr<FT_FaceRec> get_face(const face_id_t &id);
 
 	private:
 		std::shared_ptr<FT_LibraryRec_> _freetype;
+		std::shared_ptr<std::mutex> _freetype_lock; // Shared with the faces, which may outlive the loader.
 		key_to_file_t _mapping;
+		faces_t _faces; // Faces parsed from memory-mapped files, shared by the accessors of all sizes.
+		std::mutex _mtx;
+		std::condition_variable _index_updated;
+		bool _indexed;
+		std::atomic<bool> _cancel;
+		std::thread _indexer; // Must be the last: the indexer uses the members above.
 	};
 
+	// Safe for concurrent use: the face shared with the accessors of other sizes is only used under its lock.
 	class font_accessor : public agge::font::accessor
 	{
 	public:
-		font_accessor(FT_Library freetype_, const std::string &path, unsigned index, int height,
-			agge::font_hinting hinting);
+		font_accessor(std::shared_ptr<FT_FaceRec> face, int height, agge::font_hinting hinting);
+
+	private:
+		enum {	c_page_size = 256	};
+
+		struct page // Glyph indices for 256 consecutive characters, filled on the first use of any of them.
+		{
+			agge::glyph_index_t indices[c_page_size];
+		};
 
 	private:
 		virtual agge::font_descriptor get_descriptor() const override;
@@ -72,9 +115,15 @@ namespace wpl
 
 		agge::real_t scale_x(int value) const;
 		static agge::real_t scale_y(int value);
+		FT_FaceRec *face(std::unique_lock<std::mutex> &l) const; // Locks the shared face and activates this size on it.
+		int load_flags() const;
+		const page &get_page(std::unique_lock<std::mutex> &l, agge::codepoint_t character) const;
 
 	private:
 		std::shared_ptr<FT_FaceRec> _face;
+		std::shared_ptr<FT_SizeRec> _size;
+		agge::font_metrics _metrics;
+		mutable std::unordered_map< agge::codepoint_t, std::unique_ptr<page> > _pages; // Guarded by the face's lock.
 		agge::real_t _overscale;
 		int _height;
 		agge::font_hinting _hinting;
@@ -0,0 +1,73 @@
+//	Copyright (c) 2011-2022 by Artem A. Gevorkyan (gevorkyan.org)
+//
+//	Permission is hereby granted, free of charge, to any person obtaining a copy
+//	of this software and associated documentation files (the "Software"), to deal
+//	in the Software without restriction, including without limitation the rights
+//	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//	copies of the Software, and to permit persons to whom the Software is
+//	furnished to do so, subject to the following conditions:
+//
+//	The above copyright notice and this permission notice shall be included in
+//	all copies or substantial portions of the Software.
+//
+//	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+//	THE SOFTWARE.
+
+#pragma once
+
+#include "concepts.h"
+#include "visual.h"
+
+#include <list>
+#include <memory>
+
+namespace wpl
+{
+	// Keeps offscreen renderings of cached views keyed by the view. The total size of the layers held is limited by
+	// the budget (in bytes), least recently used layers are evicted first.
+	class layer_cache : noncopyable
+	{
+	public:
+		explicit layer_cache(std::size_t budget);
+
+		// Returns a valid layer of the size requested or nullptr, if the view has to be rendered again.
+		const gcontext::surface_type *find(const void *key, agge::count_t width, agge::count_t height);
+
+		// Returns a cleared layer of the size requested, that is considered valid from now on. Returns nullptr if
+		// a layer of this size does not fit the budget.
+		gcontext::surface_type *acquire(const void *key, agge::count_t width, agge::count_t height);
+
+		void invalidate(const void *key) throw();
+		void clear() throw();
+
+		std::size_t size() const throw();
+
+	private:
+		struct layer
+		{
+			const void *key;
+			std::unique_ptr<gcontext::surface_type> surface;
+			bool valid;
+		};
+
+		typedef std::list<layer> layers_t;
+
+	private:
+		layers_t::iterator find_layer(const void *key) throw();
+		void evict(layers_t::const_iterator keep) throw();
+
+	private:
+		layers_t _layers; // Most recently used go first.
+		std::size_t _budget, _size;
+	};
+
+
+
+	inline std::size_t layer_cache::size() const throw()
+	{	return _size;	}
+}
@@ -22,24 +22,80 @@
 
 #include "concepts.h"
 #include "control.h"
+#include "min_size_cache.h"
 #include "types.h"
 
+#include <unordered_map>
 #include <vector>
 
 namespace wpl
 {
 	struct cursor_manager;
+	class layout_cache;
 
+	// Places its children via layout_children(). When laid out by a layout_cache, a container that has not signalled a
+	// layout change since its last layout (neither itself, nor any of its descendants) and gets the same box keeps the
+	// views it has placed then.
 	class container : public control, noncopyable
 	{
 	public:
+		container();
+
 		virtual void remove(const control &child);
 
+		// control methods
+		virtual void layout(const placed_view_appender &append_view, const agge::box<int> &box) override;
+
 	protected:
 		void add(control &child);
 
+		virtual void layout_children(const placed_view_appender &append_view, const agge::box<int> &box) = 0;
+
 	private:
 		std::vector< std::pair<const control *, wpl::slot_connection> > _connections;
+		wpl::slot_connection _invalidate_connection;
+		unsigned _version;
+
+	private:
+		friend class layout_cache;
+	};
+
+
+	// Keeps the flat list of views placed by the last layout of a control tree along with the range of it placed by
+	// each container. On the next layout the ranges of unchanged containers are moved over (and shifted, if the
+	// container has moved), so only the containers on the path to a changed control lay out their children again.
+	class layout_cache : noncopyable
+	{
+	public:
+		layout_cache();
+
+		void layout(control &root, const agge::box<int> &box);
+		const std::vector<placed_view> &get_views() const throw();
+
+	private:
+		struct placement
+		{
+			const container *owner;
+			unsigned version;
+			agge::box<int> box;
+			int dx, dy, tab_override; // The transform applied to the views of the container on their way here.
+			std::size_t begin, end, descendants;
+		};
+
+	private:
+		void place(container &container_, const placed_view_appender &append_view, const agge::box<int> &box);
+		bool splice(const placement &placement_);
+		void append(const placed_view &pv);
+
+	private:
+		std::vector<placed_view> _views, _previous_views;
+		std::vector<placement> _placements, _previous_placements;
+		std::unordered_map<const container *, std::size_t> _previous_index;
+		placed_view *_probe;
+		static thread_local layout_cache *_active; // The cache being laid out on this thread (if any).
+
+	private:
+		friend class container;
 	};
 
 
@@ -52,7 +108,6 @@ namespace wpl
 		void add(std::shared_ptr<control> child, display_unit size, bool resizable = false, int tab_order = 0);
 
 		// control methods
-		virtual void layout(const placed_view_appender &append_view, const agge::box<int> &box) override;
 		virtual int min_height(int for_width = maximum_size) const override;
 		virtual int min_width(int for_height = maximum_size) const override;
 
@@ -70,6 +125,7 @@ namespace wpl
 		class splitter;
 
 	private:
+		virtual void layout_children(const placed_view_appender &append_view, const agge::box<int> &box) override;
 		agge::box<int> create_box(int item_size, const agge::box<int> &self) const;
 		double get_rsize() const;
 		void move_splitter(size_t index, double delta);
@@ -80,6 +136,7 @@ namespace wpl
 		std::vector<item> _children;
 		std::vector< std::shared_ptr<splitter> > _splitters;
 		const std::shared_ptr<cursor_manager> _cursor_manager;
+		min_size_cache _min_sizes;
 		int _spacing;
 		int _last_size;
 		bool _horizontal;
@@ -105,15 +162,20 @@ namespace wpl
 	class overlay : public container
 	{
 	public:
+		overlay();
+
 		void add(std::shared_ptr<control> child);
 
 		// control methods
-		virtual void layout(const placed_view_appender &append_view, const agge::box<int> &box) override;
 		virtual int min_height(int for_width) const override;
 		virtual int min_width(int for_height) const override;
 
+	private:
+		virtual void layout_children(const placed_view_appender &append_view, const agge::box<int> &box) override;
+
 	private:
 		std::vector< std::shared_ptr<control> > _children;
+		min_size_cache _min_sizes;
 	};
 
 
@@ -126,12 +188,12 @@ namespace wpl
 
 		void set_base_width(display_unit width);
 
-		// control methods
-		virtual void layout(const placed_view_appender &append_view, const agge::box<int> &box) override;
-
 		// container methods
 		virtual void remove(const control &child) override;
 
+	private:
+		virtual void layout_children(const placed_view_appender &append_view, const agge::box<int> &box) override;
+
 	private:
 		struct next
 		{
@@ -149,4 +211,7 @@ namespace wpl
 
 
 	std::shared_ptr<control> pad_control(std::shared_ptr<control> inner, int px, int py);
+
+	inline const std::vector<placed_view> &layout_cache::get_views() const throw()
+	{	return _views;	}
 }
@@ -63,6 +63,7 @@ namespace wpl
 			virtual void request_focus(std::shared_ptr<keyboard_input> input) override;
 			virtual std::shared_ptr<void> capture_mouse() override;
 			virtual void invalidate(const agge::rect_i &area) override;
+			virtual bool scroll(const agge::rect_i &area, int dx, int dy) override;
 
 		private:
 			NSView *_native_view;
@@ -0,0 +1,291 @@
+//	Copyright (c) 2011-2022 by Artem A. Gevorkyan (gevorkyan.org)
+//
+//	Permission is hereby granted, free of charge, to any person obtaining a copy
+//	of this software and associated documentation files (the "Software"), to deal
+//	in the Software without restriction, including without limitation the rights
+//	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//	copies of the Software, and to permit persons to whom the Software is
+//	furnished to do so, subject to the following conditions:
+//
+//	The above copyright notice and this permission notice shall be included in
+//	all copies or substantial portions of the Software.
+//
+//	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+//	THE SOFTWARE.
+
+#pragma once
+
+#include "concepts.h"
+#include "queue.h"
+#include "signal.h"
+
+#include <memory>
+#include <mutex>
+#include <set>
+#include <tuple>
+#include <type_traits>
+#include <vector>
+
+namespace wpl
+{
+	// Accumulates notifications posted from any thread and delivers them in a single batch on the thread serving the
+	// queue. A notification equal to an already pending one is dropped (arguments must be less-than comparable), an
+	// absorbing one (if set) replaces all pending and drops the ones posted until delivery. The queue must accept tasks
+	// from any thread, while the marshaller itself is to be created and destroyed on the queue's thread.
+	template <typename ArgsT>
+	class marshaller : noncopyable
+	{
+	public:
+		typedef void (*deliver_fn)(void *target, const ArgsT &args);
+
+	public:
+		marshaller(const queue &queue_, void *target, deliver_fn deliver);
+		marshaller(const queue &queue_, void *target, deliver_fn deliver, const ArgsT &absorbing);
+		~marshaller();
+
+		void post(const ArgsT &args);
+
+	private:
+		struct state;
+
+	private:
+		const std::shared_ptr<state> _state;
+	};
+
+	template <typename ArgsT>
+	struct marshaller<ArgsT>::state : noncopyable
+	{
+		state(const queue &queue_, void *target_, deliver_fn deliver_, const ArgsT *absorbing_);
+
+		void add(const ArgsT &args);
+		void flush();
+
+		const queue underlying;
+		const deliver_fn deliver;
+		const std::unique_ptr<const ArgsT> absorbing;
+		void *target; // Reset on marshaller destruction, is only accessed on the queue's thread.
+		std::mutex mtx;
+		std::vector<ArgsT> pending; // In the order of posting.
+		std::set<ArgsT> pending_set;
+		bool absorbed, scheduled;
+	};
+
+	template <typename F>
+	class marshalled_signal;
+
+	template <>
+	class marshalled_signal<void ()> : public signal<void ()>, noncopyable
+	{
+	public:
+		explicit marshalled_signal(const queue &queue_);
+
+		void post();
+
+	private:
+		typedef std::tuple<> args_t;
+
+	private:
+		static void deliver(void *target, const args_t &args);
+
+	private:
+		marshaller<args_t> _marshaller;
+	};
+
+	template <typename T1>
+	class marshalled_signal<void (T1)> : public signal<void (T1)>, noncopyable
+	{
+	public:
+		explicit marshalled_signal(const queue &queue_);
+		marshalled_signal(const queue &queue_, T1 absorbing); // E.g. npos() for a model's invalidate.
+
+		void post(T1 arg1);
+
+	private:
+		typedef std::tuple<typename std::decay<T1>::type> args_t;
+
+	private:
+		static void deliver(void *target, const args_t &args);
+
+	private:
+		marshaller<args_t> _marshaller;
+	};
+
+	template <typename T1, typename T2>
+	class marshalled_signal<void (T1, T2)> : public signal<void (T1, T2)>, noncopyable
+	{
+	public:
+		explicit marshalled_signal(const queue &queue_);
+
+		void post(T1 arg1, T2 arg2);
+
+	private:
+		typedef std::tuple<typename std::decay<T1>::type, typename std::decay<T2>::type> args_t;
+
+	private:
+		static void deliver(void *target, const args_t &args);
+
+	private:
+		marshaller<args_t> _marshaller;
+	};
+
+	template <typename T1, typename T2, typename T3>
+	class marshalled_signal<void (T1, T2, T3)> : public signal<void (T1, T2, T3)>, noncopyable
+	{
+	public:
+		explicit marshalled_signal(const queue &queue_);
+
+		void post(T1 arg1, T2 arg2, T3 arg3);
+
+	private:
+		typedef std::tuple<typename std::decay<T1>::type, typename std::decay<T2>::type,
+			typename std::decay<T3>::type> args_t;
+
+	private:
+		static void deliver(void *target, const args_t &args);
+
+	private:
+		marshaller<args_t> _marshaller;
+	};
+
+
+
+	template <typename ArgsT>
+	inline marshaller<ArgsT>::marshaller(const queue &queue_, void *target, deliver_fn deliver)
+		: _state(std::make_shared<state>(queue_, target, deliver, nullptr))
+	{	}
+
+	template <typename ArgsT>
+	inline marshaller<ArgsT>::marshaller(const queue &queue_, void *target, deliver_fn deliver, const ArgsT &absorbing)
+		: _state(std::make_shared<state>(queue_, target, deliver, &absorbing))
+	{	}
+
+	template <typename ArgsT>
+	inline marshaller<ArgsT>::~marshaller()
+	{	_state->target = nullptr;	}
+
+	template <typename ArgsT>
+	inline void marshaller<ArgsT>::post(const ArgsT &args)
+	{
+		const auto s = _state;
+
+		{
+			std::lock_guard<std::mutex> l(s->mtx);
+
+			s->add(args);
+			if (s->scheduled)
+				return;
+			s->scheduled = true;
+		}
+		if (!s->underlying([s] {	s->flush();	}, 0))
+		{
+			std::lock_guard<std::mutex> l(s->mtx);
+
+			s->scheduled = false;
+		}
+	}
+
+
+	template <typename ArgsT>
+	inline marshaller<ArgsT>::state::state(const queue &queue_, void *target_, deliver_fn deliver_,
+			const ArgsT *absorbing_)
+		: underlying(queue_), deliver(deliver_), absorbing(absorbing_ ? new ArgsT(*absorbing_) : nullptr),
+			target(target_), absorbed(false), scheduled(false)
+	{	}
+
+	template <typename ArgsT>
+	inline void marshaller<ArgsT>::state::add(const ArgsT &args)
+	{
+		if (absorbed)
+			return;
+		if (absorbing && args == *absorbing)
+		{
+			pending.clear();
+			pending_set.clear();
+			absorbed = true;
+			pending.push_back(args);
+		}
+		else if (pending_set.insert(args).second)
+		{
+			pending.push_back(args);
+		}
+	}
+
+	template <typename ArgsT>
+	inline void marshaller<ArgsT>::state::flush()
+	{
+		std::vector<ArgsT> batch;
+
+		{
+			std::lock_guard<std::mutex> l(mtx);
+
+			batch.swap(pending);
+			pending_set.clear();
+			absorbed = scheduled = false;
+		}
+		for (auto i = batch.begin(); target && i != batch.end(); ++i)
+			deliver(target, *i);
+	}
+
+
+	inline marshalled_signal<void ()>::marshalled_signal(const queue &queue_)
+		: _marshaller(queue_, this, &deliver)
+	{	}
+
+	inline void marshalled_signal<void ()>::post()
+	{	_marshaller.post(args_t());	}
+
+	inline void marshalled_signal<void ()>::deliver(void *target, const args_t &/*args*/)
+	{	(*static_cast<marshalled_signal *>(target))();	}
+
+
+	template <typename T1>
+	inline marshalled_signal<void (T1)>::marshalled_signal(const queue &queue_)
+		: _marshaller(queue_, this, &deliver)
+	{	}
+
+	template <typename T1>
+	inline marshalled_signal<void (T1)>::marshalled_signal(const queue &queue_, T1 absorbing)
+		: _marshaller(queue_, this, &deliver, args_t(absorbing))
+	{	}
+
+	template <typename T1>
+	inline void marshalled_signal<void (T1)>::post(T1 arg1)
+	{	_marshaller.post(args_t(arg1));	}
+
+	template <typename T1>
+	inline void marshalled_signal<void (T1)>::deliver(void *target, const args_t &args)
+	{	(*static_cast<marshalled_signal *>(target))(std::get<0>(args));	}
+
+
+	template <typename T1, typename T2>
+	inline marshalled_signal<void (T1, T2)>::marshalled_signal(const queue &queue_)
+		: _marshaller(queue_, this, &deliver)
+	{	}
+
+	template <typename T1, typename T2>
+	inline void marshalled_signal<void (T1, T2)>::post(T1 arg1, T2 arg2)
+	{	_marshaller.post(args_t(arg1, arg2));	}
+
+	template <typename T1, typename T2>
+	inline void marshalled_signal<void (T1, T2)>::deliver(void *target, const args_t &args)
+	{	(*static_cast<marshalled_signal *>(target))(std::get<0>(args), std::get<1>(args));	}
+
+
+	template <typename T1, typename T2, typename T3>
+	inline marshalled_signal<void (T1, T2, T3)>::marshalled_signal(const queue &queue_)
+		: _marshaller(queue_, this, &deliver)
+	{	}
+
+	template <typename T1, typename T2, typename T3>
+	inline void marshalled_signal<void (T1, T2, T3)>::post(T1 arg1, T2 arg2, T3 arg3)
+	{	_marshaller.post(args_t(arg1, arg2, arg3));	}
+
+	template <typename T1, typename T2, typename T3>
+	inline void marshalled_signal<void (T1, T2, T3)>::deliver(void *target, const args_t &args)
+	{	(*static_cast<marshalled_signal *>(target))(std::get<0>(args), std::get<1>(args), std::get<2>(args));	}
+}
@@ -0,0 +1,98 @@
+//	Copyright (c) 2011-2022 by Artem A. Gevorkyan (gevorkyan.org)
+//
+//	Permission is hereby granted, free of charge, to any person obtaining a copy
+//	of this software and associated documentation files (the "Software"), to deal
+//	in the Software without restriction, including without limitation the rights
+//	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//	copies of the Software, and to permit persons to whom the Software is
+//	furnished to do so, subject to the following conditions:
+//
+//	The above copyright notice and this permission notice shall be included in
+//	all copies or substantial portions of the Software.
+//
+//	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+//	THE SOFTWARE.
+
+#pragma once
+
+#include "concepts.h"
+#include "signal.h"
+
+#include <vector>
+
+namespace wpl
+{
+	// Memoizes min_height()/min_width() results of a control per constraint. All the results are dropped once the
+	// control signals a layout change. A few most recent constraints are kept per dimension.
+	class min_size_cache : noncopyable
+	{
+	public:
+		explicit min_size_cache(signal<void (bool hierarchy_changed)> &layout_changed, std::size_t capacity = 8);
+
+		template <typename MeasureT>
+		int height(int for_width, const MeasureT &measure) const;
+
+		template <typename MeasureT>
+		int width(int for_height, const MeasureT &measure) const;
+
+		void clear() throw();
+
+	private:
+		typedef std::vector< std::pair<int /*constraint*/, int /*size*/> > entries_t;
+
+	private:
+		template <typename MeasureT>
+		int get(entries_t &entries, int constraint, const MeasureT &measure) const;
+
+	private:
+		mutable entries_t _heights, _widths;
+		const std::size_t _capacity;
+		slot_connection _connection;
+	};
+
+
+
+	inline min_size_cache::min_size_cache(signal<void (bool hierarchy_changed)> &layout_changed, std::size_t capacity)
+		: _capacity(capacity)
+	{
+		_connection = layout_changed += [this] (bool /*hierarchy_changed*/) {
+			clear();
+		};
+	}
+
+	template <typename MeasureT>
+	inline int min_size_cache::height(int for_width, const MeasureT &measure) const
+	{	return get(_heights, for_width, measure);	}
+
+	template <typename MeasureT>
+	inline int min_size_cache::width(int for_height, const MeasureT &measure) const
+	{	return get(_widths, for_height, measure);	}
+
+	inline void min_size_cache::clear() throw()
+	{
+		_heights.clear();
+		_widths.clear();
+	}
+
+	template <typename MeasureT>
+	inline int min_size_cache::get(entries_t &entries, int constraint, const MeasureT &measure) const
+	{
+		for (auto i = entries.begin(); i != entries.end(); ++i)
+		{
+			if (i->first == constraint)
+				return i->second;
+		}
+
+		const auto size = measure();
+
+		if (entries.size() == _capacity)
+			entries.erase(entries.begin());
+		entries.push_back(std::make_pair(constraint, size));
+		return size;
+	}
+}
@@ -82,6 +82,8 @@ namespace wpl
 	{
 		typedef T value_type;
 
+		list_model();
+
 		virtual index_type get_count() const throw() = 0;
 		virtual void get_value(index_type index, value_type &value) const = 0;
 		virtual std::shared_ptr<const trackable> track(index_type item) const;
@@ -92,6 +94,8 @@ namespace wpl
 
 	struct columns_model : list_model<short int>
 	{
+		columns_model();
+
 		virtual void set_width(index_type index, short int width);
 		virtual agge::full_alignment get_alignment(index_type index) const;
 	};
@@ -117,11 +121,14 @@ namespace wpl
 
 	struct table_model_base : index_traits
 	{
+		table_model_base();
+
 		virtual index_type get_count() const throw() = 0;
 		virtual void precache(index_type from, index_type count);
 		virtual std::shared_ptr<const trackable> track(index_type row) const;
 
 		signal<void (index_type row)> invalidate; // It is model's responsibility to invalidate itself on count changes.
+		signal<void (index_type first, index_type count)> invalidate_range; // Rows content change only.
 	};
 
 
@@ -139,11 +146,18 @@ namespace wpl
 	{	return static_cast<index_type>(-1);	}
 
 
+	template <typename T>
+	inline list_model<T>::list_model()
+	{	invalidate.profile("list_model.invalidate");	}
+
 	template <typename T>
 	inline std::shared_ptr<const trackable> list_model<T>::track(index_type /*row*/) const
 	{	return std::shared_ptr<const trackable>();	}
 
 
+	inline columns_model::columns_model()
+	{	invalidate.profile("columns_model.invalidate");	}
+
 	inline void columns_model::set_width(index_type /*index*/, short int /*width*/)
 	{	}
 
@@ -162,6 +176,12 @@ namespace wpl
 	{	}
 
 
+	inline table_model_base::table_model_base()
+	{
+		invalidate.profile("table_model.invalidate");
+		invalidate_range.profile("table_model.invalidate_range");
+	}
+
 	inline void table_model_base::precache(index_type /*from*/, index_type /*count*/)
 	{	}
 
@@ -23,6 +23,7 @@
 #include "concepts.h"
 #include "control.h"
 #include "input.h"
+#include "view_index.h"
 
 #include <vector>
 
@@ -49,6 +50,7 @@ namespace wpl
 		mouse_router(const std::vector<placed_view> &views, mouse_router_host &host);
 
 		void reload_views();
+		void reindex_views(); // To be called when views were relocated without hierarchy change.
 		view_and_target from(agge::point<int> &point) const;
 
 		// mouse_input methods
@@ -75,5 +77,6 @@ namespace wpl
 		std::shared_ptr<view> _mouse_over;
 		std::weak_ptr<capture_target> _capture_target;
 		std::vector<slot_connection> _connections;
+		view_index _index;
 	};
 }
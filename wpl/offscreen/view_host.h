@@ -0,0 +1,110 @@
+//	Copyright (c) 2011-2022 by Artem A. Gevorkyan (gevorkyan.org)
+//
+//	Permission is hereby granted, free of charge, to any person obtaining a copy
+//	of this software and associated documentation files (the "Software"), to deal
+//	in the Software without restriction, including without limitation the rights
+//	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//	copies of the Software, and to permit persons to whom the Software is
+//	furnished to do so, subject to the following conditions:
+//
+//	The above copyright notice and this permission notice shall be included in
+//	all copies or substantial portions of the Software.
+//
+//	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+//	THE SOFTWARE.
+
+#pragma once
+
+#include "../concepts.h"
+#include "../factory_context.h"
+#include "../input.h"
+#include "../keyboard_router.h"
+#include "../layout.h"
+#include "../mouse_router.h"
+#include "../view_host.h"
+#include "../visual_router.h"
+
+namespace wpl
+{
+	namespace offscreen
+	{
+		// Hosts views with no native window: lays them out into its own surface, draws them there and accepts
+		// synthetic input. Native views are laid out, but neither drawn nor given input.
+		class view_host : public wpl::view_host, mouse_router_host, keyboard_router_host, visual_router_host,
+			noncopyable
+		{
+		public:
+			view_host(const form_context &context_, int width, int height);
+			~view_host();
+
+			// view_host methods
+			virtual void set_root(std::shared_ptr<control> root) override;
+
+			void resize(int width, int height);
+
+			// Draws the areas invalidated since the last call. Returns false if there were none. Is called on each frame
+			// if the context has a frame scheduler.
+			bool render();
+
+			const gcontext::surface_type &get_surface() const throw();
+			const std::vector<placed_view> &get_views() const throw();
+
+			// Synthetic input, coordinates are relative to the surface.
+			void mouse_move(int depressed, int x, int y);
+			void mouse_down(mouse_input::mouse_buttons button_, int depressed, int x, int y);
+			void mouse_up(mouse_input::mouse_buttons button_, int depressed, int x, int y);
+			void mouse_double_click(mouse_input::mouse_buttons button_, int depressed, int x, int y);
+			void mouse_scroll(int depressed, int x, int y, int delta_x, int delta_y);
+			void mouse_leave();
+			void key_down(unsigned code, int modifiers);
+			void character(wchar_t symbol, unsigned repeats, int modifiers);
+			void key_up(unsigned code, int modifiers);
+			void got_focus();
+			void lost_focus();
+
+		public:
+			const form_context context;
+
+		private:
+			// mouse_router_host methods
+			virtual void request_focus(std::shared_ptr<keyboard_input> input) override;
+			virtual std::shared_ptr<void> capture_mouse() override;
+
+			// keyboard_router_host methods
+			virtual void set_focus() override;
+			virtual void set_focus(native_view &nview) override;
+
+			// visual_router_host methods
+			virtual void invalidate(const agge::rect_i &area) override;
+			virtual bool scroll(const agge::rect_i &area, int dx, int dy) override;
+
+			void layout_views();
+
+		private:
+			gcontext::surface_type _surface;
+			gcontext::rasterizer_ptr _rasterizer;
+			std::shared_ptr<control> _root;
+			layout_cache _layout;
+			std::vector<placed_view> _views, _overlay_views;
+			slot_connection _layout_changed_connection, _frame_connection;
+			visual_router _visual_router, _visual_router_overlay;
+			mouse_router _mouse_router;
+			keyboard_router _keyboard_router;
+			agge::rect_i _invalid;
+			bool _focused;
+		};
+
+
+
+		inline const gcontext::surface_type &view_host::get_surface() const throw()
+		{	return _surface;	}
+
+		inline const std::vector<placed_view> &view_host::get_views() const throw()
+		{	return _views;	}
+	}
+}
@@ -0,0 +1,68 @@
+//	Copyright (c) 2011-2022 by Artem A. Gevorkyan (gevorkyan.org)
+//
+//	Permission is hereby granted, free of charge, to any person obtaining a copy
+//	of this software and associated documentation files (the "Software"), to deal
+//	in the Software without restriction, including without limitation the rights
+//	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//	copies of the Software, and to permit persons to whom the Software is
+//	furnished to do so, subject to the following conditions:
+//
+//	The above copyright notice and this permission notice shall be included in
+//	all copies or substantial portions of the Software.
+//
+//	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+//	THE SOFTWARE.
+
+
+#pragma once
+
+#include "concepts.h"
+#include "visual.h"
+
+#include <atomic>
+#include <mutex>
+#include <vector>
+
+namespace wpl
+{
+	// Lends rasterizers for building geometry independently (e.g. ahead of time or on other threads). Returned
+	// rasterizers are reset and kept for reuse. Cell storage is not observable, so the bounding area of a path (in
+	// pixels) stands for its size: the rasterizers released with a large path are freed on trim(), as are all idle
+	// ones after a large path was rendered (see rendered()) and the ones above the idle limit. This way a one-off giant
+	// path does not pin its cells for the rest of the session. All methods are thread-safe.
+	class rasterizer_pool : noncopyable
+	{
+	public:
+		explicit rasterizer_pool(unsigned long long large_area = 4096 * 4096, std::size_t max_idle = 8);
+
+		gcontext::rasterizer_ptr acquire();
+		void release(gcontext::rasterizer_ptr &rasterizer);
+		void rendered(unsigned long long area) throw();
+		void trim();
+		void trim(gcontext::rasterizer_ptr &in_use); // Also replaces the caller's own rasterizer by the same policy.
+
+		std::size_t idle() const;
+
+	private:
+		struct entry
+		{
+			gcontext::rasterizer_ptr rasterizer;
+			bool large;
+		};
+
+	private:
+		bool trim_idle();
+
+	private:
+		const unsigned long long _large_area;
+		const std::size_t _max_idle;
+		std::atomic<bool> _large_rendered;
+		mutable std::mutex _mtx;
+		std::vector<entry> _idle;
+	};
+}
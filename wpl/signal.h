@@ -21,10 +21,16 @@
 #pragma once
 
 #include "concepts.h"
+#include "delegate.h"
 
 #include <functional>
-#include <list>
 #include <memory>
+#include <new>
+#include <vector>
+
+#if defined(WPL_PROFILE_SIGNALS)
+#include "signal_profiler.h"
+#endif
 
 namespace wpl
 {
@@ -40,13 +46,18 @@ namespace wpl
 		signal &operator =(const signal &rhs);
 		slot_connection operator +=(const F &slot);
 
+		void profile(const char *name); // Does nothing unless WPL_PROFILE_SIGNALS is defined.
+
 	protected:
 		template <typename InvokerT>
 		void for_each_invoke(const InvokerT &invoker) const;
 
 	private:
 		struct cleanup_lock;
-		struct function_list;
+		struct disconnector;
+		class function_list;
+		template <typename T>
+		class connection_allocator;
 		typedef F function_t;
 
 	private:
@@ -63,13 +74,90 @@ namespace wpl
 	};
 
 	template <typename F>
-	struct signal<F>::function_list
+	struct signal<F>::disconnector
+	{
+		void operator ()(void *) const;
+
+		function_list *list;
+		size_t handle;
+	};
+
+	// Slots are kept in a contiguous array in connection order. A disconnected slot is replaced by an empty one (or
+	// reset, if the list is being traversed) and the holes are compacted away lazily. The storage is never relocated
+	// during traversal - when it has to grow, the old array is retired until the last traversal completes.
+	template <typename F>
+	class signal<F>::function_list : noncopyable
 	{
+	public:
 		function_list();
+		~function_list();
 
-		std::list<F> functions;
+		size_t size() const throw();
+		F &operator [](size_t index) throw();
+
+		size_t connect(const F &slot);
+		void disconnect(size_t handle) throw();
+		void cleanup() throw();
+
+		void *allocate_connection(size_t size);
+		void deallocate_connection(void *p, size_t size) throw();
+
+	public:
 		unsigned traversing;
 		bool require_cleanup;
+#if defined(WPL_PROFILE_SIGNALS)
+		std::shared_ptr<signal_statistics> statistics;
+#endif
+
+	private:
+		typedef std::pair<F *, size_t> retired_slots;
+
+	private:
+		void grow();
+		void compact() throw();
+		static void destroy(F *slots, size_t count) throw();
+
+	private:
+		F *_slots;
+		size_t _size, _capacity, _disconnected;
+		std::vector<size_t> _owners; // Handle owning the slot at the same position, npos for a disconnected one.
+		std::vector<size_t> _positions; // Slot position for a handle.
+		std::vector<size_t> _free_handles;
+		std::vector<retired_slots> _retired;
+		std::vector<void *> _free_connections;
+		size_t _connection_size;
+	};
+
+	// Recycles connection control blocks within a signal, so that connect/disconnect does not hit the heap in a
+	// steady state.
+	template <typename F>
+	template <typename T>
+	class signal<F>::connection_allocator
+	{
+	public:
+		typedef T value_type;
+
+		template <typename U>
+		struct rebind
+		{
+			typedef connection_allocator<U> other;
+		};
+
+	public:
+		connection_allocator(const std::shared_ptr<function_list> &list_) throw();
+		template <typename U>
+		connection_allocator(const connection_allocator<U> &other) throw();
+
+		T *allocate(size_t n);
+		void deallocate(T *p, size_t n) throw();
+
+		template <typename U>
+		bool operator ==(const connection_allocator<U> &rhs) const throw();
+		template <typename U>
+		bool operator !=(const connection_allocator<U> &rhs) const throw();
+
+	public:
+		std::shared_ptr<function_list> list;
 	};
 
 
@@ -91,27 +179,43 @@ namespace wpl
 	template <typename F>
 	inline slot_connection signal<F>::operator +=(const F &slot)
 	{
-		const auto l = _function_list;
-		const auto i = l->functions.insert(l->functions.end(), slot);
+		const auto &l = _function_list;
+		const disconnector d = {	l.get(), l->connect(slot)	};
 
-		return slot_connection(&*i, [l, i] (void *) {
-			if (l->traversing)
-				*i = F(), l->require_cleanup = true;
-			else
-				l->functions.erase(i);
-		});
+		return slot_connection(l.get(), d, connection_allocator<void>(l));
 	}
 
+#if defined(WPL_PROFILE_SIGNALS)
+	template <typename F>
+	inline void signal<F>::profile(const char *name)
+	{	_function_list->statistics = register_signal_statistics(name);	}
+#else
+	template <typename F>
+	inline void signal<F>::profile(const char * /*name*/)
+	{	}
+#endif
+
 	template <typename F>
 	template <typename InvokerT>
 	inline void signal<F>::for_each_invoke(const InvokerT &invoker) const
 	{
 		cleanup_lock l(_function_list);
+		auto &list = *l.list;
+#if defined(WPL_PROFILE_SIGNALS)
+		signal_emission_scope scope(list.statistics.get(), list.traversing > 1);
+#endif
 
-		for (auto i = l.list->functions.begin(); i != l.list->functions.end(); ++i)
+		for (size_t i = 0; i != list.size(); ++i)
 		{
-			if (*i)
-				invoker(*i);
+			auto &f = list[i];
+
+			if (f)
+			{
+#if defined(WPL_PROFILE_SIGNALS)
+				scope.slot_called();
+#endif
+				invoker(f);
+			}
 		}
 	}
 
@@ -125,59 +229,275 @@ namespace wpl
 	inline signal<F>::cleanup_lock::~cleanup_lock()
 	{
 		if (!--list->traversing && list->require_cleanup)
+			list->cleanup();
+	}
+
+
+	template <typename F>
+	inline void signal<F>::disconnector::operator ()(void *) const
+	{	list->disconnect(handle);	}
+
+
+	template <typename F>
+	inline signal<F>::function_list::function_list()
+		: traversing(0), require_cleanup(false), _slots(nullptr), _size(0), _capacity(0), _disconnected(0),
+			_connection_size(0)
+	{	}
+
+	template <typename F>
+	inline signal<F>::function_list::~function_list()
+	{
+		cleanup();
+		destroy(_slots, _size);
+		::operator delete(_slots);
+		for (auto i = _free_connections.begin(); i != _free_connections.end(); ++i)
+			::operator delete(*i);
+	}
+
+	template <typename F>
+	inline size_t signal<F>::function_list::size() const throw()
+	{	return _size;	}
+
+	template <typename F>
+	inline F &signal<F>::function_list::operator [](size_t index) throw()
+	{	return _slots[index];	}
+
+	template <typename F>
+	inline size_t signal<F>::function_list::connect(const F &slot)
+	{
+		if (_size == _capacity)
+			grow();
+		new (_slots + _size) F(slot);
+
+		size_t handle = _positions.size();
+
+		if (!_free_handles.empty())
+			handle = _free_handles.back(), _free_handles.pop_back(), _positions[handle] = _size;
+		else
+			_positions.push_back(_size);
+		_owners.push_back(handle);
+		_size++;
+		return handle;
+	}
+
+	template <typename F>
+	inline void signal<F>::function_list::disconnect(size_t handle) throw()
+	{
+		const auto position = _positions[handle];
+
+		_free_handles.push_back(handle);
+		_owners[position] = static_cast<size_t>(-1);
+		_disconnected++;
+		if (traversing)
+		{
+			_slots[position] = F();
+			require_cleanup = true;
+		}
+		else if (position + 1 == _size)
 		{
-			list->functions.remove_if([] (const function_t &f) {	return !f;	});
-			list->require_cleanup = false;
+			_slots[position].~F();
+			_owners.pop_back();
+			_size--, _disconnected--;
+		}
+		else
+		{
+			_slots[position].~F();
+			new (_slots + position) F();
+			if (2 * _disconnected > _size)
+				compact();
+			else
+				require_cleanup = true;
 		}
 	}
 
+	template <typename F>
+	inline void signal<F>::function_list::cleanup() throw()
+	{
+		for (auto i = _retired.begin(); i != _retired.end(); ++i)
+		{
+			destroy(i->first, i->second);
+			::operator delete(i->first);
+		}
+		_retired.clear();
+		compact();
+	}
 
 	template <typename F>
-	inline signal<F>::function_list::function_list()
-		: traversing(false), require_cleanup(false)
+	inline void *signal<F>::function_list::allocate_connection(size_t size)
+	{
+		if (!_connection_size)
+			_connection_size = size;
+		if (size == _connection_size && !_free_connections.empty())
+		{
+			const auto p = _free_connections.back();
+
+			_free_connections.pop_back();
+			return p;
+		}
+		return ::operator new(size);
+	}
+
+	template <typename F>
+	inline void signal<F>::function_list::deallocate_connection(void *p, size_t size) throw()
+	{
+		if (size == _connection_size && _free_connections.size() < _free_connections.capacity())
+			_free_connections.push_back(p);
+		else
+			::operator delete(p);
+	}
+
+	template <typename F>
+	inline void signal<F>::function_list::grow()
+	{
+		const auto capacity = _capacity ? 2 * _capacity : 4;
+		const auto slots = static_cast<F *>(::operator new(capacity * sizeof(F)));
+		size_t i = 0;
+
+		try
+		{
+			// Everything a disconnect or a cleanup may need is reserved here, so that these never throw.
+			_owners.reserve(capacity);
+			_positions.reserve(capacity);
+			_free_handles.reserve(capacity);
+			_free_connections.reserve(capacity);
+			if (traversing)
+			{
+				// Slots being invoked must stay where they are - copy them and retire the old storage.
+				_retired.reserve(_retired.size() + 1);
+				for (; i != _size; ++i)
+					new (slots + i) F(_slots[i]);
+				_retired.push_back(std::make_pair(_slots, _size));
+				require_cleanup = true;
+			}
+			else
+			{
+				for (; i != _size; ++i)
+					new (slots + i) F(std::move(_slots[i]));
+				destroy(_slots, _size);
+				::operator delete(_slots);
+			}
+		}
+		catch (...)
+		{
+			destroy(slots, i);
+			::operator delete(slots);
+			throw;
+		}
+		_slots = slots;
+		_capacity = capacity;
+	}
+
+	template <typename F>
+	inline void signal<F>::function_list::compact() throw()
+	{
+		size_t w = 0;
+
+		for (size_t r = 0; r != _size; ++r)
+		{
+			if (static_cast<size_t>(-1) == _owners[r])
+			{
+				_slots[r].~F();
+			}
+			else
+			{
+				if (w != r)
+				{
+					new (_slots + w) F(std::move(_slots[r]));
+					_slots[r].~F();
+					_positions[_owners[w] = _owners[r]] = w;
+				}
+				w++;
+			}
+		}
+		_owners.resize(_size = w);
+		_disconnected = 0;
+		require_cleanup = false;
+	}
+
+	template <typename F>
+	inline void signal<F>::function_list::destroy(F *slots, size_t count) throw()
+	{
+		for (size_t i = 0; i != count; ++i)
+			slots[i].~F();
+	}
+
+
+	template <typename F>
+	template <typename T>
+	inline signal<F>::connection_allocator<T>::connection_allocator(const std::shared_ptr<function_list> &list_) throw()
+		: list(list_)
 	{	}
 
+	template <typename F>
+	template <typename T>
+	template <typename U>
+	inline signal<F>::connection_allocator<T>::connection_allocator(const connection_allocator<U> &other) throw()
+		: list(other.list)
+	{	}
+
+	template <typename F>
+	template <typename T>
+	inline T *signal<F>::connection_allocator<T>::allocate(size_t n)
+	{	return static_cast<T *>(list->allocate_connection(n * sizeof(T)));	}
+
+	template <typename F>
+	template <typename T>
+	inline void signal<F>::connection_allocator<T>::deallocate(T *p, size_t n) throw()
+	{	list->deallocate_connection(p, n * sizeof(T));	}
+
+	template <typename F>
+	template <typename T>
+	template <typename U>
+	inline bool signal<F>::connection_allocator<T>::operator ==(const connection_allocator<U> &rhs) const throw()
+	{	return list == rhs.list;	}
+
+	template <typename F>
+	template <typename T>
+	template <typename U>
+	inline bool signal<F>::connection_allocator<T>::operator !=(const connection_allocator<U> &rhs) const throw()
+	{	return list != rhs.list;	}
+
 
 
 	template <>
-	struct signal<void ()> : signal< std::function<void ()> >
+	struct signal<void ()> : signal< delegate<void ()> >
 	{
 		void operator ()() const
-		{	this->for_each_invoke([] (const std::function<void ()> &f) {	f();	});	}
+		{	this->for_each_invoke([] (const delegate<void ()> &f) {	f();	});	}
 	};
 
 	template <typename T1>
-	struct signal<void (T1)> : signal< std::function<void (T1)> >
+	struct signal<void (T1)> : signal< delegate<void (T1)> >
 	{
 		void operator ()(T1 arg1) const
-		{	this->for_each_invoke([&] (const std::function<void (T1)> &f) {	f(arg1);	});	}
+		{	this->for_each_invoke([&] (const delegate<void (T1)> &f) {	f(arg1);	});	}
 	};
 
 	template <typename T1, typename T2>
-	struct signal<void (T1, T2)> : signal< std::function<void (T1, T2)> >
+	struct signal<void (T1, T2)> : signal< delegate<void (T1, T2)> >
 	{
 		void operator ()(T1 arg1, T2 arg2) const
-		{	this->for_each_invoke([&] (const std::function<void (T1, T2)> &f) {	f(arg1, arg2);	});	}
+		{	this->for_each_invoke([&] (const delegate<void (T1, T2)> &f) {	f(arg1, arg2);	});	}
 	};
 
 	template <typename T1, typename T2, typename T3>
-	struct signal<void (T1, T2, T3)> : signal< std::function<void (T1, T2, T3)> >
+	struct signal<void (T1, T2, T3)> : signal< delegate<void (T1, T2, T3)> >
 	{
 		void operator ()(T1 arg1, T2 arg2, T3 arg3) const
-		{	this->for_each_invoke([&] (const std::function<void (T1, T2, T3)> &f) {	f(arg1, arg2, arg3);	});	}
+		{	this->for_each_invoke([&] (const delegate<void (T1, T2, T3)> &f) {	f(arg1, arg2, arg3);	});	}
 	};
 
 	template <typename T1, typename T2, typename T3, typename T4>
-	struct signal<void (T1, T2, T3, T4)> : signal< std::function<void (T1, T2, T3, T4)> >
+	struct signal<void (T1, T2, T3, T4)> : signal< delegate<void (T1, T2, T3, T4)> >
 	{
 		void operator ()(T1 arg1, T2 arg2, T3 arg3, T4 arg4) const
-		{	this->for_each_invoke([&] (const std::function<void (T1, T2, T3, T4)> &f) {	f(arg1, arg2, arg3, arg4);	});	}
+		{	this->for_each_invoke([&] (const delegate<void (T1, T2, T3, T4)> &f) {	f(arg1, arg2, arg3, arg4);	});	}
 	};
 
 	template <typename T1, typename T2, typename T3, typename T4, typename T5>
-	struct signal<void (T1, T2, T3, T4, T5)> : signal< std::function<void (T1, T2, T3, T4, T5)> >
+	struct signal<void (T1, T2, T3, T4, T5)> : signal< delegate<void (T1, T2, T3, T4, T5)> >
 	{
 		void operator ()(T1 arg1, T2 arg2, T3 arg3, T4 arg4, T5 arg5) const
-		{	this->for_each_invoke([&] (const std::function<void (T1, T2, T3, T4, T5)> &f) {	f(arg1, arg2, arg3, arg4, arg5);	});	}
+		{	this->for_each_invoke([&] (const delegate<void (T1, T2, T3, T4, T5)> &f) {	f(arg1, arg2, arg3, arg4, arg5);	});	}
 	};
 }
@@ -0,0 +1,66 @@
+//	Copyright (c) 2011-2022 by Artem A. Gevorkyan (gevorkyan.org)
+//
+//	Permission is hereby granted, free of charge, to any person obtaining a copy
+//	of this software and associated documentation files (the "Software"), to deal
+//	in the Software without restriction, including without limitation the rights
+//	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//	copies of the Software, and to permit persons to whom the Software is
+//	furnished to do so, subject to the following conditions:
+//
+//	The above copyright notice and this permission notice shall be included in
+//	all copies or substantial portions of the Software.
+//
+//	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+//	THE SOFTWARE.
+
+#pragma once
+
+#include "concepts.h"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace wpl
+{
+	struct signal_statistics
+	{
+		std::string name;
+		unsigned long long emissions, reentrant_emissions, slot_calls;
+		double total_time, max_time; // In seconds, measured per emission with nested emissions included.
+	};
+
+	// Statistics are shared by all the signals profiled under the same name. They are collected without
+	// synchronization, so the functions below are expected to be called on the thread emitting the signals.
+	std::shared_ptr<signal_statistics> register_signal_statistics(const char *name);
+	std::vector<signal_statistics> query_signal_statistics(); // Ordered by total time, descending.
+	std::string dump_signal_statistics();
+	void reset_signal_statistics();
+
+	// Accounts a single emission. Signals only make use of it when built with WPL_PROFILE_SIGNALS defined.
+	class signal_emission_scope : noncopyable
+	{
+	public:
+		signal_emission_scope(signal_statistics *statistics, bool reentrant);
+		~signal_emission_scope();
+
+		void slot_called() throw();
+
+	private:
+		signal_statistics *_statistics;
+		long long _start;
+	};
+
+
+
+	inline void signal_emission_scope::slot_called() throw()
+	{
+		if (_statistics)
+			_statistics->slot_calls++;
+	}
+}
@@ -0,0 +1,58 @@
+//	Copyright (c) 2011-2022 by Artem A. Gevorkyan (gevorkyan.org)
+//
+//	Permission is hereby granted, free of charge, to any person obtaining a copy
+//	of this software and associated documentation files (the "Software"), to deal
+//	in the Software without restriction, including without limitation the rights
+//	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//	copies of the Software, and to permit persons to whom the Software is
+//	furnished to do so, subject to the following conditions:
+//
+//	The above copyright notice and this permission notice shall be included in
+//	all copies or substantial portions of the Software.
+//
+//	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+//	THE SOFTWARE.
+
+#pragma once
+
+#include "concepts.h"
+#include "control.h"
+
+#include <vector>
+
+namespace wpl
+{
+	// A uniform grid over locations of placed views. Each cell lists the views overlapping it in placement (z-)order,
+	// so hit testing looks through a single cell only. The index refers to views by their position in the vector it
+	// was built for and must be rebuilt whenever the views are relocated.
+	class view_index : noncopyable
+	{
+	public:
+		view_index();
+
+		void rebuild(const std::vector<placed_view> &views);
+		bool is_current(const std::vector<placed_view> &views) const throw();
+
+		// Returns the topmost view containing the point, or nullptr if there is none.
+		const placed_view *hit_test(const std::vector<placed_view> &views, agge::point<int> point) const;
+
+		// Appends positions of the views which may intersect the area. The result may contain duplicates and views
+		// only sharing a cell with the area.
+		void query(std::vector<std::size_t> &positions, const rect_i &area) const;
+
+	private:
+		bool get_cell_range(rect_i &range, const rect_i &area) const;
+
+	private:
+		std::size_t _views_count;
+		rect_i _bounds;
+		int _cell_width, _cell_height, _columns, _rows;
+		std::vector<unsigned> _cell_starts;
+		std::vector<unsigned> _items;
+	};
+}
@@ -25,9 +25,12 @@
 
 #include <agge/bitmap.h>
 #include <agge/clipper.h>
+#include <agge/filling_rules.h>
 #include <agge/platform/bitmap.h>
 #include <agge/rasterizer.h>
 #include <agge/renderer_parallel.h>
+#include <atomic>
+#include <mutex>
 
 namespace agge
 {
@@ -49,6 +52,8 @@ namespace wpl
 
 	struct cursor_manager;
 	class native_view;
+	class rasterizer_pool;
+	struct render_counters;
 
 	class gcontext
 	{
@@ -68,23 +73,59 @@ namespace wpl
 
 		gcontext translate(int offset_x, int offset_y) const throw();
 		gcontext window(int x1, int y1, int x2, int y2) const throw();
+		gcontext offscreen(surface_type &surface) const throw(); // Same renderer and text engine, another target.
+		gcontext with_renderer(renderer_type &renderer) const throw(); // Same target, another renderer.
+		gcontext with_counters(render_counters *counters) const throw(); // Accounts render calls, if not null.
+		gcontext with_rasterizers(rasterizer_pool *rasterizers) const throw(); // Lends rasterizers, if not null.
+		gcontext with_text_lock(std::mutex *lock) const throw(); // Serializes the text engine use, if not null.
+
+		// The text engine is not thread-safe: concurrently drawn views use it only while holding this lock (it
+		// locks nothing on a context not drawn concurrently).
+		std::unique_lock<std::mutex> lock_text_engine() const;
+
+		// Borrows a rasterizer for an independent path (a new one if no pool is attached) and gives it back.
+		rasterizer_ptr acquire_rasterizer() const;
+		void release_rasterizer(rasterizer_ptr &rasterizer) const;
+
+		// Copies pixels of the source (placed at x, y in context coordinates) clipped by the update area.
+		void blit(const surface_type &source, int x, int y);
 
 		agge::rect_i update_area() const throw();
 
 		template <typename BlenderT, typename AlphaFn>
 		void operator ()(rasterizer_ptr &rasterizer, const BlenderT &blender, const AlphaFn &alpha);
 
+		// Fills an axis-aligned rectangle: whole pixels are blended as spans directly onto the surface, only the
+		// fractional edges (if any) go through the rasterizer.
+		template <typename BlenderT>
+		void fill(rasterizer_ptr &rasterizer, const agge::rect_r &area, const BlenderT &blender);
+
 	public:
 		text_engine_type &text_engine;
 
 	private:
 		const gcontext &operator =(const gcontext &rhs);
 
+		gcontext derive(surface_type &surface, renderer_type &renderer, const agge::vector_i &offset,
+			const agge::rect_i &window_) const throw();
+		void account(const rasterizer_type &rasterizer) const throw();
+		bool split_fill(rasterizer_type &rasterizer, const agge::rect_r &area, agge::rect_i &interior) const;
+
 	private:
 		surface_type &_surface;
 		renderer_type &_renderer;
 		const agge::vector_i _offset;
 		const agge::rect_i _window;
+		render_counters *_counters;
+		rasterizer_pool *_rasterizers;
+		std::mutex *_text_lock;
+	};
+
+
+	struct render_counters
+	{
+		std::atomic<unsigned> calls;
+		std::atomic<unsigned long long> area; // Sum of rasterized bounding boxes, in pixels.
 	};
 
 
@@ -95,8 +136,11 @@ namespace wpl
 		virtual void draw(gcontext &ctx, gcontext::rasterizer_ptr &rasterizer) const;
 
 		bool transcending;
+		bool cached; // Opaque view repainted into a retained layer only after it invalidates itself.
+		bool concurrent_draw; // draw() may run on several threads at once for disjoint windows (see lock_text_engine()).
 
 		signal<void (const agge::rect_i *window)> invalidate;
+		signal<void (int dx, int dy)> scroll; // Rendered content moved as a whole, exposed areas need redrawing.
 	};
 
 
@@ -105,7 +149,22 @@ namespace wpl
 	inline void gcontext::operator ()(rasterizer_ptr &rasterizer, const BlenderT &blender, const AlphaFn &alpha)
 	{
 		rasterizer->sort();
+		if (_counters || _rasterizers)
+			account(*rasterizer);
 		_renderer(_surface, _offset, &_window, *rasterizer, blender, alpha);
 		rasterizer->reset();
 	}
+
+	template <typename BlenderT>
+	inline void gcontext::fill(rasterizer_ptr &rasterizer, const agge::rect_r &area, const BlenderT &blender)
+	{
+		agge::rect_i interior;
+		const auto edges = split_fill(*rasterizer, area, interior);
+		const auto n = static_cast<agge::count_t>(interior.x2 - interior.x1);
+
+		for (auto y = interior.y1; y < interior.y2; ++y)
+			blender(_surface.row_ptr(y) + interior.x1, interior.x1, y, n);
+		if (edges)
+			(*this)(rasterizer, blender, agge::winding<>());
+	}
 }
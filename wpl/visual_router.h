@@ -22,6 +22,12 @@
 
 #include "concepts.h"
 #include "control.h"
+#include "dirty_region.h"
+#include "draw_pool.h"
+#include "frame_profiler.h"
+#include "layer_cache.h"
+#include "rasterizer_pool.h"
+#include "view_index.h"
 #include "visual.h"
 
 #include <vector>
@@ -31,6 +37,9 @@ namespace wpl
 	struct visual_router_host
 	{
 		virtual void invalidate(const agge::rect_i &area) = 0;
+
+		// Moves presented pixels within the area. Returns false if the host cannot do that.
+		virtual bool scroll(const agge::rect_i &area, int dx, int dy) = 0;
 	};
 
 	class visual_router : noncopyable
@@ -39,13 +48,59 @@ namespace wpl
 		visual_router(const std::vector<placed_view> &views, visual_router_host &host);
 
 		void reload_views();
+		void reindex_views(); // To be called when views were relocated without hierarchy change.
+
+		// Adds an area invalidated by the host itself (exposure, resize, etc.) to the dirty region.
+		void invalidate(const agge::rect_i &area);
+
+		// Enables drawing of the update area in horizontal bands on the pool's threads. Bands crossed by a view not
+		// declaring concurrent_draw are drawn sequentially on the calling thread, after the concurrent ones.
+		void set_draw_pool(std::shared_ptr<draw_pool> pool);
+
+		// Makes each draw() a profiled frame: view draw times, render calls and view invalidations are recorded.
+		void set_profiler(std::shared_ptr<frame_profiler> profiler);
+
+		// Views may borrow extra rasterizers via gcontext::acquire_rasterizer() while drawing. Idle ones are trimmed
+		// at the end of each draw(), the rasterizer passed to it is replaced, if a large path was rendered.
+		const rasterizer_pool &get_rasterizers() const;
+
+		// Offscreen renderings of the views declaring visual::cached.
+		const layer_cache &get_layers() const;
 
 		// visual methods
-		void draw(gcontext &ctx, gcontext::rasterizer_ptr &rasterizer) const;
+		void draw(gcontext &ctx, gcontext::rasterizer_ptr &rasterizer);
+
+	private:
+		void scroll_view(std::size_t index, int dx, int dy);
+		bool can_scroll(std::size_t index, int dx, int dy) const;
+		void draw_dirty(gcontext &ctx, gcontext::rasterizer_ptr &rasterizer);
+		void draw_views(gcontext &ctx, gcontext::rasterizer_ptr &rasterizer);
+		bool draw_tiled(gcontext &ctx, gcontext::rasterizer_ptr &rasterizer);
+
+	private:
+		struct band
+		{
+			gcontext::rasterizer_ptr rasterizer;
+			std::unique_ptr<gcontext::renderer_type> renderer;
+			agge::rect_i area;
+			std::vector<double> draw_times; // Per tiled view, when profiling.
+			bool concurrent;
+		};
 
 	private:
 		const std::vector<placed_view> &_views;
 		visual_router_host &_host;
 		std::vector<slot_connection> _connections;
+		dirty_region _dirty, _drawn;
+		view_index _index;
+		layer_cache _layers;
+		std::vector<std::size_t> _transcending, _candidates;
+		std::shared_ptr<draw_pool> _pool;
+		std::shared_ptr<frame_profiler> _profiler;
+		rasterizer_pool _rasterizers;
+		std::vector<band> _bands;
+		std::vector< std::pair<std::size_t, const gcontext::surface_type *> > _tiled;
+		std::vector<double> _tiled_times;
+		std::mutex _text_lock; // Shared by the bands drawn concurrently.
 	};
 }
@@ -35,6 +35,7 @@ namespace wpl
 				std::shared_ptr<cursor_manager> cursor_manager_);
 
 			using wpl::mouse_router::reload_views;
+			using wpl::mouse_router::reindex_views;
 			bool handle_message(LRESULT &result, HWND hwnd, UINT message, WPARAM wparam, LPARAM lparam);
 
 		private:
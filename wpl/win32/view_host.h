@@ -22,6 +22,7 @@
 
 #include "../concepts.h"
 #include "../factory_context.h"
+#include "../layout.h"
 #include "../view_host.h"
 
 #include "helpers.h"
@@ -30,6 +31,8 @@
 #include "visual_router.h"
 #include "window.h"
 
+#include <unordered_map>
+
 namespace wpl
 {
 	namespace win32
@@ -71,7 +74,9 @@ namespace wpl
 
 			window::user_handler_t _user_handler;
 			std::shared_ptr<control> _root;
+			layout_cache _layout;
 			std::vector<placed_view> _views, _overlay_views;
+			std::unordered_map<const native_view *, rect_i> _native_locations; // As of the previous layout.
 			slot_connection _layout_changed_connection;
 			std::weak_ptr<bool> _capture_handle;
 			visual_router _visual_router, _visual_router_overlay;
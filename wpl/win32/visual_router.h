@@ -37,16 +37,19 @@ namespace wpl
 		class visual_router : visual_router_host
 		{
 		public:
-			visual_router(HWND hwnd, const std::vector<placed_view> &views, const form_context &context);
+			// Only a profiled router reports to the context's frame profiler (and shows statistics, if enabled).
+			visual_router(HWND hwnd, const std::vector<placed_view> &views, const form_context &context, bool profiled);
 			~visual_router();
 
 			void reload_views();
+			void reindex_views();
 			void set_offset(const agge::agge_vector<int> &offset);
 			bool handle_message(LRESULT &result, HWND hwnd, UINT message, WPARAM wparam, LPARAM lparam);
 
 		private:
 			// visual_router_host methods
 			virtual void invalidate(const agge::rect_i &area) override;
+			virtual bool scroll(const agge::rect_i &area, int dx, int dy) override;
 
 		private:
 			HWND _hwnd;
@@ -54,6 +57,8 @@ namespace wpl
 			const form_context _context;
 			gcontext::rasterizer_ptr _rasterizer;
 			agge::agge_vector<int> _offset;
+			dirty_region _pending; // Invalidations awaiting the next frame, when frames are scheduled.
+			slot_connection _frame_connection, _profiler_connection;
 			std::unique_ptr<misc::statistics_view> _statistics_view;
 			bool _measure_draw;
 		};